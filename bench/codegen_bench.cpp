@@ -0,0 +1,99 @@
+// Backend scaling benchmark: optimisation, code generation and linking with an increasing --codegen-threads.
+// Build with `make codegen_bench` and run `./codegen_bench [functions] [max threads]` from the repository root.
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/emitter.hpp"
+#include "../src/handler.hpp"
+#include "../src/lexer.hpp"
+#include "../src/module_graph.hpp"
+#include "../src/parser.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// Functions too big to be inlined into main, each with enough loops and arithmetic for the optimiser and instruction
+// selection to have work to do, so the work spreads evenly over the partitions
+auto write_program(std::filesystem::path const& path, size_t num_functions) -> void {
+    auto file = std::ofstream{path};
+    file << "extern printf(i8*, ...) i32;\n\n";
+    for (auto i = 0u; i < num_functions; ++i) {
+        file << "fn work_" << i << "(n: i64) i64 {\n"
+             << "    let mut total: i64 = 0;\n"
+             << "    let mut j: i64 = 0;\n";
+        for (auto k = 0u; k < 6; ++k) {
+            file << "    j = 0;\n"
+                 << "    while j < n {\n"
+                 << "        if j % " << ((i + k) % 7 + 2) << " == " << k % 2 << " { total = total + j * " << i + k
+                 << "; }\n"
+                 << "        else { total = total - j / " << ((i * k) % 5 + 1) << "; }\n"
+                 << "        j = j + 1;\n"
+                 << "    }\n";
+        }
+        file << "    return total;\n"
+             << "}\n\n";
+    }
+    file << "fn main() void {\n    let mut sum: i64 = 0;\n";
+    for (auto i = 0u; i < num_functions; ++i) {
+        file << "    sum = sum + work_" << i << "(" << i % 100 << ");\n";
+    }
+    file << "    printf(\"%ld\\n\", sum);\n}\n";
+}
+
+// Seconds spent in the back end, everything up to a verified module is left out
+auto time_backend(std::string const& source, std::string const& output, unsigned threads) -> double {
+    auto handler = std::make_shared<Handler>();
+    auto const args = std::vector<std::string>{
+        "codegen_bench", "-q", "-O2", "--codegen-threads=" + std::to_string(threads), "-o", output, source};
+    if (!handler->parse_cl_args(static_cast<int>(args.size()), args)) {
+        exit(EXIT_FAILURE);
+    }
+    handler->add_file(handler->source_filename);
+
+    auto lexer = Lexer(handler->source_filename, handler);
+    auto parser = Parser(lexer, handler->source_filename, handler);
+    auto module = parser.parse();
+
+    auto modules = std::make_shared<AllModules>();
+    modules->add_main_module(module);
+    auto graph = ModuleGraph(handler, modules);
+    graph.load();
+    graph.verify();
+    if (handler->num_errors_) {
+        std::cerr << "Generated program failed to verify\n";
+        exit(EXIT_FAILURE);
+    }
+
+    auto emitter = std::make_shared<Emitter>(modules, module, handler);
+    auto const start = Clock::now();
+    emitter->emit();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+auto main(int argc, char** argv) -> int {
+    auto const num_functions = argc > 1 ? std::stoul(argv[1]) : 500ul;
+    auto const max_threads = argc > 2 ? std::stoul(argv[2]) : 8ul;
+
+    auto const source = std::filesystem::temp_directory_path() / "xpp_codegen_bench.xpp";
+    auto const output = std::filesystem::temp_directory_path() / "xpp_codegen_bench.out";
+    write_program(source, num_functions);
+
+    std::cout << "Back end at -O2 over " << num_functions << " functions:\n";
+    auto const baseline = time_backend(source.string(), output.string(), 1);
+    std::cout << "    1 thread: " << baseline * 1000 << " ms\n";
+    for (auto threads = 2u; threads <= max_threads; threads *= 2) {
+        auto const seconds = time_backend(source.string(), output.string(), threads);
+        std::cout << "    " << threads << " threads: " << seconds * 1000 << " ms (speedup " << baseline / seconds
+                  << "x)\n";
+    }
+
+    std::filesystem::remove(source);
+    std::filesystem::remove(output);
+    return EXIT_SUCCESS;
+}
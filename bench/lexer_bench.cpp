@@ -0,0 +1,116 @@
+// Lexer microbenchmark: keyword recognition and full tokenisation throughput.
+// Build with `make lexer_bench` and run `./lexer_bench [identifiers]`.
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/handler.hpp"
+#include "../src/lexer.hpp"
+#include "../src/token.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// The lookup get_type_from_lexeme used to do, rebuilding the table on every call
+auto map_type_from_lexeme(std::string_view str) -> std::optional<TokenType> {
+    auto const lookup_map = std::map<std::string_view, TokenType>{{"fn", TokenType::FN},
+                                                                  {"using", TokenType::USING},
+                                                                  {"as", TokenType::AS},
+                                                                  {"i64", TokenType::TYPE},
+                                                                  {"i32", TokenType::TYPE},
+                                                                  {"i8", TokenType::TYPE},
+                                                                  {"u64", TokenType::TYPE},
+                                                                  {"u32", TokenType::TYPE},
+                                                                  {"u8", TokenType::TYPE},
+                                                                  {"f64", TokenType::TYPE},
+                                                                  {"f32", TokenType::TYPE},
+                                                                  {"if", TokenType::IF},
+                                                                  {"else", TokenType::ELSE},
+                                                                  {"else if", TokenType::ELSE_IF},
+                                                                  {"bool", TokenType::TYPE},
+                                                                  {"void", TokenType::TYPE},
+                                                                  {"mut", TokenType::MUT},
+                                                                  {"let", TokenType::LET},
+                                                                  {"return", TokenType::RETURN},
+                                                                  {"extern", TokenType::EXTERN},
+                                                                  {"while", TokenType::WHILE},
+                                                                  {"true", TokenType::TRUE},
+                                                                  {"false", TokenType::FALSE},
+                                                                  {"enum", TokenType::ENUM},
+                                                                  {"pub", TokenType::PUB},
+                                                                  {"class", TokenType::CLASS},
+                                                                  {"size_of", TokenType::SIZE_OF},
+                                                                  {"and", TokenType::LOGICAL_AND},
+                                                                  {"or", TokenType::LOGICAL_OR},
+                                                                  {"loop", TokenType::LOOP},
+                                                                  {"in", TokenType::IN},
+                                                                  {"break", TokenType::BREAK},
+                                                                  {"continue", TokenType::CONTINUE},
+                                                                  {"import", TokenType::IMPORT},
+                                                                  {"destructor", TokenType::DESTRUCTOR},
+                                                                  {"delete", TokenType::DELETE},
+                                                                  {"null", TokenType::NULL_},
+                                                                  {"new", TokenType::NEW}};
+
+    auto const it = lookup_map.find(str);
+    return it != lookup_map.end() ? std::make_optional(it->second) : std::nullopt;
+}
+
+// Roughly what a real source file looks like: mostly identifiers, a keyword every few words
+auto make_words(size_t count) -> std::vector<std::string> {
+    auto const keywords = std::vector<std::string>{"fn", "let", "mut", "return", "if", "while", "i64", "class"};
+    auto words = std::vector<std::string>{};
+    words.reserve(count);
+    for (auto i = 0u; i < count; ++i) {
+        words.push_back(i % 4 == 0 ? keywords[i % keywords.size()] : "ident_" + std::to_string(i % 997));
+    }
+    return words;
+}
+
+template <typename Lookup>
+auto time_lookup(std::string const& name, std::vector<std::string> const& words, Lookup lookup) -> double {
+    auto keywords = size_t{0};
+    auto const start = Clock::now();
+    for (auto const& word : words) {
+        keywords += lookup(word).has_value();
+    }
+    auto const seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    auto const per_second = static_cast<double>(words.size()) / seconds;
+    std::cout << "    " << name << ": " << per_second << " identifiers/sec (" << keywords << " keywords)\n";
+    return per_second;
+}
+
+auto main(int argc, char** argv) -> int {
+    auto const count = argc > 1 ? std::stoul(argv[1]) : 2'000'000ul;
+    auto const words = make_words(count);
+
+    std::cout << "Keyword recognition over " << count << " identifiers:\n";
+    auto const before = time_lookup("std::map per call", words, map_type_from_lexeme);
+    auto const after = time_lookup("get_type_from_lexeme", words, get_type_from_lexeme);
+    std::cout << "    speedup: " << after / before << "x\n";
+
+    auto const path = std::filesystem::temp_directory_path() / "xpp_lexer_bench.xpp";
+    {
+        auto file = std::ofstream{path};
+        for (auto i = 0u; i < words.size(); ++i) {
+            file << words[i] << ((i % 8 == 7) ? "\n" : " ");
+        }
+    }
+
+    auto handler = std::make_shared<Handler>(true);
+    auto lexer = Lexer{path.string(), handler};
+    auto const start = Clock::now();
+    auto const tokens = lexer.tokenize();
+    auto const seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::filesystem::remove(path);
+
+    std::cout << "Lexer::tokenize: " << tokens.size() << " tokens in " << seconds * 1000 << " ms ("
+              << static_cast<double>(tokens.size()) / seconds << " tokens/sec)\n";
+    return EXIT_SUCCESS;
+}
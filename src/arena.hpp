@@ -0,0 +1,86 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "llvm/Support/Allocator.h"
+
+// Owns every AST and type node of a module. Nodes are bump allocated and handed out as raw pointers that stay
+// valid until the arena (i.e. its module) is destroyed, so nodes can point at each other across modules freely.
+class Arena {
+ public:
+    Arena() = default;
+    Arena(Arena const&) = delete;
+    auto operator=(Arena const&) -> Arena& = delete;
+
+    ~Arena() {
+        // Nodes still own strings and vectors, so they're destroyed before the slabs are released in one go
+        for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+            it->destroy(it->node);
+        }
+    }
+
+    template <typename T, typename... Args>
+    auto make(Args&&... args) -> T* {
+        auto* const node = new (allocator_.Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors_.push_back(Destructor{node, [](void* n) { static_cast<T*>(n)->~T(); }});
+        }
+        ++num_nodes_;
+        return node;
+    }
+
+    auto num_nodes() const noexcept -> size_t {
+        return num_nodes_;
+    }
+
+    auto bytes_allocated() const noexcept -> size_t {
+        return allocator_.getBytesAllocated();
+    }
+
+    // Makes the given arena the one make_node allocates from until the scope ends
+    class Scope {
+     public:
+        Scope(Arena& arena)
+        : previous_(current_) {
+            current_ = &arena;
+        }
+        Scope(Scope const&) = delete;
+        auto operator=(Scope const&) -> Scope& = delete;
+        ~Scope() {
+            current_ = previous_;
+        }
+
+     private:
+        Arena* previous_;
+    };
+
+    // Nodes made outside any module, e.g. the handler's shared types, live in an arena kept for the whole process
+    static auto current() -> Arena& {
+        static auto process_arena = Arena{};
+        return current_ ? *current_ : process_arena;
+    }
+
+ private:
+    struct Destructor {
+        void* node;
+        void (*destroy)(void*);
+    };
+
+    llvm::BumpPtrAllocator allocator_ = {};
+    std::vector<Destructor> destructors_ = {};
+    size_t num_nodes_ = 0;
+
+    inline static thread_local Arena* current_ = nullptr;
+};
+
+// Usage: auto expr = make_node<IntExpr>(pos, value);
+template <typename T, typename... Args>
+auto make_node(Args&&... args) -> T* {
+    return Arena::current().make<T>(std::forward<Args>(args)...);
+}
+
+#endif // ARENA_HPP
@@ -1,27 +1,91 @@
 #ifndef AST_HPP
 #define AST_HPP
 
+#include "./arena.hpp"
 #include "./emitter.hpp"
 #include "./token.hpp"
 #include "./visitor.hpp"
+#include <atomic>
+#include <cassert>
 #include <string>
 
 #include "llvm/IR/Value.h"
 
+// Every kind of node, so the verifier and emitter can tell them apart without RTTI. Declarations, expressions and
+// statements each take up a contiguous range
+enum class NodeKind {
+    PARA_DECL,
+    LOCAL_VAR_DECL,
+    GLOBAL_VAR_DECL,
+    FUNCTION,
+    METHOD_DECL,
+    CONSTRUCTOR_DECL,
+    DESTRUCTOR_DECL,
+    EXTERN,
+    ENUM_DECL,
+    CLASS_FIELD_DECL,
+    CLASS_DECL,
+    EMPTY_EXPR,
+    ASSIGNMENT_EXPR,
+    BINARY_EXPR,
+    UNARY_EXPR,
+    NULL_EXPR,
+    INT_EXPR,
+    UINT_EXPR,
+    DECIMAL_EXPR,
+    BOOL_EXPR,
+    STRING_EXPR,
+    CHAR_EXPR,
+    VAR_EXPR,
+    CALL_EXPR,
+    CONSTRUCTOR_CALL_EXPR,
+    CAST_EXPR,
+    ARRAY_INIT_EXPR,
+    ARRAY_INDEX_EXPR,
+    ENUM_ACCESS_EXPR,
+    FIELD_ACCESS_EXPR,
+    METHOD_ACCESS_EXPR,
+    SIZE_OF_EXPR,
+    IMPORT_EXPR,
+    NEW_EXPR,
+    EMPTY_STMT,
+    COMPOUND_STMT,
+    LOCAL_VAR_STMT,
+    RETURN_STMT,
+    EXPR_STMT,
+    WHILE_STMT,
+    IF_STMT,
+    ELSE_IF_STMT,
+    LOOP_STMT,
+    BREAK_STMT,
+    CONTINUE_STMT,
+    DELETE_STMT
+};
+
 class AST {
  public:
-    AST(Position pos)
-    : pos_(pos) {}
+    AST(NodeKind kind, Position pos)
+    : kind_(kind)
+    , pos_(pos) {
+        num_created.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    AST(Position pos, AST* parent)
-    : pos_(pos)
-    , parent_(parent) {}
+    AST(NodeKind kind, Position pos, AST* parent)
+    : kind_(kind)
+    , pos_(pos)
+    , parent_(parent) {
+        num_created.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    auto set_parent(std::shared_ptr<AST> parent) {
+    auto get_kind() const -> NodeKind {
+        return kind_;
+    }
+
+    auto set_parent(AST* parent) {
         parent_ = parent;
     }
 
-    auto get_parent() -> std::shared_ptr<AST> {
+    auto get_parent() -> AST* {
         return parent_;
     }
 
@@ -36,9 +100,45 @@ class AST {
 
     virtual auto visit(std::shared_ptr<Visitor> visitor) -> void = 0;
 
+    // Total number of nodes constructed, reported by -s/--stat
+    inline static std::atomic<size_t> num_created{0};
+
  private:
+    NodeKind const kind_;
     const Position pos_;
-    std::shared_ptr<AST> parent_ = nullptr;
+    AST* parent_ = nullptr;
 };
 
+// Checked casts between nodes, or between types, in the style of LLVM's: the class cast to decides through its
+// classof whether it covers the kind of what's cast. Unlike dynamic_cast they never look at RTTI
+
+template <typename To, typename From>
+auto isa(From const* from) -> bool {
+    return To::classof(from);
+}
+
+// For when it's known to be one, which is only checked by assertions
+template <typename To, typename From>
+auto cast(From* from) -> To* {
+    assert(from and isa<To>(from) && "cast to a class the value isn't");
+    return static_cast<To*>(from);
+}
+
+template <typename To, typename From>
+auto cast(From const* from) -> To const* {
+    assert(from and isa<To>(from) && "cast to a class the value isn't");
+    return static_cast<To const*>(from);
+}
+
+// Null if it isn't one, or if there's nothing to cast
+template <typename To, typename From>
+auto dyn_cast(From* from) -> To* {
+    return (from and isa<To>(from)) ? static_cast<To*>(from) : nullptr;
+}
+
+template <typename To, typename From>
+auto dyn_cast(From const* from) -> To const* {
+    return (from and isa<To>(from)) ? static_cast<To const*>(from) : nullptr;
+}
+
 #endif // AST_HPP
\ No newline at end of file
@@ -1,11 +1,14 @@
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
 #include "./emitter.hpp"
 #include "./handler.hpp"
 #include "./lexer.hpp"
+#include "./module_graph.hpp"
 #include "./parser.hpp"
-#include "./verifier.hpp"
+
+#include "llvm/Support/TimeProfiler.h"
 
 auto main(int argc, char** argv) -> int {
     auto handler = std::make_shared<Handler>();
@@ -14,17 +17,23 @@ auto main(int argc, char** argv) -> int {
         return EXIT_FAILURE;
     }
 
+    if (!handler->get_time_trace_filename().empty()) {
+        llvm::timeTraceProfilerInitialize(0, argv[0]);
+    }
+
     handler->add_file(handler->source_filename);
 
     auto lexer = Lexer(handler->source_filename, handler);
-    auto tokens = lexer.tokenize();
 
     if (handler->tokens_mode()) {
-        log_tokens(tokens);
+        handler->attach_to(std::cout);
+        while (auto const token = lexer.next()) {
+            std::cout << *token << "\n";
+        }
         exit(EXIT_SUCCESS);
     }
 
-    auto parser = Parser(tokens, handler->source_filename, handler);
+    auto parser = Parser(lexer, handler->source_filename, handler);
     auto module = parser.parse();
 
     if (handler->num_errors_) {
@@ -32,6 +41,7 @@ auto main(int argc, char** argv) -> int {
     }
 
     if (handler->parser_mode()) {
+        handler->attach_to(std::cout);
         std::cout << *module;
         exit(EXIT_SUCCESS);
     }
@@ -39,20 +49,63 @@ auto main(int argc, char** argv) -> int {
     auto modules = std::make_shared<AllModules>();
     modules->add_main_module(module);
 
-    auto verifier = std::make_shared<Verifier>(handler, modules);
-    verifier->check(handler->source_filename, true);
+    auto graph = ModuleGraph(handler, modules);
+    graph.load();
+    if (handler->num_errors_) {
+        exit(EXIT_FAILURE);
+    }
 
+    graph.verify();
     if (handler->num_errors_) {
         exit(EXIT_FAILURE);
     }
 
     auto emitter = std::make_shared<Emitter>(modules, module, handler);
-    emitter->emit();
+    if (!emitter->emit()) {
+        // A module only read from its interface has to be generated after all
+        graph.load_bodies();
+        if (handler->num_errors_) {
+            exit(EXIT_FAILURE);
+        }
+        emitter = std::make_shared<Emitter>(modules, module, handler);
+        emitter->emit();
+    }
+
+    if (handler->stats_mode()) {
+        auto num_functions = size_t{0};
+        auto arena_nodes = size_t{0};
+        auto arena_bytes = size_t{0};
+        for (auto& m : *modules) {
+            arena_nodes += m.get_arena().num_nodes();
+            arena_bytes += m.get_arena().bytes_allocated();
+            num_functions += m.get_functions().size();
+            for (auto const& class_ : m.get_classes()) {
+                num_functions += class_->get_methods().size() + class_->get_constructors().size();
+            }
+        }
+        handler->stats.add_count("AST nodes", AST::num_created);
+        handler->stats.add_count("arena nodes", arena_nodes);
+        handler->stats.add_count("arena bytes", arena_bytes);
+        handler->stats.add_count("symbols", Symbol::num_interned());
+        handler->stats.add_count("types", TypeContext::get().num_types());
+        handler->stats.add_count("modules", modules->size());
+        handler->stats.add_count("module refcounts", Module::num_refcounts);
+        handler->stats.add_count("functions", num_functions);
+
+        if (handler->get_stats_json_filename().empty()) {
+            handler->stats.print(std::cerr);
+        }
+        else {
+            auto stream = std::ofstream{handler->get_stats_json_filename()};
+            handler->stats.print_json(stream);
+        }
+    }
 
-    if (handler->run_exe()) {
-        auto stream = std::string{"./"};
-        stream += handler->get_output_filename();
-        system(stream.c_str());
+    if (llvm::timeTraceProfilerEnabled()) {
+        if (auto error = llvm::timeTraceProfilerWrite(handler->get_time_trace_filename(), "")) {
+            std::cerr << "Failed to write time trace: " << llvm::toString(std::move(error)) << "\n";
+        }
+        llvm::timeTraceProfilerCleanup();
     }
 
     return 0;
@@ -1,8 +1,11 @@
 #include "decl.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
+#include "llvm/Support/TimeProfiler.h"
+
 auto Function::operator==(const Function& other) const -> bool {
     if (this == &other) {
         return true;
@@ -22,41 +25,36 @@ auto Function::operator==(const Function& other) const -> bool {
 }
 
 auto Function::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
+    auto const trace = llvm::TimeTraceScope("codegen function", [&] { return get_ident(); });
     auto return_type = emitter->llvm_type(get_type());
-
-    auto name = get_ident();
-    if (name != "main") {
-        name += get_type_output();
-    }
-    auto func = emitter->llvm_module->getFunction(name);
+    auto func = llvm_function_;
 
     // Setting names of function params
     auto idx = 0u;
     for (auto& arg : func->args()) {
-        arg.setName(paras_[idx]->get_ident() + paras_[idx]->get_append());
+        arg.setName(paras_[idx]->get_local_symbol().str());
         idx++;
     }
 
     auto entry_name = std::to_string(emitter->global_counter++);
     auto entry_block = llvm::BasicBlock::Create(*emitter->context, entry_name, func);
     emitter->llvm_builder->SetInsertPoint(entry_block);
+    emitter->locals.assign(num_slots_, nullptr);
 
     auto paras_iter = paras_.begin();
     for (auto& arg : func->args()) {
-        auto alloca = emitter->llvm_builder->CreateAlloca(emitter->llvm_type(paras_iter->get()->get_type()),
+        auto alloca = emitter->llvm_builder->CreateAlloca(emitter->llvm_type((*paras_iter)->get_type()),
                                                           nullptr,
                                                           arg.getName());
-        if (paras_iter->get()->get_type()->is_class()) {
+        if ((*paras_iter)->get_type()->is_class()) {
             // Call the copy constructor
-            auto class_type = std::dynamic_pointer_cast<ClassType>(paras_iter->get()->get_type());
-            auto copy_constructor_name = "copy_constructor." + class_type->get_ref()->get_ident();
-            auto copy_constructor = emitter->llvm_module->getFunction(copy_constructor_name);
-            emitter->llvm_builder->CreateCall(copy_constructor, {alloca, &arg});
+            auto class_type = cast<ClassType>((*paras_iter)->get_type());
+            emitter->llvm_builder->CreateCall(class_type->get_ref()->get_llvm_copy_constructor(), {alloca, &arg});
         }
         else {
             emitter->llvm_builder->CreateStore(&arg, alloca);
         }
-        emitter->named_values[arg.getName().str()] = alloca;
+        emitter->locals[(*paras_iter)->get_slot()] = alloca;
         ++paras_iter;
     }
 
@@ -102,10 +100,10 @@ auto MethodDecl::operator==(const MethodDecl& other) const -> bool {
 }
 
 auto MethodDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
+    auto const trace = llvm::TimeTraceScope("codegen method",
+                                            [&] { return emitter->curr_class_->get_ident() + "::" + get_ident(); });
     auto return_type = emitter->llvm_type(get_type());
-
-    auto name = "method." + emitter->curr_class_->get_ident() + get_ident() + get_type_output();
-    auto method = emitter->llvm_module->getFunction(name);
+    auto method = llvm_function_;
     assert(method != nullptr);
 
     // Setting names of method params
@@ -115,7 +113,7 @@ auto MethodDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
             arg.setName("this");
         }
         else {
-            arg.setName(paras_[idx - 1]->get_ident() + paras_[idx - 1]->get_append());
+            arg.setName(paras_[idx - 1]->get_local_symbol().str());
         }
         idx++;
     }
@@ -123,24 +121,23 @@ auto MethodDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     auto entry_name = std::to_string(emitter->global_counter++);
     auto entry_block = llvm::BasicBlock::Create(*emitter->context, entry_name, method);
     emitter->llvm_builder->SetInsertPoint(entry_block);
+    emitter->locals.assign(num_slots_, nullptr);
 
     auto paras_iter = paras_.begin();
     auto c = 0u;
     for (auto& arg : method->args()) {
-        auto t = c ? emitter->llvm_type(paras_iter->get()->get_type()) : arg.getType();
+        auto t = c ? emitter->llvm_type((*paras_iter)->get_type()) : arg.getType();
         auto alloca = emitter->llvm_builder->CreateAlloca(t, nullptr, arg.getName());
-        if (c and paras_iter != paras_.end() and paras_iter->get()->get_type()->is_class()) {
+        if (c and paras_iter != paras_.end() and (*paras_iter)->get_type()->is_class()) {
             // Call the copy constructor
-            auto class_type = std::dynamic_pointer_cast<ClassType>(paras_iter->get()->get_type());
-            auto copy_constructor_name = "copy_constructor." + class_type->get_ref()->get_ident();
-            auto copy_constructor = emitter->llvm_module->getFunction(copy_constructor_name);
-            emitter->llvm_builder->CreateCall(copy_constructor, {alloca, &arg});
+            auto class_type = cast<ClassType>((*paras_iter)->get_type());
+            emitter->llvm_builder->CreateCall(class_type->get_ref()->get_llvm_copy_constructor(), {alloca, &arg});
         }
         else {
             emitter->llvm_builder->CreateStore(&arg, alloca);
         }
-        emitter->named_values[arg.getName().str()] = alloca;
-        if (arg.getName() != "this") {
+        emitter->locals[c ? (*paras_iter)->get_slot() : Emitter::this_slot] = alloca;
+        if (c) {
             ++paras_iter;
         }
         ++c;
@@ -170,25 +167,9 @@ auto MethodDecl::print(std::ostream& os) const -> void {
 }
 
 auto ConstructorDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
+    auto const trace = llvm::TimeTraceScope("codegen constructor", [&] { return emitter->curr_class_->get_ident(); });
     emitter->instantiating_constructor_ = true;
-    auto is_copy_constructor = false;
-    if (paras_.size() == 1) {
-        if (auto l = std::dynamic_pointer_cast<PointerType>(paras_[0]->get_type())) {
-            if (*l->get_sub_type() == *emitter->curr_class_->get_type()) {
-                is_copy_constructor = true;
-            }
-        }
-    }
-
-    auto name = std::string{};
-    if (is_copy_constructor) {
-        name = "copy_constructor." + ident_;
-    }
-    else {
-        name = "constructor." + ident_ + get_type_output();
-    }
-
-    auto constructor = emitter->llvm_module->getFunction(name);
+    auto constructor = llvm_function_;
 
     auto idx = 0u;
     for (auto& arg : constructor->args()) {
@@ -196,7 +177,7 @@ auto ConstructorDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value*
             arg.setName("this");
         }
         else {
-            arg.setName(paras_[idx - 1]->get_ident() + paras_[idx - 1]->get_append());
+            arg.setName(paras_[idx - 1]->get_local_symbol().str());
         }
         ++idx;
     }
@@ -204,24 +185,23 @@ auto ConstructorDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value*
     auto entry_name = std::to_string(emitter->global_counter++);
     auto entry_block = llvm::BasicBlock::Create(*emitter->context, entry_name, constructor);
     emitter->llvm_builder->SetInsertPoint(entry_block);
+    emitter->locals.assign(num_slots_, nullptr);
 
     auto paras_iter = paras_.begin();
     auto c = 0u;
     for (auto& arg : constructor->args()) {
-        auto t = c ? emitter->llvm_type(paras_iter->get()->get_type()) : arg.getType();
+        auto t = c ? emitter->llvm_type((*paras_iter)->get_type()) : arg.getType();
         auto alloca = emitter->llvm_builder->CreateAlloca(t, nullptr, arg.getName());
-        if (c and paras_iter != paras_.end() and paras_iter->get()->get_type()->is_class()) {
+        if (c and paras_iter != paras_.end() and (*paras_iter)->get_type()->is_class()) {
             // Call the copy constructor
-            auto class_type = std::dynamic_pointer_cast<ClassType>(paras_iter->get()->get_type());
-            auto copy_constructor_name = "copy_constructor." + class_type->get_ref()->get_ident();
-            auto copy_constructor = emitter->llvm_module->getFunction(copy_constructor_name);
-            emitter->llvm_builder->CreateCall(copy_constructor, {alloca, &arg});
+            auto class_type = cast<ClassType>((*paras_iter)->get_type());
+            emitter->llvm_builder->CreateCall(class_type->get_ref()->get_llvm_copy_constructor(), {alloca, &arg});
         }
         else {
             emitter->llvm_builder->CreateStore(&arg, alloca);
         }
-        emitter->named_values[arg.getName().str()] = alloca;
-        if (arg.getName() != "this") {
+        emitter->locals[c ? (*paras_iter)->get_slot() : Emitter::this_slot] = alloca;
+        if (c) {
             ++paras_iter;
         }
         ++c;
@@ -258,8 +238,8 @@ auto ConstructorDecl::operator==(ConstructorDecl const& other) const -> bool {
 }
 
 auto DestructorDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    auto name = "destructor." + ident_;
-    auto destructor = emitter->llvm_module->getFunction(name);
+    // Declared on the class, as a class without a destructor has one made for it here
+    auto destructor = emitter->curr_class_->get_llvm_destructor();
 
     auto arg = destructor->args().begin();
     arg->setName("this");
@@ -267,10 +247,12 @@ auto DestructorDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     auto entry_name = std::to_string(emitter->global_counter++);
     auto entry_block = llvm::BasicBlock::Create(*emitter->context, entry_name, destructor);
     emitter->llvm_builder->SetInsertPoint(entry_block);
+    // The destructor made for a class without one is never verified, so it's given no slots, not even this
+    emitter->locals.assign(std::max<size_t>(num_slots_, Emitter::this_slot + 1), nullptr);
 
     auto alloca = emitter->llvm_builder->CreateAlloca(arg->getType(), nullptr, arg->getName());
     emitter->llvm_builder->CreateStore(arg, alloca);
-    emitter->named_values[arg->getName().str()] = alloca;
+    emitter->locals[Emitter::this_slot] = alloca;
 
     stmts_->codegen(emitter);
 
@@ -280,13 +262,13 @@ auto DestructorDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     for (auto it = fields.rbegin(); it != fields.rend(); ++it) {
         auto member = *it;
         if (member->get_type()->is_class()) {
-            auto member_type = std::dynamic_pointer_cast<ClassType>(member->get_type());
+            auto member_type = cast<ClassType>(member->get_type());
             auto member_class = member_type->get_ref();
-            auto equivalent_destructor = emitter->llvm_module->getFunction("destructor." + member_class->get_ident());
+            auto equivalent_destructor = member_class->get_llvm_destructor();
             assert(equivalent_destructor != nullptr);
 
             auto const field_index = class_->get_index_for_field(member->get_ident());
-            auto const this_ptr = emitter->named_values["this"];
+            auto const this_ptr = emitter->locals[Emitter::this_slot];
             auto const class_type = emitter->llvm_type(member_class);
 
             auto const this_pointer =
@@ -335,6 +317,12 @@ auto Extern::operator==(Extern const& other) const -> bool {
 }
 
 auto Extern::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
+    // Externs declared by more than one module all call the same symbol
+    if (auto const existing = emitter->llvm_module->getFunction(get_ident())) {
+        llvm_function_ = existing;
+        return existing;
+    }
+
     auto const return_type = emitter->llvm_type(get_type());
 
     auto param_types = std::vector<llvm::Type*>{};
@@ -348,7 +336,7 @@ auto Extern::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
 
     auto func_type = llvm::FunctionType::get(return_type, param_types, has_variatic_);
     auto func = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, get_ident(), *emitter->llvm_module);
-
+    llvm_function_ = func;
     return func;
 }
 
@@ -378,22 +366,22 @@ auto ParaDecl::print(std::ostream& os) const -> void {
 auto LocalVarDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     auto llvm_type = emitter->llvm_type(get_type());
 
-    auto constructor_decl = std::dynamic_pointer_cast<ConstructorCallExpr>(expr_);
-    auto new_expr = std::dynamic_pointer_cast<NewExpr>(expr_);
+    auto constructor_decl = dyn_cast<ConstructorCallExpr>(expr_);
+    auto new_expr = dyn_cast<NewExpr>(expr_);
     auto valid_new = false;
     if (new_expr) {
-        auto t = std::dynamic_pointer_cast<PointerType>(new_expr->get_type());
+        auto t = cast<PointerType>(new_expr->get_type());
         if (t->get_sub_type()->is_class()) {
             valid_new = true;
         }
     }
 
-    auto alloca = emitter->llvm_builder->CreateAlloca(llvm_type, nullptr, get_ident() + get_append());
+    auto alloca = emitter->llvm_builder->CreateAlloca(llvm_type, nullptr, get_local_symbol().str());
     if (constructor_decl or valid_new) {
         emitter->alloca = alloca;
         expr_->codegen(emitter);
         emitter->alloca = nullptr;
-        emitter->named_values[get_ident() + get_append()] = alloca;
+        emitter->locals[get_slot()] = alloca;
         return alloca;
     }
 
@@ -401,27 +389,26 @@ auto LocalVarDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
         emitter->set_array_alloca(alloca);
     }
 
-    if (auto l = std::dynamic_pointer_cast<VarExpr>(expr_)) {
+    if (auto l = dyn_cast<VarExpr>(expr_)) {
         if (expr_->get_type()->is_class()) {
-            auto class_type = std::dynamic_pointer_cast<ClassType>(expr_->get_type());
-            auto copy_constructor =
-                emitter->llvm_module->getFunction("copy_constructor." + class_type->get_ref()->get_ident());
+            auto class_type = cast<ClassType>(expr_->get_type());
+            auto copy_constructor = class_type->get_ref()->get_llvm_copy_constructor();
             auto arg_vals = std::vector<llvm::Value*>{};
             arg_vals.push_back(alloca);
-            arg_vals.push_back(emitter->named_values[l->get_name() + l->get_ref()->get_append()]);
+            arg_vals.push_back(emitter->storage(l->get_ref()));
             emitter->llvm_builder->CreateCall(copy_constructor, arg_vals);
-            emitter->named_values[get_ident() + get_append()] = alloca;
+            emitter->locals[get_slot()] = alloca;
             return alloca;
         }
     }
 
     auto init_val = expr_->codegen(emitter);
-    auto is_array_init_expr = std::dynamic_pointer_cast<ArrayInitExpr>(expr_);
+    auto is_array_init_expr = dyn_cast<ArrayInitExpr>(expr_);
     if (!is_array_init_expr and init_val) {
         emitter->llvm_builder->CreateStore(init_val, alloca);
     }
 
-    emitter->named_values[get_ident() + get_append()] = alloca;
+    emitter->locals[get_slot()] = alloca;
     return alloca;
 }
 
@@ -432,14 +419,14 @@ auto LocalVarDecl::print(std::ostream& os) const -> void {
 }
 
 auto GlobalVarDecl::handle_global_arr(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    auto const arr_type = std::dynamic_pointer_cast<ArrayType>(get_type());
+    auto const arr_type = cast<ArrayType>(get_type());
     auto const arr_len = *arr_type->get_length();
     auto const llvm_type = static_cast<llvm::ArrayType*>(emitter->llvm_type(arr_type));
 
     auto const_elems = std::vector<llvm::Constant*>{};
     const_elems.reserve(arr_len);
 
-    if (auto const l = std::dynamic_pointer_cast<ArrayInitExpr>(expr_)) {
+    if (auto const l = dyn_cast<ArrayInitExpr>(expr_)) {
         auto i = 0u;
         llvm::Constant* last_seen;
         for (auto& elem : l->get_exprs()) {
@@ -465,8 +452,9 @@ auto GlobalVarDecl::handle_global_arr(std::shared_ptr<Emitter> emitter) -> llvm:
                                                      false,
                                                      llvm::GlobalValue::ExternalLinkage,
                                                      const_array,
-                                                     ident_ + get_append());
-    emitter->named_values[ident_ + get_append()] = global_var;
+                                                     get_local_symbol().str());
+    emitter->check_clash(global_var, get_local_symbol().str());
+    emitter->globals[get_local_symbol()] = global_var;
     return global_var;
 }
 
@@ -480,9 +468,10 @@ auto GlobalVarDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
                                                false,
                                                llvm::GlobalValue::ExternalLinkage,
                                                nullptr,
-                                               ident_);
+                                               get_ident());
+    emitter->check_clash(global_var, get_ident());
 
-    auto const has_expr = !(std::dynamic_pointer_cast<EmptyExpr>(expr_));
+    auto const has_expr = !isa<EmptyExpr>(expr_);
     if (has_expr) {
         auto val = expr_->codegen(emitter);
         global_var->setInitializer(llvm::dyn_cast<llvm::Constant>(val));
@@ -491,7 +480,7 @@ auto GlobalVarDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
         global_var->setInitializer(llvm::Constant::getNullValue(llvm_type));
     }
 
-    emitter->named_values[ident_ + get_append()] = global_var;
+    emitter->globals[get_local_symbol()] = global_var;
     return global_var;
 }
 
@@ -560,13 +549,13 @@ auto ClassFieldDecl::print(std::ostream& os) const -> void {
 }
 
 auto ClassFieldDecl::operator==(ClassFieldDecl const& other) const -> bool {
-    return get_ident() == other.get_ident();
+    return get_symbol() == other.get_symbol();
 }
 
-auto ClassDecl::get_index_for_field(std::string field_name) const -> int {
+auto ClassDecl::get_index_for_field(Symbol field_name) const -> int {
     auto idx = 0;
     for (auto const& field : fields_) {
-        if (field->get_ident() == field_name) {
+        if (field->get_symbol() == field_name) {
             return idx;
         }
         ++idx;
@@ -575,27 +564,27 @@ auto ClassDecl::get_index_for_field(std::string field_name) const -> int {
     return -1;
 }
 
-auto ClassDecl::method_exists(std::string const& method_name) const -> bool {
+auto ClassDecl::method_exists(Symbol method_name) const -> bool {
     for (auto const& method : methods_) {
-        if (method->get_ident() == method_name) {
+        if (method->get_symbol() == method_name) {
             return true;
         }
     }
     return false;
 }
 
-auto ClassDecl::field_exists(std::string const& field_name) const -> bool {
+auto ClassDecl::field_exists(Symbol field_name) const -> bool {
     for (auto const& field : fields_) {
-        if (field->get_ident() == field_name) {
+        if (field->get_symbol() == field_name) {
             return true;
         }
     }
     return false;
 }
 
-auto ClassDecl::get_field_type(std::string field_name) const -> std::shared_ptr<Type> {
+auto ClassDecl::get_field_type(Symbol field_name) const -> Type* {
     for (auto const& field : fields_) {
-        if (field->get_ident() == field_name) {
+        if (field->get_symbol() == field_name) {
             return field->get_type();
         }
     }
@@ -603,18 +592,18 @@ auto ClassDecl::get_field_type(std::string field_name) const -> std::shared_ptr<
     return nullptr;
 }
 
-auto ClassDecl::field_is_private(std::string const& field_name) const -> bool {
+auto ClassDecl::field_is_private(Symbol field_name) const -> bool {
     for (auto const& field : fields_) {
-        if (field->get_ident() == field_name) {
+        if (field->get_symbol() == field_name) {
             return !field->is_pub();
         }
     }
     return false;
 }
 
-auto ClassDecl::get_field(std::string const& name) const -> std::shared_ptr<ClassFieldDecl> {
+auto ClassDecl::get_field(Symbol name) const -> ClassFieldDecl* {
     for (auto const& field : fields_) {
-        if (field->get_ident() == name) {
+        if (field->get_symbol() == name) {
             return field;
         }
     }
@@ -622,9 +611,9 @@ auto ClassDecl::get_field(std::string const& name) const -> std::shared_ptr<Clas
     return nullptr;
 }
 
-auto ClassDecl::get_method(std::shared_ptr<MethodAccessExpr> method) const -> std::optional<std::shared_ptr<MethodDecl>> {
+auto ClassDecl::get_method(MethodAccessExpr* method) const -> std::optional<MethodDecl*> {
     auto it = std::find_if(methods_.begin(), methods_.end(), [&](auto const& m) {
-        if (m->get_ident() != method->get_method_name()) {
+        if (m->get_symbol() != method->get_symbol()) {
             return false;
         }
 
@@ -636,7 +625,9 @@ auto ClassDecl::get_method(std::shared_ptr<MethodAccessExpr> method) const -> st
         }
 
         for (size_t i = 0; i < call_args.size(); ++i) {
-            if (!method_params[i]->get_type()->equal_soft(*call_args[i]->get_type())) {
+            auto const para_type = method_params[i]->get_type();
+            auto const arg_type = call_args[i]->get_type();
+            if (para_type != arg_type and !para_type->equal_soft(*arg_type)) {
                 return false;
             }
         }
@@ -650,7 +641,7 @@ auto ClassDecl::get_method(std::shared_ptr<MethodAccessExpr> method) const -> st
 }
 
 auto ClassDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    emitter->curr_class_ = shared_from_this();
+    emitter->curr_class_ = this;
 
     for (auto& constructor : constructors_) {
         constructor->codegen(emitter);
@@ -667,8 +658,8 @@ auto ClassDecl::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
         destructors_.front()->codegen(emitter);
     }
     else {
-        auto empty_compound_stmt = std::make_shared<CompoundStmt>(pos());
-        auto destructor = std::make_shared<DestructorDecl>(pos(), get_ident(), empty_compound_stmt);
+        auto empty_compound_stmt = make_node<CompoundStmt>(pos());
+        auto destructor = make_node<DestructorDecl>(pos(), get_ident(), empty_compound_stmt);
         destructor->codegen(emitter);
     }
 
@@ -699,7 +690,7 @@ auto ClassDecl::print(std::ostream& os) const -> void {
 }
 
 auto ClassDecl::operator==(ClassDecl const& other) const -> bool {
-    return get_ident() == other.get_ident();
+    return get_symbol() == other.get_symbol();
 }
 
 auto ClassDecl::get_class_type_name() -> std::string {
@@ -719,8 +710,7 @@ auto ClassDecl::generate_copy_constructor(std::shared_ptr<Emitter> emitter) -> v
     auto& curr_class = emitter->curr_class_;
     auto const class_type = emitter->llvm_type(curr_class);
 
-    auto const& name = "copy_constructor." + curr_class->get_ident();
-    auto constructor = emitter->llvm_module->getFunction(name);
+    auto constructor = curr_class->get_llvm_copy_constructor();
     auto idx = 0u;
     for (auto& arg : constructor->args()) {
         if (idx == 0) {
@@ -738,16 +728,17 @@ auto ClassDecl::generate_copy_constructor(std::shared_ptr<Emitter> emitter) -> v
     auto entry_name = std::to_string(emitter->global_counter++);
     auto entry_block = llvm::BasicBlock::Create(*emitter->context, entry_name, constructor);
     emitter->llvm_builder->SetInsertPoint(entry_block);
+    emitter->locals.assign(2, nullptr);
 
     for (auto& arg : constructor->args()) {
         auto alloca = emitter->llvm_builder->CreateAlloca(arg.getType(), nullptr, arg.getName());
         emitter->llvm_builder->CreateStore(&arg, alloca);
-        emitter->named_values[arg.getName().str()] = alloca;
+        emitter->locals[arg.getArgNo() == 0 ? Emitter::this_slot : Emitter::other_slot] = alloca;
     }
 
-    auto& this_ptr_ptr = emitter->named_values["this"];
+    auto& this_ptr_ptr = emitter->locals[Emitter::this_slot];
     auto this_ptr = emitter->llvm_builder->CreateLoad(llvm::PointerType::getUnqual(class_type), this_ptr_ptr);
-    auto& other_ptr_ptr = emitter->named_values["other"];
+    auto& other_ptr_ptr = emitter->locals[Emitter::other_slot];
     auto other_ptr = emitter->llvm_builder->CreateLoad(llvm::PointerType::getUnqual(class_type), other_ptr_ptr);
 
     for (auto& field : curr_class->get_fields()) {
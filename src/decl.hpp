@@ -7,35 +7,42 @@
 #include "./type.hpp"
 #include "./visitor.hpp"
 
+#include <atomic>
 #include <sstream>
 
 class Decl : public AST {
  public:
-    Decl(Position pos, std::string ident, std::shared_ptr<Type> t)
-    : AST(pos)
-    , ident_(std::move(ident))
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() >= NodeKind::PARA_DECL and node->get_kind() <= NodeKind::CLASS_DECL;
+    }
+
+    Decl(NodeKind kind, Position pos, Symbol ident, Type* t)
+    : AST(kind, pos)
+    , ident_(ident)
     , t_(t) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override = 0;
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override = 0;
     auto print(std::ostream& os) const -> void override = 0;
 
-    auto set_type(std::shared_ptr<Type> t) -> void {
+    auto set_type(Type* t) -> void {
         t_ = t;
     }
 
     auto is_used() const -> bool {
-        return is_used_;
+        return is_used_.load(std::memory_order_relaxed);
     }
+    // Modules verified in parallel can mark a declaration they both depend on as used
     auto set_used() -> void {
-        is_used_ = true;
+        is_used_.store(true, std::memory_order_relaxed);
     }
 
     auto is_reassigned() const -> bool {
-        return is_reassigned_;
+        return is_reassigned_.load(std::memory_order_relaxed);
     }
+    // As can assigning to one
     auto set_reassigned() -> void {
-        is_reassigned_ = true;
+        is_reassigned_.store(true, std::memory_order_relaxed);
     }
 
     auto is_mut() const -> bool {
@@ -53,9 +60,12 @@ class Decl : public AST {
     }
 
     auto get_ident() const -> std::string const& {
+        return ident_.str();
+    }
+    auto get_symbol() const -> Symbol {
         return ident_;
     }
-    auto get_type() const -> std::shared_ptr<Type> {
+    auto get_type() const -> Type* {
         return t_;
     }
 
@@ -71,22 +81,61 @@ class Decl : public AST {
         return "." + std::to_string(statement_num_) + "_" + std::to_string(depth_num_);
     }
 
+    // The identifier plus its append, which globals are keyed by and locals' storage is named after
+    auto get_local_symbol() -> Symbol {
+        if (!local_symbol_) {
+            local_symbol_ = Symbol{get_ident() + get_append()};
+        }
+        return *local_symbol_;
+    }
+
+    // The verifier numbers the parameters and local variables of each function, method, constructor and destructor
+    // from zero, which the emitter keeps their storage by
+    auto set_slot(size_t slot) -> void {
+        slot_ = slot;
+    }
+    auto get_slot() const -> size_t {
+        return slot_;
+    }
+
+    // How many slots a function, method, constructor or destructor's parameters and local variables take
+    auto set_num_slots(size_t num) -> void {
+        num_slots_ = num;
+    }
+    auto get_num_slots() const -> size_t {
+        return num_slots_;
+    }
+
+    // What the emitter declared a function, extern, method or constructor as, which calls to it go to
+    auto set_llvm_function(llvm::Function* function) -> void {
+        llvm_function_ = function;
+    }
+    auto get_llvm_function() const -> llvm::Function* {
+        return llvm_function_;
+    }
+
  protected:
-    bool is_used_ = false, is_reassigned_ = false, is_mut_ = false, is_pub_ = false;
-    std::string ident_;
-    std::shared_ptr<Type> t_;
+    std::atomic<bool> is_used_ = false, is_reassigned_ = false;
+    bool is_mut_ = false, is_pub_ = false;
+    Symbol ident_;
+    std::optional<Symbol> local_symbol_ = std::nullopt;
+    Type* t_;
     size_t statement_num_ = 0, depth_num_ = 0;
+    size_t slot_ = 0, num_slots_ = 0;
+    llvm::Function* llvm_function_ = nullptr;
 };
 
-class ParaDecl
-: public Decl
-, public std::enable_shared_from_this<ParaDecl> {
+class ParaDecl : public Decl {
  public:
-    ParaDecl(Position pos, std::string ident, std::shared_ptr<Type> t)
-    : Decl(pos, ident, t) {}
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::PARA_DECL;
+    }
+
+    ParaDecl(Position pos, Symbol ident, Type* t)
+    : Decl(NodeKind::PARA_DECL, pos, ident, t) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_para_decl(shared_from_this());
+        visitor->visit_para_decl(this);
     }
 
     auto operator==(const ParaDecl& other) const -> bool {
@@ -101,88 +150,94 @@ class ParaDecl
     auto print(std::ostream& os) const -> void override;
 };
 
-class LocalVarDecl
-: public Decl
-, public std::enable_shared_from_this<LocalVarDecl> {
+class LocalVarDecl : public Decl {
  public:
-    LocalVarDecl(Position pos, std::string ident, std::shared_ptr<Type> t, std::shared_ptr<Expr> e)
-    : Decl(pos, ident, t)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::LOCAL_VAR_DECL;
+    }
+
+    LocalVarDecl(Position pos, Symbol ident, Type* t, Expr* e)
+    : Decl(NodeKind::LOCAL_VAR_DECL, pos, ident, t)
     , expr_(e) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_local_var_decl(shared_from_this());
+        visitor->visit_local_var_decl(this);
     }
 
-    auto set_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr(Expr* expr) -> void {
         expr_ = expr;
     }
 
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto get_expr() const -> std::shared_ptr<Expr> {
+    auto get_expr() const -> Expr* {
         return expr_;
     }
 
  private:
-    std::shared_ptr<Expr> expr_;
+    Expr* expr_;
 };
 
-class GlobalVarDecl
-: public Decl
-, public std::enable_shared_from_this<GlobalVarDecl> {
+class GlobalVarDecl : public Decl {
  public:
-    GlobalVarDecl(Position pos, std::string const ident, std::shared_ptr<Type> t, std::shared_ptr<Expr> expr)
-    : Decl(pos, ident, t)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::GLOBAL_VAR_DECL;
+    }
+
+    GlobalVarDecl(Position pos, Symbol ident, Type* t, Expr* expr)
+    : Decl(NodeKind::GLOBAL_VAR_DECL, pos, ident, t)
     , expr_(expr) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_global_var_decl(shared_from_this());
+        visitor->visit_global_var_decl(this);
     }
 
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
     auto operator==(GlobalVarDecl const& other) -> bool {
-        return get_ident() == other.get_ident();
+        return get_symbol() == other.get_symbol();
     }
 
-    auto set_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr(Expr* expr) -> void {
         expr_ = expr;
     }
 
-    auto get_expr() const -> std::shared_ptr<Expr> {
+    auto get_expr() const -> Expr* {
         return expr_;
     }
 
     auto handle_global_arr(std::shared_ptr<Emitter> emitter) -> llvm::Value*;
 
  private:
-    std::shared_ptr<Expr> expr_;
+    Expr* expr_;
 };
 
-class Function
-: public Decl
-, public std::enable_shared_from_this<Function> {
+class Function : public Decl {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::FUNCTION;
+    }
+
     Function(Position const pos,
-             std::string const ident,
-             std::vector<std::shared_ptr<ParaDecl>> paras,
-             std::shared_ptr<Type> t,
-             std::shared_ptr<CompoundStmt> const stmts)
-    : Decl(pos, ident, t)
+             Symbol ident,
+             std::vector<ParaDecl*> paras,
+             Type* t,
+             CompoundStmt* const stmts)
+    : Decl(NodeKind::FUNCTION, pos, ident, t)
     , paras_(paras)
     , stmts_(stmts) {}
 
-    auto get_paras() const -> std::vector<std::shared_ptr<ParaDecl>> const& {
+    auto get_paras() const -> std::vector<ParaDecl*> const& {
         return paras_;
     }
-    auto get_compound_stmt() const -> std::shared_ptr<CompoundStmt> const& {
+    auto get_compound_stmt() const -> CompoundStmt* const& {
         return stmts_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_function(shared_from_this());
+        visitor->visit_function(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -204,32 +259,30 @@ class Function
     auto operator==(const Function& other) const -> bool;
 
  private:
-    std::vector<std::shared_ptr<ParaDecl>> const paras_;
-    std::shared_ptr<CompoundStmt> const stmts_;
+    std::vector<ParaDecl*> const paras_;
+    CompoundStmt* const stmts_;
     std::string type_output = "";
 };
 
-class MethodDecl
-: public Decl
-, public std::enable_shared_from_this<MethodDecl> {
+class MethodDecl : public Decl {
  public:
-    MethodDecl(Position const pos,
-               std::string const ident,
-               std::vector<std::shared_ptr<ParaDecl>> paras,
-               std::shared_ptr<Type> t,
-               std::shared_ptr<CompoundStmt> stmts)
-    : Decl(pos, ident, t)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::METHOD_DECL;
+    }
+
+    MethodDecl(Position const pos, Symbol ident, std::vector<ParaDecl*> paras, Type* t, CompoundStmt* stmts)
+    : Decl(NodeKind::METHOD_DECL, pos, ident, t)
     , paras_(paras)
     , stmts_(stmts) {}
-    auto get_paras() const -> std::vector<std::shared_ptr<ParaDecl>> const& {
+    auto get_paras() const -> std::vector<ParaDecl*> const& {
         return paras_;
     }
-    auto get_compound_stmt() const -> std::shared_ptr<CompoundStmt> const& {
+    auto get_compound_stmt() const -> CompoundStmt* const& {
         return stmts_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_method_decl(shared_from_this());
+        visitor->visit_method_decl(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -250,42 +303,41 @@ class MethodDecl
 
     auto operator==(const MethodDecl& other) const -> bool;
 
-    auto set_class_ref(std::shared_ptr<ClassDecl> class_ref) -> void {
+    auto set_class_ref(ClassDecl* class_ref) -> void {
         class_ref_ = class_ref;
     }
 
-    auto get_class_ref() -> std::shared_ptr<ClassDecl> {
+    auto get_class_ref() -> ClassDecl* {
         return class_ref_;
     }
 
  private:
-    std::vector<std::shared_ptr<ParaDecl>> const paras_;
-    std::shared_ptr<CompoundStmt> const stmts_;
+    std::vector<ParaDecl*> const paras_;
+    CompoundStmt* const stmts_;
     std::string type_output = "";
-    std::shared_ptr<ClassDecl> class_ref_;
+    ClassDecl* class_ref_;
 };
 
-class ConstructorDecl
-: public Decl
-, public std::enable_shared_from_this<ConstructorDecl> {
+class ConstructorDecl : public Decl {
  public:
-    ConstructorDecl(Position const pos,
-                    std::string const ident,
-                    std::vector<std::shared_ptr<ParaDecl>> paras,
-                    std::shared_ptr<CompoundStmt> stmts)
-    : Decl(pos, ident, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::CONSTRUCTOR_DECL;
+    }
+
+    ConstructorDecl(Position const pos, Symbol ident, std::vector<ParaDecl*> paras, CompoundStmt* stmts)
+    : Decl(NodeKind::CONSTRUCTOR_DECL, pos, ident, Type::get())
     , paras_(paras)
     , stmts_(stmts) {}
 
-    auto get_paras() const -> std::vector<std::shared_ptr<ParaDecl>> const& {
+    auto get_paras() const -> std::vector<ParaDecl*> const& {
         return paras_;
     }
-    auto get_compound_stmt() const -> std::shared_ptr<CompoundStmt> const& {
+    auto get_compound_stmt() const -> CompoundStmt* const& {
         return stmts_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_constructor_decl(shared_from_this());
+        visitor->visit_constructor_decl(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -307,47 +359,51 @@ class ConstructorDecl
     }
 
  private:
-    std::vector<std::shared_ptr<ParaDecl>> const paras_;
-    std::shared_ptr<CompoundStmt> const stmts_;
+    std::vector<ParaDecl*> const paras_;
+    CompoundStmt* const stmts_;
     std::string type_output = "";
 };
 
-class DestructorDecl
-: public Decl
-, public std::enable_shared_from_this<DestructorDecl> {
+class DestructorDecl : public Decl {
  public:
-    DestructorDecl(Position const pos, std::string const ident, std::shared_ptr<CompoundStmt> stmts)
-    : Decl(pos, ident, std::make_shared<Type>(TypeSpec::VOID))
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::DESTRUCTOR_DECL;
+    }
+
+    DestructorDecl(Position const pos, Symbol ident, CompoundStmt* stmts)
+    : Decl(NodeKind::DESTRUCTOR_DECL, pos, ident, Type::get(TypeSpec::VOID))
     , stmts_(stmts) {}
 
-    auto get_compound_stmt() const -> std::shared_ptr<CompoundStmt> const& {
+    auto get_compound_stmt() const -> CompoundStmt* const& {
         return stmts_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_destructor_decl(shared_from_this());
+        visitor->visit_destructor_decl(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<CompoundStmt> const stmts_;
+    CompoundStmt* const stmts_;
 };
 
-class Extern
-: public Decl
-, public std::enable_shared_from_this<Extern> {
+class Extern : public Decl {
  public:
-    Extern(Position pos, std::string const ident, std::shared_ptr<Type> const t, std::vector<std::shared_ptr<Type>> types)
-    : Decl(pos, ident, t)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::EXTERN;
+    }
+
+    Extern(Position pos, Symbol ident, Type* const t, std::vector<Type*> types)
+    : Decl(NodeKind::EXTERN, pos, ident, t)
     , types_(types) {}
 
-    auto get_types() const -> std::vector<std::shared_ptr<Type>> {
+    auto get_types() const -> std::vector<Type*> {
         return types_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_extern(shared_from_this());
+        visitor->visit_extern(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -355,35 +411,36 @@ class Extern
     auto operator==(const Extern& other) const -> bool;
 
     auto set_variatic() -> void {
-        has_variatic_ = true;
+        has_variatic_.store(true, std::memory_order_relaxed);
     }
 
     auto is_variatic() -> bool {
-        return has_variatic_;
+        return has_variatic_.load(std::memory_order_relaxed);
     }
 
  private:
-    std::vector<std::shared_ptr<Type>> const types_;
-    bool has_variatic_ = false;
+    std::vector<Type*> const types_;
+    std::atomic<bool> has_variatic_ = false;
 };
 
-class EnumDecl
-: public Decl
-, public std::enable_shared_from_this<EnumDecl> {
+class EnumDecl : public Decl {
  public:
-    EnumDecl(Position const pos, std::string const name, std::vector<std::string> const fields)
-    : Decl(pos, name, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::ENUM_DECL;
+    }
+
+    EnumDecl(Position const pos, Symbol name, std::vector<std::string> const fields)
+    : Decl(NodeKind::ENUM_DECL, pos, name, Type::get())
     , fields_(fields) {}
 
-    static std::shared_ptr<EnumDecl>
-    make(Position const pos, std::string const name, std::vector<std::string> const fields) {
-        auto decl = std::make_shared<EnumDecl>(pos, name, fields);
-        decl->set_type(std::make_shared<EnumType>(decl));
+    static EnumDecl* make(Position const pos, Symbol name, std::vector<std::string> const fields) {
+        auto decl = make_node<EnumDecl>(pos, name, fields);
+        decl->set_type(EnumType::get(decl));
         return decl;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_enum_decl(shared_from_this());
+        visitor->visit_enum_decl(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -399,15 +456,17 @@ class EnumDecl
     std::vector<std::string> const fields_;
 };
 
-class ClassFieldDecl
-: public Decl
-, public std::enable_shared_from_this<ClassFieldDecl> {
+class ClassFieldDecl : public Decl {
  public:
-    ClassFieldDecl(Position const pos, std::string const name, std::shared_ptr<Type> type)
-    : Decl(pos, name, type) {}
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::CLASS_FIELD_DECL;
+    }
+
+    ClassFieldDecl(Position const pos, Symbol name, Type* type)
+    : Decl(NodeKind::CLASS_FIELD_DECL, pos, name, type) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_class_field_decl(shared_from_this());
+        visitor->visit_class_field_decl(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -417,23 +476,25 @@ class ClassFieldDecl
  private:
 };
 
-class ClassDecl
-: public Decl
-, public std::enable_shared_from_this<ClassDecl> {
+class ClassDecl : public Decl {
  public:
-    static std::shared_ptr<ClassDecl> make(Position const pos,
-                                           std::string const name,
-                                           std::vector<std::shared_ptr<ClassFieldDecl>> fields,
-                                           std::vector<std::shared_ptr<MethodDecl>> methods,
-                                           std::vector<std::shared_ptr<ConstructorDecl>> constructors,
-                                           std::vector<std::shared_ptr<DestructorDecl>> destructors) {
-        auto decl = std::shared_ptr<ClassDecl>(new ClassDecl(pos, name, fields, methods, constructors, destructors));
-        decl->set_type(std::make_shared<ClassType>(decl));
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::CLASS_DECL;
+    }
+
+    static ClassDecl* make(Position const pos,
+                           Symbol name,
+                           std::vector<ClassFieldDecl*> fields,
+                           std::vector<MethodDecl*> methods,
+                           std::vector<ConstructorDecl*> constructors,
+                           std::vector<DestructorDecl*> destructors) {
+        auto decl = make_node<ClassDecl>(pos, name, fields, methods, constructors, destructors);
+        decl->set_type(ClassType::get(decl));
         return decl;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_class_decl(shared_from_this());
+        visitor->visit_class_decl(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -442,62 +503,98 @@ class ClassDecl
 
     auto get_class_type_name() -> std::string;
 
-    auto get_index_for_field(std::string field_name) const -> int;
-    auto get_field_type(std::string field_name) const -> std::shared_ptr<Type>;
-    auto field_exists(std::string const& name) const -> bool;
-    auto method_exists(std::string const& name) const -> bool;
-    auto field_is_private(std::string const& name) const -> bool;
-    auto get_field(std::string const& name) const -> std::shared_ptr<ClassFieldDecl>;
-    auto get_method(std::shared_ptr<MethodAccessExpr> method) const -> std::optional<std::shared_ptr<MethodDecl>>;
+    auto get_index_for_field(Symbol field_name) const -> int;
+    auto get_field_type(Symbol field_name) const -> Type*;
+    auto field_exists(Symbol name) const -> bool;
+    auto method_exists(Symbol name) const -> bool;
+    auto field_is_private(Symbol name) const -> bool;
+    auto get_field(Symbol name) const -> ClassFieldDecl*;
+    auto get_method(MethodAccessExpr* method) const -> std::optional<MethodDecl*>;
 
-    auto get_fields() const -> std::vector<std::shared_ptr<ClassFieldDecl>> {
+    auto get_fields() const -> std::vector<ClassFieldDecl*> {
         return fields_;
     }
 
-    auto get_methods() const -> std::vector<std::shared_ptr<MethodDecl>> {
+    auto get_methods() const -> std::vector<MethodDecl*> {
         return methods_;
     }
 
-    auto get_constructors() const -> std::vector<std::shared_ptr<ConstructorDecl>> {
+    auto get_constructors() const -> std::vector<ConstructorDecl*> {
         return constructors_;
     }
 
-    auto get_destructors() const -> std::vector<std::shared_ptr<DestructorDecl>> {
+    auto get_destructors() const -> std::vector<DestructorDecl*> {
         return destructors_;
     }
 
+    // Members are filled in after the class is made when they refer back to it, as they do when read from an interface
+    auto set_members(std::vector<ClassFieldDecl*> fields,
+                     std::vector<MethodDecl*> methods,
+                     std::vector<ConstructorDecl*> constructors,
+                     std::vector<DestructorDecl*> destructors) -> void {
+        fields_ = std::move(fields);
+        methods_ = std::move(methods);
+        constructors_ = std::move(constructors);
+        destructors_ = std::move(destructors);
+    }
+
     auto set_has_copy_constructor(bool has_copy) -> void {
-        has_copy_constructor_ = has_copy;
+        has_copy_constructor_.store(has_copy, std::memory_order_relaxed);
     }
 
     auto has_copy_constructor() const -> bool {
-        return has_copy_constructor_;
+        return has_copy_constructor_.load(std::memory_order_relaxed);
     }
 
     auto generate_copy_constructor(std::shared_ptr<Emitter> emitter) -> void;
 
+    // The struct the emitter lays the class out as, and the copy constructor and destructor it declared for it,
+    // whether written or generated
+    auto set_llvm_type(llvm::StructType* type) -> void {
+        llvm_type_ = type;
+    }
+    auto get_llvm_type() const -> llvm::StructType* {
+        return llvm_type_;
+    }
+    auto set_llvm_copy_constructor(llvm::Function* function) -> void {
+        llvm_copy_constructor_ = function;
+    }
+    auto get_llvm_copy_constructor() const -> llvm::Function* {
+        return llvm_copy_constructor_;
+    }
+    auto set_llvm_destructor(llvm::Function* function) -> void {
+        llvm_destructor_ = function;
+    }
+    auto get_llvm_destructor() const -> llvm::Function* {
+        return llvm_destructor_;
+    }
+
  private:
-    ClassDecl(Position const pos, std::string const name)
-    : Decl(pos, name, std::make_shared<Type>()) {}
+    friend class Arena;
+    ClassDecl(Position const pos, Symbol name)
+    : Decl(NodeKind::CLASS_DECL, pos, name, Type::get()) {}
 
     ClassDecl(Position const pos,
-              std::string const name,
-              std::vector<std::shared_ptr<ClassFieldDecl>> fields,
-              std::vector<std::shared_ptr<MethodDecl>> methods,
-              std::vector<std::shared_ptr<ConstructorDecl>> constructors,
-              std::vector<std::shared_ptr<DestructorDecl>> destructors)
-    : Decl(pos, name, std::make_shared<Type>())
+              Symbol name,
+              std::vector<ClassFieldDecl*> fields,
+              std::vector<MethodDecl*> methods,
+              std::vector<ConstructorDecl*> constructors,
+              std::vector<DestructorDecl*> destructors)
+    : Decl(NodeKind::CLASS_DECL, pos, name, Type::get())
     , fields_(fields)
     , methods_(methods)
     , constructors_(constructors)
     , destructors_(destructors) {}
 
     std::string type_name_ = {};
-    std::vector<std::shared_ptr<ClassFieldDecl>> fields_;
-    std::vector<std::shared_ptr<MethodDecl>> methods_;
-    std::vector<std::shared_ptr<ConstructorDecl>> constructors_;
-    std::vector<std::shared_ptr<DestructorDecl>> destructors_;
-    bool has_copy_constructor_ = false;
+    std::vector<ClassFieldDecl*> fields_;
+    std::vector<MethodDecl*> methods_;
+    std::vector<ConstructorDecl*> constructors_;
+    std::vector<DestructorDecl*> destructors_;
+    std::atomic<bool> has_copy_constructor_ = false;
+    llvm::StructType* llvm_type_ = nullptr;
+    llvm::Function* llvm_copy_constructor_ = nullptr;
+    llvm::Function* llvm_destructor_ = nullptr;
 };
 
 #endif // DECL_HPP
\ No newline at end of file
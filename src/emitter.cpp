@@ -1,33 +1,406 @@
 #include "emitter.hpp"
 #include "handler.hpp"
+#include "interface.hpp"
 #include "module.hpp"
+#include "object_cache.hpp"
 #include "type.hpp"
 
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/MC/MCSubtargetInfo.h>
 #include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Passes/StandardInstrumentations.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Host.h>
+#include <llvm/Support/Program.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
+#include <filesystem>
 #include <iostream>
 
-auto Emitter::emit() -> void {
+auto Emitter::emit() -> bool {
+    build_ir();
+
+    // Objects are only cached per module when the IR can be split back up along module lines. It can't when the
+    // front end got it wrong, as it may not survive the trip through bitcode, nor when names clash, as what each
+    // name then refers to depends on the whole program. Either way it's generated whole, with precompiled
+    // libraries linked in, which other modules only read from their interfaces can't be. Nor can libraries whose
+    // names clash, as their own references would bind to whatever took the name
+    auto const is_cached = handler_->build_cache_mode() and !has_clash_ and !llvm::verifyModule(*llvm_module);
+    if (!is_cached and !handler_->precompile_mode()) {
+        auto const needs_bodies = llvm::any_of(*modules_, [this](Module const& module) {
+            return module.is_interface() and (has_clash_ or module.get_bitcode_path().empty());
+        });
+        if (needs_bodies) {
+            return false;
+        }
+        link_libraries();
+    }
+
+    auto target_machine = create_target_machine();
+
+    if (handler_->precompile_mode()) {
+        precompile(target_machine.get());
+        return true;
+    }
+
+    if (is_cached) {
+        return emit_cached();
+    }
+
+    // Partitions only come back together at link time, so every other kind of output is generated whole
+    auto const is_linking =
+        !handler_->llvm_mode() and !handler_->run_exe() and !handler_->is_assembly() and !handler_->object_only_mode();
+    if (is_linking and handler_->get_codegen_threads() > 1 and !llvm::verifyModule(*llvm_module)) {
+        link(emit_partitioned(handler_->get_codegen_threads()));
+        return true;
+    }
+
+    optimise(*llvm_module, target_machine.get());
+
+    if (handler_->stats_mode()) {
+        count_ir(*llvm_module);
+    }
+
+    if (handler_->llvm_mode()) {
+        auto error_code = std::error_code{};
+        auto dest = llvm::raw_fd_ostream{handler_->get_llvm_filename(), error_code};
+        llvm_module->print(dest, nullptr);
+        return true;
+    }
+
+    if (handler_->run_exe()) {
+        run_jit();
+        return true;
+    }
+
+    // Code is generated into memory, only the requested output ever touches the working directory
+    auto objects = std::vector<llvm::SmallVector<char, 0>>(1);
+    if (!emit_code(*llvm_module, target_machine.get(), objects.front())) {
+        std::cerr << "LLVM target can't emit a file of this type\n";
+        exit(EXIT_FAILURE);
+    }
+
+    if (handler_->is_assembly()) {
+        write_output(handler_->get_assembly_filename(), objects.front());
+    }
+    else if (handler_->object_only_mode()) {
+        write_output(handler_->get_object_filename(), objects.front());
+    }
+    else {
+        link(objects);
+    }
+    return true;
+}
+
+auto Emitter::emit_partitioned(unsigned num_partitions) -> std::vector<llvm::SmallVector<char, 0>> {
+    auto bitcode = std::vector<llvm::SmallVector<char, 0>>{};
+    {
+        auto const phase = handler_->stats.phase("partition");
+        llvm::SplitModule(*llvm_module, num_partitions, [&bitcode](std::unique_ptr<llvm::Module> partition) {
+            auto stream = llvm::raw_svector_ostream{bitcode.emplace_back()};
+            llvm::WriteBitcodeToFile(*partition, stream);
+        });
+    }
+    return compile_partitions(bitcode);
+}
+
+auto Emitter::emit_cached() -> bool {
+    auto cache = BuildCache{handler_->get_cache_dir() / "build"};
+
+    // Module keys cover the compiler and the sources, the target each object is generated for is all that's left
+    auto const target = target_triple_ + "\n" + target_cpu_ + "\n" + target_features_ + "\n"
+                        + std::to_string(static_cast<int>(handler_->get_opt_level()));
+    auto keys = std::vector<std::string>{};
+    for (auto const& module : *modules_) {
+        keys.push_back(BuildCache::hash(target + "\n" + module.get_cache_key()));
+    }
+
+    auto const& output = handler_->get_output_filename();
+    auto link_key = find_linker() + "\n" + output;
+    for (auto const& key : keys) {
+        link_key += "\n" + key;
+    }
+    link_key = BuildCache::hash(link_key);
+
+    auto objects = std::vector<llvm::SmallVector<char, 0>>(keys.size());
+    auto bitcode = std::vector<llvm::SmallVector<char, 0>>{};
+    auto missing = std::vector<size_t>{};
+    {
+        auto const phase = handler_->stats.phase("partition");
+        auto i = size_t{0};
+        for (auto& module : *modules_) {
+            if (auto const object = cache.get_object(keys[i])) {
+                objects[i].append(object->getBufferStart(), object->getBufferEnd());
+            }
+            else if (!module.get_bitcode_path().empty()) {
+                // A precompiled library is already bitcode
+                auto library = llvm::MemoryBuffer::getFile(module.get_bitcode_path());
+                if (!library) {
+                    return false;
+                }
+                bitcode.emplace_back().append((*library)->getBufferStart(), (*library)->getBufferEnd());
+                missing.push_back(i);
+            }
+            else if (module.is_interface()) {
+                // Evicted, or generated for another target, and only the module's source can make another
+                return false;
+            }
+            else {
+                auto partition = clone_definitions(module);
+                auto stream = llvm::raw_svector_ostream{bitcode.emplace_back()};
+                llvm::WriteBitcodeToFile(*partition, stream);
+                missing.push_back(i);
+            }
+            ++i;
+        }
+    }
+    handler_->stats.add_count("cached objects", keys.size() - missing.size());
+
+    if (missing.empty() and cache.is_linked(output, link_key)) {
+        return true;
+    }
+
+    auto compiled = compile_partitions(bitcode);
+    for (auto i = size_t{0}; i < missing.size(); ++i) {
+        cache.store_object(keys[missing[i]], compiled[i]);
+        objects[missing[i]] = std::move(compiled[i]);
+    }
+
+    link(objects);
+    cache.record_link(output, link_key);
+    return true;
+}
+
+auto Emitter::clone_definitions(Module const& module) -> std::unique_ptr<llvm::Module> {
+    auto values = llvm::ValueToValueMapTy{};
+    auto partition = llvm::CloneModule(*llvm_module, values, [this, &module](llvm::GlobalValue const* value) {
+        auto const it = definition_modules_.find(value);
+        return (it == definition_modules_.end()) ? value->hasLocalLinkage() : it->second == &module;
+    });
+    // Constants such as string literals are cloned into every partition, only kept where they're used
+    for (auto it = partition->global_begin(); it != partition->global_end();) {
+        auto& global = *it++;
+        if (global.hasLocalLinkage() and global.use_empty()) {
+            global.eraseFromParent();
+        }
+    }
+    return partition;
+}
+
+auto Emitter::precompile(llvm::TargetMachine* target_machine) -> void {
+    // The libraries this one uses are linked into programs alongside it, so only its own definitions are kept
+    auto library = clone_definitions(*main_module_);
+    optimise(*library, target_machine);
+
+    auto interface = InterfaceWriter{*modules_}.write(*main_module_);
+    if (!interface) {
+        std::cerr << "Failed to write the interface of " << main_module_->get_filepath() << "\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // The bitcode goes first, so an interface is never current without the definitions it describes
+    auto bitcode = llvm::SmallVector<char, 0>{};
+    auto stream = llvm::raw_svector_ostream{bitcode};
+    llvm::WriteBitcodeToFile(*library, stream);
+    auto const directory = std::filesystem::path{handler_->precompiled_path};
+    auto error_code = std::error_code{};
+    std::filesystem::create_directories(directory, error_code);
+    auto const path = directory / std::filesystem::path{main_module_->get_filepath()}.filename();
+    write_output(std::filesystem::path{path}.replace_extension(".bc").string(), bitcode);
+    write_output(std::filesystem::path{path}.replace_extension(".xppi").string(),
+                 llvm::ArrayRef<char>{interface->data(), interface->size()});
+}
+
+auto Emitter::link_libraries() -> void {
+    auto const has_libraries =
+        llvm::any_of(*modules_, [](Module const& module) { return !module.get_bitcode_path().empty(); });
+    if (!has_libraries) {
+        return;
+    }
+    auto const phase = handler_->stats.phase("link libraries");
+
+    // Libraries are brought together first, so they can use each other whatever order they're linked in
+    auto libraries = std::make_unique<llvm::Module>("libraries", *context);
+    auto linker = llvm::Linker{*libraries};
+    auto num_libraries = size_t{0};
+    for (auto const& module : *modules_) {
+        auto const& path = module.get_bitcode_path();
+        if (path.empty()) {
+            continue;
+        }
+        auto buffer = llvm::MemoryBuffer::getFile(path);
+        if (!buffer) {
+            std::cerr << "Failed to read " << path << ": " << buffer.getError().message() << "\n";
+            exit(EXIT_FAILURE);
+        }
+        auto library = llvm::parseBitcodeFile(**buffer, *context);
+        if (!library) {
+            std::cerr << "Failed to read " << path << ": " << llvm::toString(library.takeError()) << "\n";
+            exit(EXIT_FAILURE);
+        }
+        if (linker.linkInModule(std::move(*library))) {
+            std::cerr << "Failed to link " << path << "\n";
+            exit(EXIT_FAILURE);
+        }
+        ++num_libraries;
+    }
+
+    // Everything a library declares is forward declared, but only what the program calls is linked in, along with
+    // whatever that uses in turn. What's linked in is made internal, so the optimiser can drop it once inlined
+    for (auto it = llvm_module->begin(); it != llvm_module->end();) {
+        auto& function = *it++;
+        if (function.isDeclaration() and function.use_empty()) {
+            function.eraseFromParent();
+        }
+    }
+    for (auto it = llvm_module->global_begin(); it != llvm_module->global_end();) {
+        auto& global = *it++;
+        if (global.isDeclaration() and global.use_empty()) {
+            global.eraseFromParent();
+        }
+    }
+    auto const internalise = [](llvm::Module& module, llvm::StringSet<> const& linked) {
+        llvm::internalizeModule(module, [&linked](llvm::GlobalValue const& value) {
+            return !value.hasName() or !linked.contains(value.getName());
+        });
+    };
+    if (llvm::Linker::linkModules(*llvm_module, std::move(libraries), llvm::Linker::Flags::LinkOnlyNeeded, internalise)) {
+        std::cerr << "Failed to link the precompiled libraries\n";
+        exit(EXIT_FAILURE);
+    }
+    handler_->stats.add_count("linked libraries", num_libraries);
+}
+
+auto Emitter::compile_partitions(llvm::ArrayRef<llvm::SmallVector<char, 0>> bitcode)
+    -> std::vector<llvm::SmallVector<char, 0>> {
+    // Each partition is read back into a context of its own, so the workers share nothing. A worker only records
+    // what went wrong, exiting is left to this thread once they've all finished
+    auto objects = std::vector<llvm::SmallVector<char, 0>>(bitcode.size());
+    auto errors = std::vector<std::string>(bitcode.size());
+    auto target_machines = std::vector<std::unique_ptr<llvm::TargetMachine>>{};
+    for (auto i = size_t{0}; i < bitcode.size(); ++i) {
+        target_machines.push_back(new_target_machine());
+    }
+    auto pool = llvm::ThreadPool{llvm::hardware_concurrency(handler_->get_codegen_threads())};
+    for (auto i = size_t{0}; i < bitcode.size(); ++i) {
+        pool.async([this, &bitcode, &objects, &errors, &target_machines, i] {
+            handler_->traced([this, &bitcode, &objects, &errors, &target_machines, i] {
+                auto context = llvm::LLVMContext{};
+                auto const buffer = llvm::MemoryBufferRef{llvm::StringRef{bitcode[i].data(), bitcode[i].size()},
+                                                          "partition." + std::to_string(i)};
+                auto partition = llvm::parseBitcodeFile(buffer, context);
+                if (!partition) {
+                    errors[i] = "Failed to read back code partition: " + llvm::toString(partition.takeError());
+                    return;
+                }
+
+                optimise(**partition, target_machines[i].get());
+                if (handler_->stats_mode()) {
+                    count_ir(**partition);
+                }
+                if (!emit_code(**partition, target_machines[i].get(), objects[i])) {
+                    errors[i] = "LLVM target can't emit a file of this type";
+                }
+            });
+        });
+    }
+    pool.wait();
+    for (auto const& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << "\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+    handler_->stats.add_count("code partitions", bitcode.size());
+
+    return objects;
+}
+
+auto Emitter::emit_code(llvm::Module& module, llvm::TargetMachine* target_machine, llvm::SmallVectorImpl<char>& buffer)
+    -> bool {
+    auto const phase = handler_->stats.phase("emit");
+    auto stream = llvm::raw_svector_ostream{buffer};
+    auto pass = llvm::legacy::PassManager{};
+    auto file_type = (handler_->is_assembly()) ? llvm::CodeGenFileType::CGFT_AssemblyFile
+                                               : llvm::CodeGenFileType::CGFT_ObjectFile;
+
+    if (target_machine->addPassesToEmitFile(pass, stream, nullptr, file_type)) {
+        return false;
+    }
+    pass.run(module);
+    return true;
+}
+
+auto Emitter::build_ir() -> void {
+    auto const phase = handler_->stats.phase("codegen");
+
     // Init malloc and free
     llvm::FunctionType* malloc_type = llvm::FunctionType::get(llvm::PointerType::get(llvm::Type::getInt8Ty(*context), 0),
                                                               {llvm::Type::getInt64Ty(*context)},
                                                               false);
-    llvm::Function::Create(malloc_type, llvm::Function::ExternalLinkage, "malloc", llvm_module.get());
+    malloc_function = llvm::Function::Create(malloc_type, llvm::Function::ExternalLinkage, "malloc", llvm_module.get());
 
     llvm::FunctionType* free_type = llvm::FunctionType::get(llvm::Type::getVoidTy(*context),
                                                             {llvm::PointerType::get(llvm::Type::getInt8Ty(*context), 0)},
                                                             false);
-    llvm::Function::Create(free_type, llvm::Function::ExternalLinkage, "free", llvm_module.get());
+    free_function = llvm::Function::Create(free_type, llvm::Function::ExternalLinkage, "free", llvm_module.get());
+
+    // Cached objects are linked into every program built from their modules, not just this one, so every module but
+    // the main one is generated whole rather than only what this program happens to use. So is a library being
+    // precompiled
+    if (handler_->build_cache_mode() or handler_->precompile_mode()) {
+        for (auto& module : *modules_) {
+            if (&module == main_module_.get() and !handler_->precompile_mode()) {
+                continue;
+            }
+            for (auto& global : module.get_global_vars()) {
+                global->set_used();
+            }
+            for (auto& extern_ : module.get_externs()) {
+                extern_->set_used();
+            }
+            for (auto& function : module.get_functions()) {
+                function->set_used();
+            }
+            for (auto& class_ : module.get_classes()) {
+                class_->set_used();
+            }
+        }
+    }
+
+    // A class laid out by an earlier attempt at generating the program went with its context
+    for (auto& module : *modules_) {
+        for (auto& class_ : module.get_classes()) {
+            class_->set_llvm_type(nullptr);
+        }
+    }
+    for (auto& module : modules_->get_superseded_modules()) {
+        for (auto& class_ : module->get_classes()) {
+            class_->set_llvm_type(nullptr);
+        }
+    }
 
     // Forward declaring everything necessary
-    for (auto& module : modules_->get_modules()) {
-        for (auto& global : module->get_global_vars()) {
-            if (global->is_used()) {
+    for (auto& module : *modules_) {
+        for (auto& global : module.get_global_vars()) {
+            if (module.is_interface()) {
+                declare_global(global);
+            }
+            else if (global->is_used()) {
                 if (!global->codegen(shared_from_this())) {
                     std::cerr << "LLVM failed to generate extern\n";
                     exit(EXIT_FAILURE);
@@ -35,7 +408,7 @@ auto Emitter::emit() -> void {
             }
         }
 
-        for (auto& extern_ : module->get_externs()) {
+        for (auto& extern_ : module.get_externs()) {
             if (extern_->is_used()) {
                 if (!extern_->codegen(shared_from_this())) {
                     std::cerr << "LLVM failed to generate extern\n";
@@ -43,10 +416,11 @@ auto Emitter::emit() -> void {
                 }
             }
         }
+        claim_definitions(module);
     }
 
-    for (auto& module : modules_->get_modules()) {
-        for (auto& class_ : module->get_classes()) {
+    for (auto& module : *modules_) {
+        for (auto& class_ : module.get_classes()) {
             if (class_->is_used()) {
                 curr_class_ = class_;
                 for (auto& method : class_->get_methods()) {
@@ -64,16 +438,26 @@ auto Emitter::emit() -> void {
         }
     }
 
-    for (auto& module : modules_->get_modules()) {
-        for (auto& function : module->get_functions()) {
+    for (auto& module : *modules_) {
+        for (auto& function : module.get_functions()) {
             if (function->is_used() or function->get_ident() == "main") {
                 forward_declare_func(function);
             }
         }
     }
 
-    for (auto& module : modules_->get_modules()) {
-        for (auto& function : module->get_functions()) {
+    for (auto& module : modules_->get_superseded_modules()) {
+        adopt_declarations(*module);
+    }
+
+    for (auto& module : *modules_) {
+        // Only declared, their definitions are in the module's cached object
+        if (module.is_interface()) {
+            continue;
+        }
+        // Classes without a destructor get an empty one made for them
+        auto const arena_scope = Arena::Scope{module.get_arena()};
+        for (auto& function : module.get_functions()) {
             if (function->is_used() or function->get_ident() == "main") {
                 if (!function->codegen(shared_from_this())) {
                     std::cerr << "LLVM failed to generate function\n";
@@ -81,29 +465,179 @@ auto Emitter::emit() -> void {
                 }
             }
         }
-        for (auto& class_ : module->get_classes()) {
+        for (auto& class_ : module.get_classes()) {
             if (class_->is_used()) {
                 class_->codegen(shared_from_this());
             }
         }
+        claim_definitions(module);
     }
+}
 
-    if (handler_->llvm_mode()) {
-        auto error_code = std::error_code{};
-        auto dest = llvm::raw_fd_ostream{handler_->get_llvm_filename(), error_code};
-        llvm_module->print(dest, nullptr);
+auto Emitter::claim_definitions(Module const& module) -> void {
+    // Only the build cache and precompiling split the program back up into its modules
+    if (!handler_->build_cache_mode() and !handler_->precompile_mode()) {
         return;
     }
+    for (auto& global : llvm_module->global_values()) {
+        if (!global.isDeclaration() and !global.hasLocalLinkage()) {
+            definition_modules_.try_emplace(&global, &module);
+        }
+    }
+}
+
+auto Emitter::count_ir(llvm::Module const& module) -> void {
+    auto num_functions = size_t{0};
+    auto num_instructions = size_t{0};
+    for (auto const& function : module) {
+        if (!function.isDeclaration()) {
+            ++num_functions;
+            num_instructions += function.getInstructionCount();
+        }
+    }
+    handler_->stats.add_count("LLVM functions", num_functions);
+    handler_->stats.add_count("LLVM instructions", num_instructions);
+}
+
+auto Emitter::write_output(std::string const& filename, llvm::ArrayRef<char> contents) -> void {
+    auto error_code = std::error_code{};
+    auto dest = llvm::raw_fd_ostream{filename, error_code};
+    if (error_code) {
+        std::cerr << "Failed to open " << filename << ": " << error_code.message() << "\n";
+        exit(EXIT_FAILURE);
+    }
+    dest.write(contents.data(), contents.size());
+}
+
+auto Emitter::link(llvm::ArrayRef<llvm::SmallVector<char, 0>> objects) -> void {
+    auto const phase = handler_->stats.phase("link");
+    auto const linker = find_linker();
+
+    // A unique temporary means builds sharing a working directory never clobber each other
+    auto object_paths = std::vector<llvm::SmallString<128>>(objects.size());
+    for (auto i = size_t{0}; i < objects.size(); ++i) {
+        auto object_fd = 0;
+        if (auto error_code = llvm::sys::fs::createTemporaryFile("xpp", "o", object_fd, object_paths[i])) {
+            std::cerr << "Failed to create temporary object file: " << error_code.message() << "\n";
+            exit(EXIT_FAILURE);
+        }
+        auto dest = llvm::raw_fd_ostream{object_fd, true};
+        dest.write(objects[i].data(), objects[i].size());
+    }
+
+    auto args = std::vector<llvm::StringRef>{linker, "-no-pie"};
+    for (auto const& object_path : object_paths) {
+        args.push_back(object_path.str());
+    }
+    args.insert(args.end(), {"-o", handler_->get_output_filename()});
+    auto error = std::string{};
+    auto const status = llvm::sys::ExecuteAndWait(linker, args, {}, {}, 0, 0, &error);
+    for (auto const& object_path : object_paths) {
+        llvm::sys::fs::remove(object_path);
+    }
+
+    if (status != 0) {
+        std::cerr << "Linking with " << linker << " failed";
+        if (!error.empty()) {
+            std::cerr << ": " << error;
+        }
+        std::cerr << "\n";
+        exit(EXIT_FAILURE);
+    }
+}
+
+auto Emitter::find_linker() -> std::string {
+    auto candidates = std::vector<std::string>{"clang", "cc"};
+    if (!handler_->get_linker().empty()) {
+        candidates = {handler_->get_linker()};
+    }
+
+    for (auto const& candidate : candidates) {
+        if (auto path = llvm::sys::findProgramByName(candidate)) {
+            return *path;
+        }
+    }
 
+    std::cerr << "Failed to find a linker, tried: " << llvm::join(candidates, ", ") << "\n";
+    exit(EXIT_FAILURE);
+}
+
+auto Emitter::create_target_machine() -> std::unique_ptr<llvm::TargetMachine> {
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
     llvm::InitializeNativeTargetAsmParser();
 
-    auto target_triple = llvm::sys::getDefaultTargetTriple();
-    llvm_module->setTargetTriple(target_triple);
+    target_triple_ = llvm::sys::getDefaultTargetTriple();
+    llvm_module->setTargetTriple(target_triple_);
+
+    target_cpu_ = handler_->get_target_cpu();
+    if (target_cpu_ == "native") {
+        target_cpu_ = llvm::sys::getHostCPUName().str();
+        auto host_features = llvm::StringMap<bool>{};
+        if (llvm::sys::getHostCPUFeatures(host_features)) {
+            for (auto const& feature : host_features) {
+                target_features_ += (target_features_.empty()) ? "" : ",";
+                target_features_ += (feature.getValue()) ? "+" : "-";
+                target_features_ += feature.getKey().str();
+            }
+        }
+    }
+    // Explicit features come last so they override anything detected on the host
+    if (!handler_->get_target_features().empty()) {
+        target_features_ += (target_features_.empty()) ? "" : ",";
+        target_features_ += handler_->get_target_features();
+    }
+    check_target();
+
+    auto target_machine = new_target_machine();
+    llvm_module->setDataLayout(target_machine->createDataLayout());
+
+    // Passes such as the vectorisers consult the function attributes rather than the target machine
+    for (auto& function : *llvm_module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+        function.addFnAttr("target-cpu", target_cpu_);
+        if (!target_features_.empty()) {
+            function.addFnAttr("target-features", target_features_);
+        }
+    }
+
+    return target_machine;
+}
+
+auto Emitter::check_target() const -> void {
+    auto error = std::string{};
+    auto const target = llvm::TargetRegistry::lookupTarget(target_triple_, error);
+    if (!target) {
+        return;
+    }
+
+    // LLVM only warns about a CPU or feature it doesn't know, then generates code as if it hadn't been asked for
+    auto const subtarget =
+        std::unique_ptr<llvm::MCSubtargetInfo>{target->createMCSubtargetInfo(target_triple_, "", "")};
+    if (!subtarget->isCPUStringValid(target_cpu_)) {
+        std::cerr << "Unknown target CPU '" << target_cpu_ << "' for " << target_triple_ << "\n";
+        exit(EXIT_FAILURE);
+    }
+
+    auto features = llvm::SmallVector<llvm::StringRef>{};
+    llvm::StringRef{handler_->get_target_features()}.split(features, ',', -1, false);
+    for (auto const feature : features) {
+        auto const name = feature.drop_front();
+        auto const is_known = llvm::any_of(subtarget->getAllProcessorFeatures(), [&name](auto const& known) {
+            return name == known.Key;
+        });
+        if (!is_known) {
+            std::cerr << "Unknown target feature '" << name.str() << "' for " << target_triple_ << "\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+}
 
+auto Emitter::new_target_machine() const -> std::unique_ptr<llvm::TargetMachine> {
     auto error = std::string{};
-    auto target = llvm::TargetRegistry::lookupTarget(target_triple, error);
+    auto target = llvm::TargetRegistry::lookupTarget(target_triple_, error);
 
     if (!target) {
         std::cerr << "Failed to lookup target: " << error << "\n";
@@ -112,60 +646,166 @@ auto Emitter::emit() -> void {
 
     auto opt = llvm::TargetOptions{};
     auto reloc_model = std::optional<llvm::Reloc::Model>{};
-    auto target_machine = target->createTargetMachine(target_triple, "generic", "", opt, reloc_model);
+    auto code_model = std::optional<llvm::CodeModel::Model>{};
+    return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+        target_triple_, target_cpu_, target_features_, opt, reloc_model, code_model, codegen_opt_level()));
+}
 
-    llvm_module->setDataLayout(target_machine->createDataLayout());
+auto Emitter::codegen_opt_level() const -> llvm::CodeGenOpt::Level {
+    // -O0 keeps the backend level the compiler has always used, -Os and -Oz only shrink at the IR level
+    auto const codegen_levels = std::map<OptLevel, llvm::CodeGenOpt::Level>{{OptLevel::O0, llvm::CodeGenOpt::Default},
+                                                                            {OptLevel::O1, llvm::CodeGenOpt::Less},
+                                                                            {OptLevel::O2, llvm::CodeGenOpt::Default},
+                                                                            {OptLevel::O3, llvm::CodeGenOpt::Aggressive},
+                                                                            {OptLevel::Os, llvm::CodeGenOpt::Default},
+                                                                            {OptLevel::Oz, llvm::CodeGenOpt::Default}};
+    return codegen_levels.at(handler_->get_opt_level());
+}
 
-    auto filename = (handler_->is_assembly()) ? handler_->get_assembly_filename() : handler_->get_object_filename();
+auto Emitter::optimise(llvm::Module& module, llvm::TargetMachine* target_machine) -> void {
+    if (handler_->get_opt_level() == OptLevel::O0) {
+        return;
+    }
 
-    auto error_code = std::error_code{};
-    auto dest = llvm::raw_fd_ostream{filename, error_code};
+    auto const phase = handler_->stats.phase("optimise");
 
-    auto pass = llvm::legacy::PassManager{};
-    auto file_type = (handler_->is_assembly()) ? llvm::CodeGenFileType::CGFT_AssemblyFile
-                                               : llvm::CodeGenFileType::CGFT_ObjectFile;
+    // The pass pipeline assumes well-formed IR, so never optimise a module the front end got wrong
+    if (llvm::verifyModule(module)) {
+        if (!handler_->quiet_mode()) {
+            std::cerr << "Generated LLVM IR failed verification, skipping optimisation\n";
+        }
+        return;
+    }
 
-    target_machine->addPassesToEmitFile(pass, dest, nullptr, file_type);
-    pass.run(*llvm_module);
-    dest.flush();
+    auto const levels = std::map<OptLevel, llvm::OptimizationLevel>{{OptLevel::O1, llvm::OptimizationLevel::O1},
+                                                                     {OptLevel::O2, llvm::OptimizationLevel::O2},
+                                                                     {OptLevel::O3, llvm::OptimizationLevel::O3},
+                                                                     {OptLevel::Os, llvm::OptimizationLevel::Os},
+                                                                     {OptLevel::Oz, llvm::OptimizationLevel::Oz}};
+
+    auto lam = llvm::LoopAnalysisManager{};
+    auto fam = llvm::FunctionAnalysisManager{};
+    auto cgam = llvm::CGSCCAnalysisManager{};
+    auto mam = llvm::ModuleAnalysisManager{};
+
+    // Standard instrumentation adds a --time-trace event for every pass that runs
+    auto instrumentation_callbacks = llvm::PassInstrumentationCallbacks{};
+    auto instrumentation = llvm::StandardInstrumentations{module.getContext(), false};
+    instrumentation.registerCallbacks(instrumentation_callbacks);
+
+    auto pass_builder = llvm::PassBuilder{target_machine, llvm::PipelineTuningOptions{}, {}, &instrumentation_callbacks};
+    pass_builder.registerModuleAnalyses(mam);
+    pass_builder.registerCGSCCAnalyses(cgam);
+    pass_builder.registerFunctionAnalyses(fam);
+    pass_builder.registerLoopAnalyses(lam);
+    pass_builder.crossRegisterProxies(lam, fam, cgam, mam);
+
+    auto pass_manager = pass_builder.buildPerModuleDefaultPipeline(levels.at(handler_->get_opt_level()));
+    pass_manager.run(module, mam);
+}
 
-    if (!handler_->is_assembly()) {
-        // Compile the executable
-        auto command = std::string{"clang -no-pie "};
-        command += filename;
-        command += " -o ";
-        command += handler_->get_output_filename();
-        system(command.c_str());
-        command.clear();
-        command += "rm -f ";
-        command += handler_->get_object_filename();
-        system(command.c_str());
+auto Emitter::run_jit() -> void {
+    auto const exit_on_error = [](llvm::Error error) {
+        if (error) {
+            std::cerr << "JIT error: " << llvm::toString(std::move(error)) << "\n";
+            exit(EXIT_FAILURE);
+        }
+    };
+
+    auto jit_target_machine = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!jit_target_machine) {
+        exit_on_error(jit_target_machine.takeError());
+    }
+    jit_target_machine->setCodeGenOptLevel(codegen_opt_level());
+
+    auto cache = std::unique_ptr<DiskObjectCache>{};
+    if (handler_->jit_cache_mode()) {
+        cache = std::make_unique<DiskObjectCache>(handler_->get_cache_dir() / "jit");
+    }
+
+    auto const create_jit = [&](auto builder) -> std::unique_ptr<llvm::orc::LLJIT> {
+        builder.setJITTargetMachineBuilder(std::move(*jit_target_machine));
+        if (cache) {
+            builder.setCompileFunctionCreator(
+                [&cache](llvm::orc::JITTargetMachineBuilder jtmb)
+                    -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+                    return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb), cache.get());
+                });
+        }
+        auto jit = builder.create();
+        if (!jit) {
+            exit_on_error(jit.takeError());
+        }
+        return std::move(*jit);
+    };
+
+    // The lazy layer splits the module up through bitcode, which IR the front end got wrong can't be relied on to
+    // survive, so that is compiled whole instead
+    auto const is_lazy = !llvm::verifyModule(*llvm_module);
+    auto jit = (is_lazy) ? create_jit(llvm::orc::LLLazyJITBuilder{}) : create_jit(llvm::orc::LLJITBuilder{});
+
+    // Externs such as printf, malloc and free resolve against the compiler's own process
+    auto process_symbols =
+        llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(jit->getDataLayout().getGlobalPrefix());
+    if (!process_symbols) {
+        exit_on_error(process_symbols.takeError());
+    }
+    jit->getMainJITDylib().addGenerator(std::move(*process_symbols));
+
+    // main is verified to either take no parameters or an i32 and an i8**
+    auto const main_has_args = llvm_module->getFunction("main")->arg_size() == 2;
+
+    // Lazily, functions are only compiled the first time they are called
+    llvm_module->setDataLayout(jit->getDataLayout());
+    auto thread_safe_module = llvm::orc::ThreadSafeModule{std::move(llvm_module), std::move(context)};
+    if (is_lazy) {
+        exit_on_error(static_cast<llvm::orc::LLLazyJIT&>(*jit).addLazyIRModule(std::move(thread_safe_module)));
+    }
+    else {
+        exit_on_error(jit->addIRModule(std::move(thread_safe_module)));
+    }
+
+    auto const phase = handler_->stats.phase("jit and run");
+    auto main_symbol = jit->lookup("main");
+    if (!main_symbol) {
+        exit_on_error(main_symbol.takeError());
+    }
+
+    if (main_has_args) {
+        auto program_name = handler_->source_filename;
+        char* argv[] = {program_name.data(), nullptr};
+        auto main_function = main_symbol->toPtr<void (*)(int32_t, char**)>();
+        main_function(1, argv);
+    }
+    else {
+        auto main_function = main_symbol->toPtr<void (*)()>();
+        main_function();
+    }
+
+    std::fflush(stdout);
+}
+
+auto Emitter::storage(Decl* decl) -> llvm::Value* {
+    if (isa<GlobalVarDecl>(decl)) {
+        return globals[decl->get_local_symbol()];
     }
+    return locals[decl->get_slot()];
 }
 
-auto Emitter::llvm_type(std::shared_ptr<Type> t) -> llvm::Type* {
+auto Emitter::llvm_type(Type* t) -> llvm::Type* {
     if (t->is_pointer()) {
-        auto p_t = std::dynamic_pointer_cast<PointerType>(t);
+        auto p_t = cast<PointerType>(t);
         auto const element_type = llvm_type(p_t->get_sub_type());
         return llvm::PointerType::getUnqual(element_type);
     }
     else if (t->is_array()) {
-        auto a_t = std::dynamic_pointer_cast<ArrayType>(t);
+        auto a_t = cast<ArrayType>(t);
         auto const element_type = llvm_type(a_t->get_sub_type());
         auto const num_element = *a_t->get_length();
         return llvm::ArrayType::get(element_type, num_element);
     }
     else if (t->is_class()) {
-        auto c_t = std::dynamic_pointer_cast<ClassType>(t);
-        auto const class_name = "class." + c_t->get_ref()->get_class_type_name();
-        auto lookup = llvm::StructType::getTypeByName(*context, class_name);
-        if (lookup) {
-            return lookup;
-        }
-        else {
-            std::cout << "UNREACHABLE Emitter::llvm_type 1: " << *t << "\n";
-            return nullptr;
-        }
+        return llvm_type(cast<ClassType>(t)->get_ref());
     }
 
     switch (t->get_type_spec()) {
@@ -185,24 +825,28 @@ auto Emitter::llvm_type(std::shared_ptr<Type> t) -> llvm::Type* {
     return nullptr;
 }
 
-auto Emitter::llvm_type(std::shared_ptr<ClassDecl> t) -> llvm::Type* {
+auto Emitter::llvm_type(ClassDecl* t) -> llvm::Type* {
+    if (auto const s = t->get_llvm_type()) {
+        return s;
+    }
+    // Classes laid out alike share a struct
     auto n = "class." + t->get_class_type_name();
-    auto lookup = llvm::StructType::getTypeByName(*context, n);
-    if (lookup) {
+    if (auto const lookup = llvm::StructType::getTypeByName(*context, n)) {
+        t->set_llvm_type(lookup);
         return lookup;
     }
-    else {
-        auto s = llvm::StructType::create(*context, n);
-        auto types = std::vector<llvm::Type*>{};
-        for (auto& p : t->get_fields()) {
-            types.push_back(llvm_type(p->get_type()));
-        }
-        s->setBody(types);
-        return s;
+    // Set before the body, which may point back to the class
+    auto s = llvm::StructType::create(*context, n);
+    t->set_llvm_type(s);
+    auto types = std::vector<llvm::Type*>{};
+    for (auto& p : t->get_fields()) {
+        types.push_back(llvm_type(p->get_type()));
     }
+    s->setBody(types);
+    return s;
 }
 
-auto Emitter::forward_declare_func(std::shared_ptr<Function> function) -> void {
+auto Emitter::forward_declare_func(Function* function) -> void {
     auto return_type = llvm_type(function->get_type());
 
     // Handling params
@@ -217,12 +861,70 @@ auto Emitter::forward_declare_func(std::shared_ptr<Function> function) -> void {
     }
 
     // Instantiating function
-    auto name = function->get_ident();
-    if (name != "main") {
-        name += function->get_type_output();
-    }
     auto func_type = llvm::FunctionType::get(return_type, param_types, false);
-    llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, name, *llvm_module);
+    function->set_llvm_function(declare_function(func_type, function_name(function)));
+}
+
+auto Emitter::adopt_declarations(Module const& superseded) -> void {
+    for (auto& extern_ : superseded.get_externs()) {
+        extern_->set_llvm_function(llvm_module->getFunction(extern_->get_ident()));
+    }
+    for (auto& function : superseded.get_functions()) {
+        function->set_llvm_function(llvm_module->getFunction(function_name(function)));
+    }
+    for (auto& class_ : superseded.get_classes()) {
+        for (auto& method : class_->get_methods()) {
+            method->set_llvm_function(llvm_module->getFunction(method_name(class_, method)));
+        }
+        for (auto& constructor : class_->get_constructors()) {
+            constructor->set_llvm_function(llvm_module->getFunction(constructor_name(class_, constructor)));
+        }
+        class_->set_llvm_copy_constructor(llvm_module->getFunction("copy_constructor." + class_->get_ident()));
+        class_->set_llvm_destructor(llvm_module->getFunction("destructor." + class_->get_ident()));
+    }
+}
+
+auto Emitter::function_name(Function* function) -> std::string {
+    if (function->get_ident() == "main") {
+        return "main";
+    }
+    return function->get_ident() + function->get_type_output();
+}
+
+auto Emitter::method_name(ClassDecl* class_, MethodDecl* method) -> std::string {
+    return "method." + class_->get_ident() + method->get_ident() + method->get_type_output();
+}
+
+auto Emitter::constructor_name(ClassDecl* class_, ConstructorDecl* constructor) -> std::string {
+    auto const& paras = constructor->get_paras();
+    if (paras.size() == 1) {
+        if (auto l = dyn_cast<PointerType>(paras[0]->get_type())) {
+            if (*l->get_sub_type() == *class_->get_type()) {
+                return "copy_constructor." + class_->get_ident();
+            }
+        }
+    }
+    return "constructor." + class_->get_ident() + constructor->get_type_output();
+}
+
+auto Emitter::declare_function(llvm::FunctionType* type, std::string const& name) -> llvm::Function* {
+    auto const function = llvm::Function::Create(type, llvm::Function::ExternalLinkage, name, *llvm_module);
+    check_clash(function, name);
+    return function;
+}
+
+auto Emitter::declare_global(GlobalVarDecl* global_var) -> void {
+    // Named as GlobalVarDecl::codegen names the definition
+    auto const name =
+        global_var->get_type()->is_array() ? global_var->get_local_symbol().str() : global_var->get_ident();
+    auto const declaration = new llvm::GlobalVariable(*llvm_module,
+                                                      llvm_type(global_var->get_type()),
+                                                      false,
+                                                      llvm::GlobalValue::ExternalLinkage,
+                                                      nullptr,
+                                                      name);
+    check_clash(declaration, name);
+    globals[global_var->get_local_symbol()] = declaration;
 }
 
 auto Emitter::forward_declare_copy_constructor() -> void {
@@ -234,10 +936,10 @@ auto Emitter::forward_declare_copy_constructor() -> void {
 
     auto name = "copy_constructor." + curr_class_->get_ident();
     auto const constructor_type = llvm::FunctionType::get(return_type, param_types, false);
-    llvm::Function::Create(constructor_type, llvm::Function::ExternalLinkage, name, *llvm_module);
+    curr_class_->set_llvm_copy_constructor(declare_function(constructor_type, name));
 }
 
-auto Emitter::forward_declare_constructor(std::shared_ptr<ConstructorDecl> constructor) -> void {
+auto Emitter::forward_declare_constructor(ConstructorDecl* constructor) -> void {
     auto return_type = llvm::Type::getVoidTy(*context);
     auto param_types = std::vector<llvm::Type*>{};
 
@@ -254,29 +956,17 @@ auto Emitter::forward_declare_constructor(std::shared_ptr<ConstructorDecl> const
         }
     }
 
-    auto is_copy_constructor = false;
-    auto paras = constructor->get_paras();
-    if (paras.size() == 1) {
-        if (auto l = std::dynamic_pointer_cast<PointerType>(paras[0]->get_type())) {
-            if (*l->get_sub_type() == *curr_class_->get_type()) {
-                is_copy_constructor = true;
-            }
-        }
-    }
-
     // Instantiating function
-    auto name = std::string{};
-    if (is_copy_constructor) {
-        name = "copy_constructor." + curr_class_->get_ident();
-    }
-    else {
-        name = "constructor." + curr_class_->get_ident() + constructor->get_type_output();
-    }
+    auto const name = constructor_name(curr_class_, constructor);
     auto const constructor_type = llvm::FunctionType::get(return_type, param_types, false);
-    llvm::Function::Create(constructor_type, llvm::Function::ExternalLinkage, name, *llvm_module);
+    auto const function = declare_function(constructor_type, name);
+    constructor->set_llvm_function(function);
+    if (name == "copy_constructor." + curr_class_->get_ident()) {
+        curr_class_->set_llvm_copy_constructor(function);
+    }
 }
 
-auto Emitter::forward_declare_destructor(std::shared_ptr<ClassDecl> class_) -> void {
+auto Emitter::forward_declare_destructor(ClassDecl* class_) -> void {
     auto return_type = llvm::Type::getVoidTy(*context);
 
     auto param_types = std::vector<llvm::Type*>{};
@@ -284,10 +974,10 @@ auto Emitter::forward_declare_destructor(std::shared_ptr<ClassDecl> class_) -> v
 
     auto const name = "destructor." + class_->get_ident();
     auto const destructor_type = llvm::FunctionType::get(return_type, param_types, false);
-    llvm::Function::Create(destructor_type, llvm::Function::ExternalLinkage, name, *llvm_module);
+    class_->set_llvm_destructor(declare_function(destructor_type, name));
 }
 
-auto Emitter::forward_declare_method(std::shared_ptr<MethodDecl> method) -> void {
+auto Emitter::forward_declare_method(MethodDecl* method) -> void {
     auto return_type = llvm_type(method->get_type());
     auto param_types = std::vector<llvm::Type*>{};
 
@@ -305,7 +995,6 @@ auto Emitter::forward_declare_method(std::shared_ptr<MethodDecl> method) -> void
     }
 
     // Instantiating function
-    auto name = "method." + curr_class_->get_ident() + method->get_ident() + method->get_type_output();
     auto const method_type = llvm::FunctionType::get(return_type, param_types, false);
-    llvm::Function::Create(method_type, llvm::Function::ExternalLinkage, name, *llvm_module);
+    method->set_llvm_function(declare_function(method_type, method_name(curr_class_, method)));
 }
\ No newline at end of file
@@ -2,17 +2,22 @@
 #define EMITTER_HPP
 
 class Module;
+class Decl;
 class ClassDecl;
 class MethodDecl;
 class Function;
 class AllModules;
 class Type;
 class ConstructorDecl;
+class GlobalVarDecl;
 class Handler;
 
 #include <map>
 #include <memory>
 #include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/STLExtras.h"
@@ -25,6 +30,9 @@ class Handler;
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include "./symbol.hpp"
 
 class Emitter : public std::enable_shared_from_this<Emitter> {
  public:
@@ -37,7 +45,9 @@ class Emitter : public std::enable_shared_from_this<Emitter> {
         llvm_builder = std::make_unique<llvm::IRBuilder<>>(*context);
     }
 
-    auto emit() -> void;
+    // False when a module only read from its interface turns out to be needed in full, see ModuleGraph::load_bodies.
+    // With --precompile, writes the main module's bitcode and interface under the precompiled path instead
+    auto emit() -> bool;
 
     bool instantiating_constructor_ = false;
     size_t global_counter = 0;
@@ -45,24 +55,46 @@ class Emitter : public std::enable_shared_from_this<Emitter> {
     llvm::Value* alloca = nullptr;
     bool is_this_ = false;
 
-    std::shared_ptr<ClassDecl> curr_class_;
+    ClassDecl* curr_class_;
 
     std::unique_ptr<llvm::LLVMContext> context;
     std::unique_ptr<llvm::Module> llvm_module;
     std::unique_ptr<llvm::IRBuilder<>> llvm_builder;
-    std::map<std::string, llvm::Value*> named_values;
+    // The storage of the current function's parameters and local variables by slot, "this" taking the first in
+    // methods, constructors and destructors and "other" the second in copy constructors
+    std::vector<llvm::Value*> locals;
+    static constexpr size_t this_slot = 0;
+    static constexpr size_t other_slot = 1;
+    std::unordered_map<Symbol, llvm::Value*> globals;
+    llvm::Function* malloc_function = nullptr;
+    llvm::Function* free_function = nullptr;
+
+    // Where a parameter, local or global variable is stored
+    auto storage(Decl* decl) -> llvm::Value*;
 
     std::stack<llvm::BasicBlock*> break_blocks;
     std::stack<llvm::BasicBlock*> continue_blocks;
 
-    auto llvm_type(std::shared_ptr<Type> t) -> llvm::Type*;
-    auto llvm_type(std::shared_ptr<ClassDecl> t) -> llvm::Type*;
+    auto llvm_type(Type* t) -> llvm::Type*;
+    auto llvm_type(ClassDecl* t) -> llvm::Type*;
 
-    auto forward_declare_func(std::shared_ptr<Function> function) -> void;
-    auto forward_declare_method(std::shared_ptr<MethodDecl> method) -> void;
-    auto forward_declare_constructor(std::shared_ptr<ConstructorDecl> constructor) -> void;
+    auto forward_declare_func(Function* function) -> void;
+    auto forward_declare_method(MethodDecl* method) -> void;
+    auto forward_declare_constructor(ConstructorDecl* constructor) -> void;
     auto forward_declare_copy_constructor() -> void;
-    auto forward_declare_destructor(std::shared_ptr<ClassDecl> class_) -> void;
+    auto forward_declare_destructor(ClassDecl* class_) -> void;
+    // Points the declarations of a module replaced by its source at what was declared for their replacements
+    auto adopt_declarations(Module const& superseded) -> void;
+
+    // The names functions, methods and constructors are declared under
+    static auto function_name(Function* function) -> std::string;
+    static auto method_name(ClassDecl* class_, MethodDecl* method) -> std::string;
+    static auto constructor_name(ClassDecl* class_, ConstructorDecl* constructor) -> std::string;
+
+    // LLVM renames a global whose name is taken, after which the program can't be split back up by module
+    auto check_clash(llvm::GlobalValue const* value, llvm::StringRef name) -> void {
+        has_clash_ = has_clash_ or value->getName() != name;
+    }
 
     auto set_array_alloca(llvm::AllocaInst* a) -> void {
         array_alloca_ = a;
@@ -73,10 +105,50 @@ class Emitter : public std::enable_shared_from_this<Emitter> {
     }
 
  private:
+    auto build_ir() -> void;
+    auto count_ir(llvm::Module const& module) -> void;
+    // Sets the module up for the target and returns a machine for it
+    auto create_target_machine() -> std::unique_ptr<llvm::TargetMachine>;
+    // Exits on a CPU or explicit feature the target doesn't have
+    auto check_target() const -> void;
+    // Another machine for the same target, safe to call from any thread once create_target_machine has run
+    auto new_target_machine() const -> std::unique_ptr<llvm::TargetMachine>;
+    auto codegen_opt_level() const -> llvm::CodeGenOpt::Level;
+    auto optimise(llvm::Module& module, llvm::TargetMachine* target_machine) -> void;
+    // Records which module each definition generated so far (and not yet claimed) came from
+    auto claim_definitions(Module const& module) -> void;
+    // Splits the module in up to num_partitions, each declaring what it uses from the others
+    auto emit_partitioned(unsigned num_partitions) -> std::vector<llvm::SmallVector<char, 0>>;
+    // Links an object per module, generating only those not already in the build cache. False if one of them was
+    // only read from its interface
+    auto emit_cached() -> bool;
+    // The module's own definitions, declaring everything it uses from the other modules
+    auto clone_definitions(Module const& module) -> std::unique_ptr<llvm::Module>;
+    auto precompile(llvm::TargetMachine* target_machine) -> void;
+    // Links in what the program uses from the precompiled libraries
+    auto link_libraries() -> void;
+    auto declare_function(llvm::FunctionType* type, std::string const& name) -> llvm::Function*;
+    // Declares a global defined in a module only read from its interface
+    auto declare_global(GlobalVarDecl* global_var) -> void;
+    // Optimises and compiles each partition to an object on a thread of its own
+    auto compile_partitions(llvm::ArrayRef<llvm::SmallVector<char, 0>> bitcode) -> std::vector<llvm::SmallVector<char, 0>>;
+    // False when the target can't emit the requested kind of file
+    auto emit_code(llvm::Module& module, llvm::TargetMachine* target_machine, llvm::SmallVectorImpl<char>& buffer)
+        -> bool;
+    auto run_jit() -> void;
+    auto write_output(std::string const& filename, llvm::ArrayRef<char> contents) -> void;
+    auto link(llvm::ArrayRef<llvm::SmallVector<char, 0>> objects) -> void;
+    auto find_linker() -> std::string;
+
     std::shared_ptr<AllModules> modules_;
     llvm::AllocaInst* array_alloca_;
     std::shared_ptr<Module> main_module_;
     std::shared_ptr<Handler> handler_;
+    std::string target_triple_ = {};
+    std::string target_cpu_ = {};
+    std::string target_features_ = {};
+    std::unordered_map<llvm::GlobalValue const*, Module const*> definition_modules_ = {};
+    bool has_clash_ = false;
 };
 
 #endif // EMITTER_HPP
\ No newline at end of file
@@ -56,10 +56,10 @@ auto AssignmentExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     auto const is_pointer = get_type()->is_pointer();
 
     llvm::Value* ptr = nullptr;
-    if (auto const& lhs = std::dynamic_pointer_cast<VarExpr>(left_)) {
-        auto is_field_access = std::dynamic_pointer_cast<ClassFieldDecl>(lhs->get_ref());
+    if (auto const& lhs = dyn_cast<VarExpr>(left_)) {
+        auto is_field_access = dyn_cast<ClassFieldDecl>(lhs->get_ref());
         if (is_field_access) {
-            auto const t = emitter->named_values["this"];
+            auto const t = emitter->locals[Emitter::this_slot];
             auto const class_type = emitter->llvm_type(emitter->curr_class_);
             auto this_ptr = emitter->llvm_builder->CreateLoad(llvm::PointerType::getUnqual(class_type), t);
             ptr = emitter->llvm_builder->CreateStructGEP(
@@ -68,17 +68,17 @@ auto AssignmentExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
                 emitter->curr_class_->get_index_for_field(is_field_access->get_ident()));
         }
         else {
-            ptr = emitter->named_values[lhs->get_name() + lhs->get_ref()->get_append()];
+            ptr = emitter->storage(lhs->get_ref());
         }
     }
-    else if (auto const& lhs = std::dynamic_pointer_cast<UnaryExpr>(left_)) {
+    else if (auto const& lhs = dyn_cast<UnaryExpr>(left_)) {
         ptr = lhs->get_expr()->codegen(emitter);
     }
-    else if (auto const& lhs = std::dynamic_pointer_cast<ArrayIndexExpr>(left_)) {
+    else if (auto const& lhs = dyn_cast<ArrayIndexExpr>(left_)) {
         ptr = lhs->codegen(emitter);
     }
-    else if (auto const& lhs = std::dynamic_pointer_cast<FieldAccessExpr>(left_)) {
-        if (auto l = std::dynamic_pointer_cast<VarExpr>(lhs->get_class_instance())) {
+    else if (auto const& lhs = dyn_cast<FieldAccessExpr>(left_)) {
+        if (auto l = dyn_cast<VarExpr>(lhs->get_class_instance())) {
             emitter->is_this_ = l->get_name() == "this";
         }
         auto const class_instance = lhs->get_class_instance()->codegen(emitter);
@@ -103,7 +103,7 @@ auto AssignmentExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
                 auto const zero = llvm::ConstantInt::get(rhs->getType(), 0);
                 index = emitter->llvm_builder->CreateSub(zero, rhs);
             }
-            auto p_t = std::dynamic_pointer_cast<PointerType>(left_->get_type());
+            auto p_t = cast<PointerType>(left_->get_type());
             auto inner_type = emitter->llvm_type(p_t->get_sub_type());
             result = emitter->llvm_builder->CreateGEP(inner_type, loaded_ptr, index);
         }
@@ -179,7 +179,7 @@ auto BinaryExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     }
     case Op::PLUS: {
         if (is_pointer_arithmetic_) {
-            auto p_t = std::dynamic_pointer_cast<PointerType>(left_->get_type());
+            auto p_t = cast<PointerType>(left_->get_type());
             auto inner_type = p_t->get_sub_type();
             return emitter->llvm_builder->CreateInBoundsGEP(emitter->llvm_type(inner_type), l, r);
         }
@@ -188,7 +188,7 @@ auto BinaryExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     case Op::MINUS: {
         if (is_pointer_arithmetic_) {
             auto neg = emitter->llvm_builder->CreateNeg(r);
-            auto p_t = std::dynamic_pointer_cast<PointerType>(left_->get_type());
+            auto p_t = cast<PointerType>(left_->get_type());
             auto inner_type = p_t->get_sub_type();
             return emitter->llvm_builder->CreateInBoundsGEP(emitter->llvm_type(inner_type), l, neg);
         }
@@ -269,11 +269,11 @@ auto BinaryExpr::print(std::ostream& os) const -> void {
 
 auto UnaryExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     if (op_ == Op::ADDRESS_OF) {
-        auto var_e = std::dynamic_pointer_cast<VarExpr>(expr_);
+        auto var_e = dyn_cast<VarExpr>(expr_);
         if (var_e) {
-            return emitter->named_values[var_e->get_name() + var_e->get_ref()->get_append()];
+            return emitter->storage(var_e->get_ref());
         }
-        auto index_e = std::dynamic_pointer_cast<ArrayIndexExpr>(expr_);
+        auto index_e = dyn_cast<ArrayIndexExpr>(expr_);
         if (index_e) {
             return index_e->codegen(emitter);
         }
@@ -291,10 +291,10 @@ auto UnaryExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     auto const decimal_one = llvm::ConstantFP::get(*(emitter->context), llvm::APFloat(1.0));
 
     llvm::Value* ptr = nullptr;
-    if (auto l = std::dynamic_pointer_cast<VarExpr>(expr_)) {
-        auto is_field_access = std::dynamic_pointer_cast<ClassFieldDecl>(l->get_ref());
+    if (auto l = dyn_cast<VarExpr>(expr_)) {
+        auto is_field_access = dyn_cast<ClassFieldDecl>(l->get_ref());
         if (is_field_access) {
-            auto const t = emitter->named_values["this"];
+            auto const t = emitter->locals[Emitter::this_slot];
             auto const class_type = emitter->llvm_type(emitter->curr_class_);
             auto this_ptr = emitter->llvm_builder->CreateLoad(llvm::PointerType::getUnqual(class_type), t);
             ptr = emitter->llvm_builder->CreateStructGEP(
@@ -303,10 +303,10 @@ auto UnaryExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
                 emitter->curr_class_->get_index_for_field(is_field_access->get_ident()));
         }
         else {
-            ptr = emitter->named_values[l->get_name() + l->get_ref()->get_append()];
+            ptr = emitter->storage(l->get_ref());
         }
     }
-    else if (auto l = std::dynamic_pointer_cast<UnaryExpr>(expr_)) {
+    else if (auto l = dyn_cast<UnaryExpr>(expr_)) {
         ptr = l->get_expr()->codegen(emitter);
     }
 
@@ -315,7 +315,7 @@ auto UnaryExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
         if (is_pointer) {
             auto const index =
                 llvm::ConstantInt::get(llvm::Type::getInt32Ty(*(emitter->context)), (op_ == Op::PREFIX_ADD) ? 1 : -1);
-            auto const p_t = std::dynamic_pointer_cast<PointerType>(expr_->get_type());
+            auto const p_t = cast<PointerType>(expr_->get_type());
             auto const inner_type = p_t->get_sub_type();
             new_val = emitter->llvm_builder->CreateGEP(emitter->llvm_type(inner_type), value, index);
         }
@@ -335,7 +335,7 @@ auto UnaryExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
         if (is_pointer) {
             auto const index =
                 llvm::ConstantInt::get(llvm::Type::getInt32Ty(*(emitter->context)), (op_ == Op::POSTFIX_ADD) ? 1 : -1);
-            auto const p_t = std::dynamic_pointer_cast<PointerType>(expr_->get_type());
+            auto const p_t = cast<PointerType>(expr_->get_type());
             auto const inner_type = p_t->get_sub_type();
             new_val = emitter->llvm_builder->CreateGEP(emitter->llvm_type(inner_type), value, index);
         }
@@ -473,16 +473,16 @@ auto CharExpr::print(std::ostream& os) const -> void {
 }
 
 auto VarExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    auto is_field_access = std::dynamic_pointer_cast<ClassFieldDecl>(get_ref());
+    auto is_field_access = dyn_cast<ClassFieldDecl>(get_ref());
     if (emitter->is_this_ and !is_field_access) {
-        auto this_ = emitter->named_values["this"];
+        auto this_ = emitter->locals[Emitter::this_slot];
         auto t = emitter->llvm_type(get_type());
         return emitter->llvm_builder->CreateLoad(t, this_);
     }
     else if (is_field_access) {
         assert(emitter->curr_class_ != nullptr);
         auto const field_index = emitter->curr_class_->get_index_for_field(is_field_access->get_ident());
-        auto const this_ptr = emitter->named_values["this"];
+        auto const this_ptr = emitter->locals[Emitter::this_slot];
         auto const class_type = emitter->llvm_type(emitter->curr_class_);
 
         auto const this_pointer = emitter->llvm_builder->CreateLoad(llvm::PointerType::getUnqual(class_type), this_ptr);
@@ -490,12 +490,12 @@ auto VarExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
         return emitter->llvm_builder->CreateLoad(emitter->llvm_type(get_type()), val);
     }
 
-    auto const ptr = emitter->named_values[name_ + get_ref()->get_append()];
+    auto const ptr = emitter->storage(get_ref());
     if (get_type()->is_class() or get_type()->is_array()) {
         return ptr;
     }
     else {
-        return emitter->llvm_builder->CreateLoad(emitter->llvm_type(get_type()), ptr, name_);
+        return emitter->llvm_builder->CreateLoad(emitter->llvm_type(get_type()), ptr, name_.str());
     }
 }
 
@@ -574,25 +574,18 @@ auto BinaryExpr::handle_logical_or(std::shared_ptr<Emitter> emitter) -> llvm::Va
 }
 
 auto CallExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    auto name = std::string{};
-    if (auto l = std::dynamic_pointer_cast<Function>(ref_)) {
-        name = l->get_ident() + l->get_type_output();
-    }
-    else {
-        name = name_;
-    }
-    auto callee = emitter->llvm_module->getFunction(name);
+    auto callee = ref_->get_llvm_function();
     if (!callee) {
-        std::cout << "UNREACHABLE CallExpr::codegen, function not found: " << name << "\n";
+        std::cout << "UNREACHABLE CallExpr::codegen, function not declared: " << name_ << "\n";
         return nullptr;
     }
 
     auto arg_vals = std::vector<llvm::Value*>{};
-    std::shared_ptr<Expr> v = nullptr;
+    Expr* v = nullptr;
     llvm::Value* real_v = nullptr;
     for (auto& arg : args_) {
         auto val = arg->codegen(emitter);
-        auto l = std::dynamic_pointer_cast<VarExpr>(arg);
+        auto l = dyn_cast<VarExpr>(arg);
         if (arg->get_type()->is_class() and !l) {
             real_v = val;
             v = arg;
@@ -601,9 +594,8 @@ auto CallExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     }
     auto res = emitter->llvm_builder->CreateCall(callee, arg_vals);
     if (v) {
-        auto class_type = std::dynamic_pointer_cast<ClassType>(v->get_type());
-        auto destructor = emitter->llvm_module->getFunction("destructor." + class_type->get_ref()->get_ident());
-        emitter->llvm_builder->CreateCall(destructor, {real_v});
+        auto class_type = cast<ClassType>(v->get_type());
+        emitter->llvm_builder->CreateCall(class_type->get_ref()->get_llvm_destructor(), {real_v});
     }
     return res;
 }
@@ -621,10 +613,10 @@ auto CallExpr::print(std::ostream& os) const -> void {
 }
 
 auto ConstructorCallExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    auto constructor_ref = std::dynamic_pointer_cast<ConstructorDecl>(ref_);
+    auto constructor_ref = dyn_cast<ConstructorDecl>(ref_);
     if (!constructor_ref) {
         // Assume it's a default copy constructor call
-        auto callee = emitter->llvm_module->getFunction("copy_constructor." + name_);
+        auto callee = cast<ClassType>(get_type())->get_ref()->get_llvm_copy_constructor();
         auto arg_vals = std::vector<llvm::Value*>{};
         arg_vals.push_back(emitter->alloca);
         for (auto& arg : args_) {
@@ -634,28 +626,11 @@ auto ConstructorCallExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Val
         return emitter->llvm_builder->CreateCall(callee, arg_vals);
     }
 
-    auto is_copy_constructor = false;
-    if (args_.size() == 1) {
-        if (auto l = std::dynamic_pointer_cast<PointerType>(args_[0]->get_type())) {
-            if (*l->get_sub_type() == *emitter->curr_class_->get_type()) {
-                is_copy_constructor = true;
-            }
-        }
-    }
-
-    auto name = std::string{};
-    if (is_copy_constructor) {
-        name = "copy_constructor." + constructor_ref->get_ident();
-    }
-    else {
-        name = "constructor." + constructor_ref->get_ident() + constructor_ref->get_type_output();
-    }
-
-    auto callee = emitter->llvm_module->getFunction(name);
+    auto callee = constructor_ref->get_llvm_function();
 
     llvm::Value* class_ptr;
-    if (emitter->instantiating_constructor_ and name_ == emitter->curr_class_->get_ident()) {
-        auto val = emitter->llvm_builder->CreateLoad(emitter->llvm_type(get_type()), emitter->named_values["this"]);
+    if (emitter->instantiating_constructor_ and name_ == emitter->curr_class_->get_symbol()) {
+        auto val = emitter->llvm_builder->CreateLoad(emitter->llvm_type(get_type()), emitter->locals[Emitter::this_slot]);
         auto arg_vals = std::vector<llvm::Value*>{};
         arg_vals.push_back(val);
         for (auto& arg : args_) {
@@ -776,7 +751,7 @@ auto CastExpr::print(std::ostream& os) const -> void {
 
 // Assume this is NOT for GlobalVariableDecl (handled there)
 auto ArrayInitExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    auto const array_t = std::dynamic_pointer_cast<ArrayType>(get_type());
+    auto const array_t = dyn_cast<ArrayType>(get_type());
     if (!array_t)
         return nullptr;
 
@@ -832,19 +807,19 @@ auto ArrayIndexExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     auto const elem_type = emitter->llvm_type(get_type());
     auto const zero = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*emitter->context), 0);
 
-    llvm::Value* gep_ptr;
-    if (auto l = std::dynamic_pointer_cast<ArrayType>(array_expr_->get_type())) {
+    llvm::Value* gep_ptr = nullptr;
+    if (auto l = dyn_cast<ArrayType>(array_expr_->get_type())) {
         llvm::Value* indices[] = {zero, index_val};
         gep_ptr = emitter->llvm_builder->CreateInBoundsGEP(emitter->llvm_type(l), base_ptr, indices);
     }
-    else if (auto l2 = std::dynamic_pointer_cast<PointerType>(array_expr_->get_type())) {
+    else if (dyn_cast<PointerType>(array_expr_->get_type())) {
         gep_ptr = emitter->llvm_builder->CreateInBoundsGEP(elem_type, base_ptr, index_val);
     }
     else {
         std::cout << "UNREACHABLE ArrayIndexExpr::codegen\n";
     }
 
-    auto v = std::dynamic_pointer_cast<UnaryExpr>(get_parent());
+    auto v = dyn_cast<UnaryExpr>(get_parent());
     if (v) {
         if (v->get_operator() == Op::ADDRESS_OF) {
             return gep_ptr;
@@ -854,7 +829,7 @@ auto ArrayIndexExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
         }
     }
 
-    if (auto l = std::dynamic_pointer_cast<AssignmentExpr>(get_parent())) {
+    if (dyn_cast<AssignmentExpr>(get_parent())) {
         return gep_ptr;
     }
     else {
@@ -878,7 +853,7 @@ auto EnumAccessExpr::print(std::ostream& os) const -> void {
 }
 
 auto FieldAccessExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    if (auto l = std::dynamic_pointer_cast<VarExpr>(class_instance_)) {
+    if (auto l = dyn_cast<VarExpr>(class_instance_)) {
         emitter->is_this_ = l->get_name() == "this";
     }
     auto class_val = class_instance_->codegen(emitter);
@@ -897,14 +872,13 @@ auto FieldAccessExpr::print(std::ostream& os) const -> void {
 
 auto MethodAccessExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     // First field in the method call
-    if (auto l = std::dynamic_pointer_cast<VarExpr>(class_instance_)) {
+    if (auto l = dyn_cast<VarExpr>(class_instance_)) {
         emitter->is_this_ = l->get_name() == "this";
     }
     auto class_val = class_instance_->codegen(emitter);
     emitter->is_this_ = false;
 
-    auto name = "method." + ref_->get_class_ref()->get_ident() + method_name_ + ref_->get_type_output();
-    auto function = emitter->llvm_module->getFunction(name);
+    auto function = ref_->get_llvm_function();
     assert(function != nullptr);
 
     auto arg_vals = std::vector<llvm::Value*>{};
@@ -966,7 +940,7 @@ auto NewExpr::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
 
     auto const t = emitter->llvm_type(new_type_);
     auto const size = data_layout.getTypeAllocSize(t);
-    auto const malloc_func = emitter->llvm_module->getFunction("malloc");
+    auto const malloc_func = emitter->malloc_function;
 
     if (!call_expr_ and !array_size_args_.has_value()) {
         auto size_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*emitter->context), size);
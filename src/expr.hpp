@@ -41,15 +41,19 @@ auto operator<<(std::ostream& os, Op const& o) -> std::ostream&;
 
 class Expr : public AST {
  public:
-    Expr(Position pos, std::shared_ptr<Type> t)
-    : AST(pos)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() >= NodeKind::EMPTY_EXPR and node->get_kind() <= NodeKind::NEW_EXPR;
+    }
+
+    Expr(NodeKind kind, Position pos, Type* t)
+    : AST(kind, pos)
     , t_(t) {}
 
-    auto get_type() const -> std::shared_ptr<Type> const& {
+    auto get_type() const -> Type* const& {
         return t_;
     }
 
-    auto set_type(std::shared_ptr<Type> t) -> void {
+    auto set_type(Type* t) -> void {
         t_ = t;
     }
 
@@ -59,86 +63,92 @@ class Expr : public AST {
     auto print(std::ostream& os) const -> void override = 0;
 
  private:
-    std::shared_ptr<Type> t_;
+    Type* t_;
 };
 
-class EmptyExpr
-: public Expr
-, public std::enable_shared_from_this<EmptyExpr> {
+class EmptyExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::EMPTY_EXPR;
+    }
+
     EmptyExpr(Position pos)
-    : Expr(pos, std::make_shared<Type>(TypeSpec::VOID)) {}
+    : Expr(NodeKind::EMPTY_EXPR, pos, Type::get(TypeSpec::VOID)) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_empty_expr(shared_from_this());
+        visitor->visit_empty_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 };
 
-class AssignmentExpr
-: public Expr
-, public std::enable_shared_from_this<AssignmentExpr> {
+class AssignmentExpr : public Expr {
  public:
-    AssignmentExpr(Position pos, std::shared_ptr<Expr> left, Op const op, std::shared_ptr<Expr> right)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::ASSIGNMENT_EXPR;
+    }
+
+    AssignmentExpr(Position pos, Expr* left, Op const op, Expr* right)
+    : Expr(NodeKind::ASSIGNMENT_EXPR, pos, Type::get())
     , left_(left)
     , op_(op)
     , right_(right) {}
 
-    auto get_left() const -> std::shared_ptr<Expr> {
+    auto get_left() const -> Expr* {
         return left_;
     }
-    auto get_right() const -> std::shared_ptr<Expr> {
+    auto get_right() const -> Expr* {
         return right_;
     }
     auto get_operator() const -> Op {
         return op_;
     }
 
-    auto set_rhs_expression(std::shared_ptr<Expr> expr) -> void {
+    auto set_rhs_expression(Expr* expr) -> void {
         right_ = expr;
     }
-    auto set_lhs_expression(std::shared_ptr<Expr> expr) -> void {
+    auto set_lhs_expression(Expr* expr) -> void {
         left_ = expr;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_assignment_expr(shared_from_this());
+        visitor->visit_assignment_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Expr> left_;
+    Expr* left_;
     Op const op_;
-    std::shared_ptr<Expr> right_;
+    Expr* right_;
 };
 
-class BinaryExpr
-: public Expr
-, public std::enable_shared_from_this<BinaryExpr> {
+class BinaryExpr : public Expr {
  public:
-    BinaryExpr(Position const pos, std::shared_ptr<Expr> left, Op const op, std::shared_ptr<Expr> right)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::BINARY_EXPR;
+    }
+
+    BinaryExpr(Position const pos, Expr* left, Op const op, Expr* right)
+    : Expr(NodeKind::BINARY_EXPR, pos, Type::get())
     , left_(left)
     , op_(op)
     , right_(right) {}
 
-    auto get_left() const -> std::shared_ptr<Expr> {
+    auto get_left() const -> Expr* {
         return left_;
     }
-    auto get_right() const -> std::shared_ptr<Expr> {
+    auto get_right() const -> Expr* {
         return right_;
     }
     auto get_operator() const -> Op {
         return op_;
     }
 
-    auto set_l_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_l_expr(Expr* expr) -> void {
         left_ = expr;
     }
-    auto set_r_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_r_expr(Expr* expr) -> void {
         right_ = expr;
     }
 
@@ -151,34 +161,36 @@ class BinaryExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_binary_expr(shared_from_this());
+        visitor->visit_binary_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Expr> left_;
+    Expr* left_;
     Op const op_;
-    std::shared_ptr<Expr> right_;
+    Expr* right_;
     bool is_pointer_arithmetic_ = false;
 
     auto handle_logical_or(std::shared_ptr<Emitter> emitter) -> llvm::Value*;
     auto handle_logical_and(std::shared_ptr<Emitter> emitter) -> llvm::Value*;
 };
 
-class UnaryExpr
-: public Expr
-, public std::enable_shared_from_this<UnaryExpr> {
+class UnaryExpr : public Expr {
  public:
-    UnaryExpr(Position const pos, Op const op, std::shared_ptr<Expr> expr)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::UNARY_EXPR;
+    }
+
+    UnaryExpr(Position const pos, Op const op, Expr* expr)
+    : Expr(NodeKind::UNARY_EXPR, pos, Type::get())
     , op_(op)
     , expr_(expr) {}
 
-    auto set_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr(Expr* expr) -> void {
         expr_ = expr;
     }
-    auto get_expr() const -> std::shared_ptr<Expr> {
+    auto get_expr() const -> Expr* {
         return expr_;
     }
     auto get_operator() const -> Op {
@@ -186,36 +198,40 @@ class UnaryExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_unary_expr(shared_from_this());
+        visitor->visit_unary_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
     Op const op_;
-    std::shared_ptr<Expr> expr_;
+    Expr* expr_;
 };
 
-class NullExpr
-: public Expr
-, public std::enable_shared_from_this<NullExpr> {
+class NullExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::NULL_EXPR;
+    }
+
     NullExpr(Position const pos)
-    : Expr(pos, std::make_shared<PointerType>(std::make_shared<Type>(TypeSpec::VOID))) {}
+    : Expr(NodeKind::NULL_EXPR, pos, PointerType::get(Type::get(TypeSpec::VOID))) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_null_expr(shared_from_this());
+        visitor->visit_null_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 };
 
-class IntExpr
-: public Expr
-, public std::enable_shared_from_this<IntExpr> {
+class IntExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::INT_EXPR;
+    }
+
     IntExpr(Position const pos, int64_t value)
-    : Expr(pos, std::make_shared<Type>(TypeSpec::I64))
+    : Expr(NodeKind::INT_EXPR, pos, Type::get(TypeSpec::I64))
     , value_(value) {}
 
     auto get_value() const -> int64_t {
@@ -231,7 +247,7 @@ class IntExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_int_expr(shared_from_this());
+        visitor->visit_int_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -241,12 +257,14 @@ class IntExpr
     uint8_t width_ = 64;
 };
 
-class UIntExpr
-: public Expr
-, public std::enable_shared_from_this<UIntExpr> {
+class UIntExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::UINT_EXPR;
+    }
+
     UIntExpr(Position const pos, uint64_t value)
-    : Expr(pos, std::make_shared<Type>(TypeSpec::U64))
+    : Expr(NodeKind::UINT_EXPR, pos, Type::get(TypeSpec::U64))
     , value_(value) {}
 
     auto get_value() const -> uint64_t {
@@ -262,7 +280,7 @@ class UIntExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_uint_expr(shared_from_this());
+        visitor->visit_uint_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -272,12 +290,14 @@ class UIntExpr
     uint8_t width_ = 64;
 };
 
-class DecimalExpr
-: public Expr
-, public std::enable_shared_from_this<DecimalExpr> {
+class DecimalExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::DECIMAL_EXPR;
+    }
+
     DecimalExpr(Position const pos, double value)
-    : Expr(pos, std::make_shared<Type>(TypeSpec::F64))
+    : Expr(NodeKind::DECIMAL_EXPR, pos, Type::get(TypeSpec::F64))
     , value_(value) {}
 
     auto get_value() const -> double {
@@ -293,7 +313,7 @@ class DecimalExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_decimal_expr(shared_from_this());
+        visitor->visit_decimal_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -303,12 +323,14 @@ class DecimalExpr
     uint8_t width_ = 64;
 };
 
-class BoolExpr
-: public Expr
-, public std::enable_shared_from_this<BoolExpr> {
+class BoolExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::BOOL_EXPR;
+    }
+
     BoolExpr(Position const pos, bool value)
-    : Expr(pos, std::make_shared<Type>(TypeSpec::BOOL))
+    : Expr(NodeKind::BOOL_EXPR, pos, Type::get(TypeSpec::BOOL))
     , value_(value) {}
 
     auto get_value() const -> bool {
@@ -316,7 +338,7 @@ class BoolExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_bool_expr(shared_from_this());
+        visitor->visit_bool_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -325,12 +347,14 @@ class BoolExpr
     bool const value_;
 };
 
-class StringExpr
-: public Expr
-, public std::enable_shared_from_this<StringExpr> {
+class StringExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::STRING_EXPR;
+    }
+
     StringExpr(Position const pos, std::string value)
-    : Expr(pos, std::make_shared<PointerType>(std::make_shared<Type>(TypeSpec::I8)))
+    : Expr(NodeKind::STRING_EXPR, pos, PointerType::get(Type::get(TypeSpec::I8)))
     , value_(value) {}
 
     auto get_value() const -> std::string {
@@ -338,7 +362,7 @@ class StringExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_string_expr(shared_from_this());
+        visitor->visit_string_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -347,12 +371,14 @@ class StringExpr
     std::string const value_;
 };
 
-class CharExpr
-: public Expr
-, public std::enable_shared_from_this<CharExpr> {
+class CharExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::CHAR_EXPR;
+    }
+
     CharExpr(Position const pos, char const value)
-    : Expr(pos, std::make_shared<Type>(TypeSpec::I8))
+    : Expr(NodeKind::CHAR_EXPR, pos, Type::get(TypeSpec::I8))
     , value_(value) {}
 
     auto get_value() const -> char {
@@ -360,7 +386,7 @@ class CharExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_char_expr(shared_from_this());
+        visitor->visit_char_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -369,234 +395,255 @@ class CharExpr
     char const value_;
 };
 
-class VarExpr
-: public Expr
-, public std::enable_shared_from_this<VarExpr> {
+class VarExpr : public Expr {
  public:
-    VarExpr(Position pos, std::string name, std::shared_ptr<Type> t)
-    : Expr(pos, t)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::VAR_EXPR;
+    }
+
+    VarExpr(Position pos, std::string name, Type* t)
+    : Expr(NodeKind::VAR_EXPR, pos, t)
     , name_(name) {}
 
-    VarExpr(Position const pos, std::string const name)
-    : Expr(pos, std::make_shared<Type>())
+    VarExpr(Position const pos, Symbol const name)
+    : Expr(NodeKind::VAR_EXPR, pos, Type::get())
     , name_(name) {}
 
     auto get_name() const -> std::string const& {
+        return name_.str();
+    }
+
+    auto get_symbol() const -> Symbol {
         return name_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_var_expr(shared_from_this());
+        visitor->visit_var_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto set_ref(std::shared_ptr<Decl> ref) -> void {
+    auto set_ref(Decl* ref) -> void {
         ref_ = ref;
     }
 
-    auto get_ref() -> std::shared_ptr<Decl> {
+    auto get_ref() -> Decl* {
         return ref_;
     }
 
  private:
-    std::string const name_;
-    std::shared_ptr<Decl> ref_ = nullptr;
+    Symbol const name_;
+    Decl* ref_ = nullptr;
 };
 
-class CallExpr
-: public Expr
-, public std::enable_shared_from_this<CallExpr> {
+class CallExpr : public Expr {
  public:
-    CallExpr(Position const pos, std::string const name, std::vector<std::shared_ptr<Expr>> args)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::CALL_EXPR;
+    }
+
+    CallExpr(Position const pos, Symbol const name, std::vector<Expr*> args)
+    : Expr(NodeKind::CALL_EXPR, pos, Type::get())
     , name_(name)
     , args_(args) {}
 
-    CallExpr(Position const pos,
-             std::string const name,
-             std::shared_ptr<Type> t,
-             std::vector<std::shared_ptr<Expr>> const args)
-    : Expr(pos, t)
+    CallExpr(Position const pos, Symbol const name, Type* t, std::vector<Expr*> const args)
+    : Expr(NodeKind::CALL_EXPR, pos, t)
     , name_(name)
     , args_(args) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_call_expr(shared_from_this());
+        visitor->visit_call_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto get_name() const -> std::string {
+    auto get_name() const -> std::string const& {
+        return name_.str();
+    }
+
+    auto get_symbol() const -> Symbol {
         return name_;
     }
 
-    auto set_ref(std::shared_ptr<Decl> ref) -> void {
+    auto set_ref(Decl* ref) -> void {
         ref_ = ref;
     }
 
-    auto get_ref() const -> std::shared_ptr<Decl> {
+    auto get_ref() const -> Decl* {
         return ref_;
     }
 
-    auto get_args() -> std::vector<std::shared_ptr<Expr>> {
+    auto get_args() -> std::vector<Expr*> {
         return args_;
     }
 
-    auto set_args(std::vector<std::shared_ptr<Expr>> args) -> void {
+    auto set_args(std::vector<Expr*> args) -> void {
         args_ = std::move(args);
     }
 
  private:
-    std::string const name_;
-    std::vector<std::shared_ptr<Expr>> args_;
-    std::shared_ptr<Decl> ref_ = nullptr;
+    Symbol const name_;
+    std::vector<Expr*> args_;
+    Decl* ref_ = nullptr;
 };
 
-class ConstructorCallExpr
-: public Expr
-, public std::enable_shared_from_this<ConstructorCallExpr> {
+class ConstructorCallExpr : public Expr {
  public:
-    ConstructorCallExpr(Position const pos, std::string const name, std::vector<std::shared_ptr<Expr>> const args)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::CONSTRUCTOR_CALL_EXPR;
+    }
+
+    ConstructorCallExpr(Position const pos, Symbol const name, std::vector<Expr*> const args)
+    : Expr(NodeKind::CONSTRUCTOR_CALL_EXPR, pos, Type::get())
     , name_(name)
     , args_(args) {}
 
-    ConstructorCallExpr(Position const pos,
-                        std::shared_ptr<Type> t,
-                        std::string const name,
-                        std::vector<std::shared_ptr<Expr>> const args)
-    : Expr(pos, t)
+    ConstructorCallExpr(Position const pos, Type* t, Symbol const name, std::vector<Expr*> const args)
+    : Expr(NodeKind::CONSTRUCTOR_CALL_EXPR, pos, t)
     , name_(name)
     , args_(args) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_constructor_call_expr(shared_from_this());
+        visitor->visit_constructor_call_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto get_name() const -> std::string {
+    auto get_name() const -> std::string const& {
+        return name_.str();
+    }
+
+    auto get_symbol() const -> Symbol {
         return name_;
     }
 
-    auto set_ref(std::shared_ptr<Decl> ref) -> void {
+    auto set_ref(Decl* ref) -> void {
         ref_ = ref;
     }
 
-    auto get_ref() const -> std::shared_ptr<Decl> {
+    auto get_ref() const -> Decl* {
         return ref_;
     }
 
-    auto get_args() -> std::vector<std::shared_ptr<Expr>> {
+    auto get_args() -> std::vector<Expr*> {
         return args_;
     }
 
  private:
-    std::string const name_;
-    std::vector<std::shared_ptr<Expr>> const args_;
-    std::shared_ptr<Decl> ref_ = nullptr;
+    Symbol const name_;
+    std::vector<Expr*> const args_;
+    Decl* ref_ = nullptr;
 };
 
-class CastExpr
-: public Expr
-, public std::enable_shared_from_this<CastExpr> {
+class CastExpr : public Expr {
  public:
-    CastExpr(Position const pos, std::shared_ptr<Expr> expr, std::shared_ptr<Type> const to)
-    : Expr(pos, to)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::CAST_EXPR;
+    }
+
+    CastExpr(Position const pos, Expr* expr, Type* const to)
+    : Expr(NodeKind::CAST_EXPR, pos, to)
     , expr_(expr)
     , to_(to) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_cast_expr(shared_from_this());
+        visitor->visit_cast_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto set_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr(Expr* expr) -> void {
         expr_ = expr;
     }
-    auto get_expr() const -> std::shared_ptr<Expr> {
+    auto get_expr() const -> Expr* {
         return expr_;
     }
 
-    auto get_to_type() const -> std::shared_ptr<Type> {
+    auto get_to_type() const -> Type* {
         return to_;
     }
 
  private:
-    std::shared_ptr<Expr> expr_;
-    std::shared_ptr<Type> const to_;
+    Expr* expr_;
+    Type* const to_;
 };
 
-class ArrayInitExpr
-: public Expr
-, public std::enable_shared_from_this<ArrayInitExpr> {
+class ArrayInitExpr : public Expr {
  public:
-    ArrayInitExpr(Position const pos, std::vector<std::shared_ptr<Expr>> exprs)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::ARRAY_INIT_EXPR;
+    }
+
+    ArrayInitExpr(Position const pos, std::vector<Expr*> exprs)
+    : Expr(NodeKind::ARRAY_INIT_EXPR, pos, Type::get())
     , exprs_(exprs) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_array_init_expr(shared_from_this());
+        visitor->visit_array_init_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto set_exprs(std::vector<std::shared_ptr<Expr>> exprs) -> void {
+    auto set_exprs(std::vector<Expr*> exprs) -> void {
         exprs_ = std::move(exprs);
     }
 
-    auto get_exprs() const -> std::vector<std::shared_ptr<Expr>> {
+    auto get_exprs() const -> std::vector<Expr*> {
         return exprs_;
     }
 
  private:
-    std::vector<std::shared_ptr<Expr>> exprs_;
+    std::vector<Expr*> exprs_;
 };
 
-class ArrayIndexExpr
-: public Expr
-, public std::enable_shared_from_this<ArrayIndexExpr> {
+class ArrayIndexExpr : public Expr {
  public:
-    ArrayIndexExpr(Position const pos, std::shared_ptr<Expr> array_expr, std::shared_ptr<Expr> index_expr)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::ARRAY_INDEX_EXPR;
+    }
+
+    ArrayIndexExpr(Position const pos, Expr* array_expr, Expr* index_expr)
+    : Expr(NodeKind::ARRAY_INDEX_EXPR, pos, Type::get())
     , array_expr_(array_expr)
     , index_expr_(index_expr) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_array_index_expr(shared_from_this());
+        visitor->visit_array_index_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto get_array_expr() const -> std::shared_ptr<Expr> {
+    auto get_array_expr() const -> Expr* {
         return array_expr_;
     }
 
-    auto get_index_expr() const -> std::shared_ptr<Expr> {
+    auto get_index_expr() const -> Expr* {
         return index_expr_;
     }
 
-    auto set_index_expr(std::shared_ptr<Expr> e) -> void {
+    auto set_index_expr(Expr* e) -> void {
         index_expr_ = e;
     }
 
  private:
-    std::shared_ptr<Expr> array_expr_, index_expr_;
+    Expr* array_expr_;
+    Expr* index_expr_;
 };
 
-class EnumAccessExpr
-: public Expr
-, public std::enable_shared_from_this<EnumAccessExpr> {
+class EnumAccessExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::ENUM_ACCESS_EXPR;
+    }
+
     EnumAccessExpr(Position const pos, std::string const& enum_name, std::string const& field)
-    : Expr(pos, std::make_shared<Type>())
+    : Expr(NodeKind::ENUM_ACCESS_EXPR, pos, Type::get())
     , enum_name_(enum_name)
     , field_(field) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_enum_access_expr(shared_from_this());
+        visitor->visit_enum_access_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -623,18 +670,20 @@ class EnumAccessExpr
     int field_num_;
 };
 
-class FieldAccessExpr
-: public Expr
-, public std::enable_shared_from_this<FieldAccessExpr> {
+class FieldAccessExpr : public Expr {
  public:
-    FieldAccessExpr(Position const pos, std::shared_ptr<Expr> class_instance, std::string const& field_name, bool is_arrow)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::FIELD_ACCESS_EXPR;
+    }
+
+    FieldAccessExpr(Position const pos, Expr* class_instance, Symbol const field_name, bool is_arrow)
+    : Expr(NodeKind::FIELD_ACCESS_EXPR, pos, Type::get())
     , class_instance_(class_instance)
     , field_name_(field_name)
     , is_arrow_(is_arrow) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_field_access_expr(shared_from_this());
+        visitor->visit_field_access_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -643,15 +692,19 @@ class FieldAccessExpr
         field_num_ = field_num;
     }
 
-    auto get_class_instance() const -> std::shared_ptr<Expr> {
+    auto get_class_instance() const -> Expr* {
         return class_instance_;
     }
 
-    auto set_class_instance(std::shared_ptr<Expr> e) -> void {
+    auto set_class_instance(Expr* e) -> void {
         class_instance_ = e;
     }
 
-    auto get_field_name() const -> std::string {
+    auto get_field_name() const -> std::string const& {
+        return field_name_.str();
+    }
+
+    auto get_field_symbol() const -> Symbol {
         return field_name_;
     }
 
@@ -659,19 +712,19 @@ class FieldAccessExpr
         return field_num_;
     }
 
-    auto set_class_ref(std::shared_ptr<ClassDecl> class_ref) -> void {
+    auto set_class_ref(ClassDecl* class_ref) -> void {
         class_ref_ = class_ref;
     }
 
-    auto get_class_ref() const -> std::shared_ptr<ClassDecl> {
+    auto get_class_ref() const -> ClassDecl* {
         return class_ref_;
     }
 
-    auto set_ref(std::shared_ptr<ClassFieldDecl> ref) -> void {
+    auto set_ref(ClassFieldDecl* ref) -> void {
         ref_ = ref;
     }
 
-    auto get_ref() const -> std::shared_ptr<ClassFieldDecl> {
+    auto get_ref() const -> ClassFieldDecl* {
         return ref_;
     }
 
@@ -680,60 +733,66 @@ class FieldAccessExpr
     }
 
  private:
-    std::shared_ptr<Expr> class_instance_;
-    std::string const field_name_;
-    std::shared_ptr<ClassDecl> class_ref_ = nullptr;
-    std::shared_ptr<ClassFieldDecl> ref_ = nullptr;
+    Expr* class_instance_;
+    Symbol const field_name_;
+    ClassDecl* class_ref_ = nullptr;
+    ClassFieldDecl* ref_ = nullptr;
     bool is_arrow_ = false;
     int field_num_ = -1;
 };
 
-class MethodAccessExpr
-: public Expr
-, public std::enable_shared_from_this<MethodAccessExpr> {
+class MethodAccessExpr : public Expr {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::METHOD_ACCESS_EXPR;
+    }
+
     MethodAccessExpr(Position const pos,
-                     std::shared_ptr<Expr> class_instance,
-                     std::string const& method_name,
-                     std::vector<std::shared_ptr<Expr>> args,
+                     Expr* class_instance,
+                     Symbol const method_name,
+                     std::vector<Expr*> args,
                      bool is_arrow)
-    : Expr(pos, std::make_shared<Type>())
+    : Expr(NodeKind::METHOD_ACCESS_EXPR, pos, Type::get())
     , class_instance_(class_instance)
     , method_name_(method_name)
     , args_(args)
     , is_arrow_(is_arrow) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_method_access_expr(shared_from_this());
+        visitor->visit_method_access_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto get_class_instance() const -> std::shared_ptr<Expr> {
+    auto get_class_instance() const -> Expr* {
         return class_instance_;
     }
 
-    auto set_class_instance(std::shared_ptr<Expr> e) -> void {
+    auto set_class_instance(Expr* e) -> void {
         class_instance_ = e;
     }
 
-    auto get_method_name() const -> std::string {
+    auto get_method_name() const -> std::string const& {
+        return method_name_.str();
+    }
+
+    auto get_symbol() const -> Symbol {
         return method_name_;
     }
 
-    auto get_args() const -> std::vector<std::shared_ptr<Expr>> {
+    auto get_args() const -> std::vector<Expr*> {
         return args_;
     }
 
-    auto set_args(std::vector<std::shared_ptr<Expr>> args) -> void {
+    auto set_args(std::vector<Expr*> args) -> void {
         args_ = std::move(args);
     }
 
-    auto set_ref(std::shared_ptr<MethodDecl> ref) -> void {
+    auto set_ref(MethodDecl* ref) -> void {
         ref_ = ref;
     }
 
-    auto get_ref() const -> std::shared_ptr<MethodDecl> {
+    auto get_ref() const -> MethodDecl* {
         return ref_;
     }
 
@@ -742,29 +801,31 @@ class MethodAccessExpr
     }
 
  private:
-    std::shared_ptr<Expr> class_instance_;
-    std::string const method_name_;
-    std::vector<std::shared_ptr<Expr>> args_;
+    Expr* class_instance_;
+    Symbol const method_name_;
+    std::vector<Expr*> args_;
     bool is_arrow_ = false;
-    std::shared_ptr<MethodDecl> ref_ = nullptr;
+    MethodDecl* ref_ = nullptr;
 };
 
-class SizeOfExpr
-: public Expr
-, public std::enable_shared_from_this<SizeOfExpr> {
+class SizeOfExpr : public Expr {
  public:
-    SizeOfExpr(Position const pos, std::shared_ptr<Type> type_to_size)
-    : Expr(pos, std::make_shared<Type>(TypeSpec::I64))
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::SIZE_OF_EXPR;
+    }
+
+    SizeOfExpr(Position const pos, Type* type_to_size)
+    : Expr(NodeKind::SIZE_OF_EXPR, pos, Type::get(TypeSpec::I64))
     , type_to_size_(type_to_size)
     , is_type_(true) {}
 
-    SizeOfExpr(Position const pos, std::shared_ptr<Expr> expr_to_size)
-    : Expr(pos, std::make_shared<Type>(TypeSpec::I64))
+    SizeOfExpr(Position const pos, Expr* expr_to_size)
+    : Expr(NodeKind::SIZE_OF_EXPR, pos, Type::get(TypeSpec::I64))
     , expr_to_size_(expr_to_size)
     , is_type_(false) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_size_of_expr(shared_from_this());
+        visitor->visit_size_of_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -773,34 +834,36 @@ class SizeOfExpr
         return is_type_;
     }
 
-    auto get_type_to_size() const -> std::shared_ptr<Type> {
+    auto get_type_to_size() const -> Type* {
         return type_to_size_;
     }
 
-    auto set_type_to_size(std::shared_ptr<Type> type) -> void {
+    auto set_type_to_size(Type* type) -> void {
         type_to_size_ = type;
     }
 
-    auto get_expr_to_size() const -> std::shared_ptr<Expr> {
+    auto get_expr_to_size() const -> Expr* {
         return expr_to_size_;
     }
 
-    auto set_expr_to_size(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr_to_size(Expr* expr) -> void {
         expr_to_size_ = expr;
     }
 
  private:
-    std::shared_ptr<Type> type_to_size_ = nullptr;
-    std::shared_ptr<Expr> expr_to_size_ = nullptr;
+    Type* type_to_size_ = nullptr;
+    Expr* expr_to_size_ = nullptr;
     bool is_type_ = false;
 };
 
-class ImportExpr
-: public Expr
-, public std::enable_shared_from_this<ImportExpr> {
+class ImportExpr : public Expr {
  public:
-    ImportExpr(Position const pos, std::shared_ptr<Expr> expr, std::string const& alias_name)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::IMPORT_EXPR;
+    }
+
+    ImportExpr(Position const pos, Expr* expr, std::string const& alias_name)
+    : Expr(NodeKind::IMPORT_EXPR, pos, Type::get())
     , expr_(expr)
     , alias_name_(alias_name) {}
 
@@ -810,10 +873,10 @@ class ImportExpr
     auto get_module_ref() const -> std::shared_ptr<Module> {
         return module_ref_;
     }
-    auto set_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr(Expr* expr) -> void {
         expr_ = expr;
     }
-    auto get_expr() const -> std::shared_ptr<Expr> {
+    auto get_expr() const -> Expr* {
         return expr_;
     }
     auto get_alias_name() const -> std::string {
@@ -821,78 +884,80 @@ class ImportExpr
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_import_expr(shared_from_this());
+        visitor->visit_import_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Expr> expr_;
+    Expr* expr_;
     std::string alias_name_;
     std::shared_ptr<Module> module_ref_ = nullptr;
 };
 
-class NewExpr
-: public Expr
-, public std::enable_shared_from_this<NewExpr> {
+class NewExpr : public Expr {
  public:
-    NewExpr(Position const pos, std::shared_ptr<Type> new_type)
-    : Expr(pos, std::make_shared<Type>())
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::NEW_EXPR;
+    }
+
+    NewExpr(Position const pos, Type* new_type)
+    : Expr(NodeKind::NEW_EXPR, pos, Type::get())
     , new_type_(new_type) {}
 
-    NewExpr(Position const pos, std::shared_ptr<Type> new_type, std::shared_ptr<Expr> array_size_args)
-    : Expr(pos, std::make_shared<Type>())
+    NewExpr(Position const pos, Type* new_type, Expr* array_size_args)
+    : Expr(NodeKind::NEW_EXPR, pos, Type::get())
     , new_type_(new_type)
     , array_size_args_(std::optional{array_size_args}) {}
 
-    NewExpr(Position const pos, std::shared_ptr<Type> new_type, std::vector<std::shared_ptr<Expr>> constructor_args)
-    : Expr(pos, std::make_shared<Type>())
+    NewExpr(Position const pos, Type* new_type, std::vector<Expr*> constructor_args)
+    : Expr(NodeKind::NEW_EXPR, pos, Type::get())
     , new_type_(new_type)
     , constructor_args_(std::optional{constructor_args}) {}
 
-    auto set_new_type(std::shared_ptr<Type> new_type) -> void {
+    auto set_new_type(Type* new_type) -> void {
         new_type_ = new_type;
     }
 
-    auto get_new_type() const -> std::shared_ptr<Type> {
+    auto get_new_type() const -> Type* {
         return new_type_;
     }
 
-    auto set_constructor_args(std::vector<std::shared_ptr<Expr>> constructor_args) -> void {
+    auto set_constructor_args(std::vector<Expr*> constructor_args) -> void {
         constructor_args_ = std::move(constructor_args);
     }
 
-    auto get_constructor_args() const -> std::optional<std::vector<std::shared_ptr<Expr>>> {
+    auto get_constructor_args() const -> std::optional<std::vector<Expr*>> {
         return constructor_args_;
     }
 
-    auto set_array_size_args(std::shared_ptr<Expr> array_size_args) -> void {
+    auto set_array_size_args(Expr* array_size_args) -> void {
         array_size_args_ = array_size_args;
     }
 
-    auto get_array_size_args() const -> std::optional<std::shared_ptr<Expr>> {
+    auto get_array_size_args() const -> std::optional<Expr*> {
         return array_size_args_;
     }
 
-    auto set_call_expr(std::shared_ptr<ConstructorCallExpr> call_expr) -> void {
+    auto set_call_expr(ConstructorCallExpr* call_expr) -> void {
         call_expr_ = call_expr;
     }
 
-    auto get_call_expr() const -> std::shared_ptr<ConstructorCallExpr> {
+    auto get_call_expr() const -> ConstructorCallExpr* {
         return call_expr_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_new_expr(shared_from_this());
+        visitor->visit_new_expr(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Type> new_type_;
-    std::optional<std::vector<std::shared_ptr<Expr>>> constructor_args_;
-    std::optional<std::shared_ptr<Expr>> array_size_args_;
-    std::shared_ptr<ConstructorCallExpr> call_expr_ = nullptr;
+    Type* new_type_;
+    std::optional<std::vector<Expr*>> constructor_args_;
+    std::optional<Expr*> array_size_args_;
+    ConstructorCallExpr* call_expr_ = nullptr;
 };
 
 #endif // EXPR_HPP
\ No newline at end of file
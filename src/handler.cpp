@@ -1,69 +1,147 @@
 #include "./handler.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <optional>
-#include <streambuf>
+#include <sstream>
+#include <tuple>
 
-const std::shared_ptr<Type> Handler::ERROR_TYPE = std::make_shared<Type>(TypeSpec::ERROR);
-const std::shared_ptr<Type> Handler::BOOL_TYPE = std::make_shared<Type>(TypeSpec::BOOL);
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 
-auto read_file(std::string const& filename) -> std::optional<std::string> {
-    auto stream = std::ifstream{filename};
-    if (!stream) {
-        return std::nullopt;
-    }
-    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
-}
+Type* const Handler::ERROR_TYPE = Type::get(TypeSpec::ERROR);
+Type* const Handler::BOOL_TYPE = Type::get(TypeSpec::BOOL);
 
 auto Handler::add_file(std::string const filename) -> bool {
-    if (filename_to_contents_.find(filename) == filename_to_contents_.end()) {
-        auto const& contents = read_file(filename);
-        if (!contents) {
+    auto const lock = std::lock_guard{files_mutex_};
+    if (auto const it = files_.find(filename); it == files_.end() or !it->second.buffer) {
+        auto const phase = stats.phase("read", filename);
+        // Maps the file read-only (LLVM reads small files into a buffer instead), there's no null terminator
+        // since the lexer bounds checks against the size
+        auto buffer = llvm::MemoryBuffer::getFile(filename, false, false);
+        if (!buffer) {
             std::cerr << "Failed to read file: " << filename << "\n";
             return false;
         }
-        filename_to_contents_[filename] = std::make_shared<std::string>(*contents);
-        filename_to_lines_[filename] = std::vector<std::string>{};
-
-        std::istringstream stream(*contents);
-        std::string line;
-        while (std::getline(stream, line)) {
-            filename_to_lines_[filename].push_back(line);
-        }
+        files_[filename].buffer = std::move(*buffer);
         return true;
     }
     return false;
 }
 
-auto Handler::get_file_contents(const std::string& filename) -> std::shared_ptr<std::string> {
-    auto const& it = filename_to_contents_.find(filename);
-    if (it != filename_to_contents_.end()) {
-        return it->second;
+auto Handler::get_file_contents(const std::string& filename) -> std::string_view {
+    {
+        auto const lock = std::lock_guard{files_mutex_};
+        auto const& it = files_.find(filename);
+        if (it != files_.end() and it->second.buffer) {
+            auto const& buffer = it->second.buffer;
+            return std::string_view{buffer->getBufferStart(), buffer->getBufferSize()};
+        }
     }
     add_file(filename);
     return get_file_contents(filename);
 }
 
+auto Handler::file_id(std::string const& filename) -> uint16_t {
+    auto const lock = std::lock_guard{files_mutex_};
+    auto& [name, file] = *files_.try_emplace(filename).first;
+    if (file.id == 0) {
+        filenames_.push_back(&name);
+        file.id = static_cast<uint16_t>(filenames_.size());
+    }
+    return file.id;
+}
+
+auto Handler::line_index(SourceFile& file, std::string_view contents) -> std::vector<size_t> const& {
+    auto& line_starts = file.line_starts;
+    if (line_starts.empty() and !contents.empty()) {
+        line_starts.push_back(0);
+        auto const* const begin = contents.data();
+        auto const* const end = begin + contents.size();
+        for (auto const* c = begin; (c = static_cast<char const*>(std::memchr(c, '\n', end - c))); ++c) {
+            // A trailing newline doesn't start another line
+            if (c + 1 != end) {
+                line_starts.push_back(c + 1 - begin);
+            }
+        }
+    }
+    return line_starts;
+}
+
+auto Handler::locate(Position const& pos) -> Location {
+    if (pos.file_ == 0) {
+        return Location{};
+    }
+    auto filename = std::string{};
+    {
+        auto const lock = std::lock_guard{files_mutex_};
+        filename = *filenames_.at(pos.file_ - 1);
+    }
+    auto const contents = get_file_contents(filename);
+    auto const lock = std::lock_guard{files_mutex_};
+    auto const& line_starts = line_index(files_[filename], contents);
+    if (line_starts.empty()) {
+        return Location{};
+    }
+
+    auto const line_col = [&](size_t offset) {
+        offset = std::min(offset, contents.size());
+        auto const line = static_cast<size_t>(std::upper_bound(line_starts.begin(), line_starts.end(), offset)
+                                              - line_starts.begin());
+        auto col = size_t{1};
+        for (auto i = line_starts[line - 1]; i < offset; ++i) {
+            col += (contents[i] == '\t') ? 4 : 1;
+        }
+        return std::pair{line, col};
+    };
+    auto const [line_start, col_start] = line_col(pos.offset_);
+    auto const [line_end, col_end] = line_col(pos.offset_ + std::max<size_t>(pos.length_, 1) - 1);
+    return Location{line_start, line_end, col_start, col_end};
+}
+
+// Where the stream's handler is kept, for printing positions
+static auto const handler_slot = std::ios_base::xalloc();
+
+auto Handler::attach_to(std::ostream& os) -> void {
+    os.pword(handler_slot) = this;
+}
+
+auto operator<<(std::ostream& os, Position const& p) -> std::ostream& {
+    if (auto* const handler = static_cast<Handler*>(os.pword(handler_slot))) {
+        return os << handler->locate(p);
+    }
+    return os << "{" << p.offset_ << " + " << p.length_ << "}";
+}
+
+auto operator<<(std::ostream& os, Location const& l) -> std::ostream& {
+    os << "{(";
+    os << l.line_start_ << ", " << l.col_start_ << ") -> (";
+    os << l.line_end_ << ", " << l.col_end_ << ")}";
+    return os;
+}
+
 auto Handler::report_error(std::string const& filename,
                            std::string const& message,
                            std::string const& token,
                            Position const& pos) -> void {
-    std::cout << ANSI_RED_ << "ERROR: *" << ANSI_RESET_;
+    auto os = std::ostringstream{};
+    os << ANSI_RED_ << "ERROR: *" << ANSI_RESET_;
     for (auto c = 0u; c < message.size(); ++c) {
         if (message.at(c) == '%') {
-            std::cout << token;
+            os << token;
         }
         else {
-            std::cout << message.at(c);
+            os << message.at(c);
         }
     }
-    std::cout << "\n";
-    log_lines(filename, pos.line_start_, pos.col_start_);
+    os << "\n";
+    auto const location = locate(pos);
+    log_lines(os, filename, location.line_start_, location.col_start_);
     ++num_errors_;
+    emit(location, os.str(), true);
 }
 
 auto Handler::report_minor_error(std::string const& filename,
@@ -72,29 +150,74 @@ auto Handler::report_minor_error(std::string const& filename,
                                  Position const& pos) -> void {
     if (quiet_)
         return;
-    std::cout << ANSI_BLUE_ << "MINOR ERROR: *" << ANSI_RESET_;
+    auto os = std::ostringstream{};
+    os << ANSI_BLUE_ << "MINOR ERROR: *" << ANSI_RESET_;
     for (auto c = 0u; c < message.size(); ++c) {
         if (message.at(c) == '%') {
-            std::cout << token;
+            os << token;
         }
         else {
-            std::cout << message.at(c);
+            os << message.at(c);
         }
     }
-    std::cout << "\n";
-    log_lines(filename, pos.line_start_, pos.col_start_);
+    os << "\n";
+    auto const location = locate(pos);
+    log_lines(os, filename, location.line_start_, location.col_start_);
+    emit(location, os.str(), false);
+}
+
+auto Handler::report_fatal_error(std::string const& filename,
+                                 std::string const& message,
+                                 std::string const& token,
+                                 Position const& pos) -> void {
+    report_error(filename, message, token, pos);
+    fatal();
+}
+
+auto Handler::fatal() -> void {
+    if (current_diagnostics_) {
+        throw FatalError{};
+    }
+    exit(EXIT_FAILURE);
+}
+
+auto Handler::print_diagnostics(std::vector<Diagnostic>& diagnostics) -> void {
+    std::stable_sort(diagnostics.begin(), diagnostics.end(), [](auto const& a, auto const& b) {
+        return std::tie(a.location.line_start_, a.location.col_start_)
+               < std::tie(b.location.line_start_, b.location.col_start_);
+    });
+    auto const lock = std::lock_guard{output_mutex_};
+    for (auto const& diagnostic : diagnostics) {
+        std::cout << diagnostic.text;
+    }
+    std::cout.flush();
+    diagnostics.clear();
+}
+
+auto Handler::emit(Location const& location, std::string text, bool is_error) -> void {
+    if (current_diagnostics_) {
+        current_diagnostics_->push_back(Diagnostic{location, std::move(text), is_error});
+        return;
+    }
+    auto const lock = std::lock_guard{output_mutex_};
+    std::cout << text;
 }
 
-auto Handler::log_lines(const std::string& filename, int line, int col) -> void {
-    std::cout << ANSI_YELLOW_ << filename << ":" << line << ":" << col << ANSI_RESET_ << ":\n";
-    auto const& lines = filename_to_lines_[filename];
+auto Handler::log_lines(std::ostream& os, const std::string& filename, int line, int col) -> void {
+    os << ANSI_YELLOW_ << filename << ":" << line << ":" << col << ANSI_RESET_ << ":\n";
+    auto const contents = get_file_contents(filename);
+    auto const lock = std::lock_guard{files_mutex_};
+    auto const& line_starts = line_index(files_[filename], contents);
+
     for (int i = line - 2; i <= line + 2; ++i) {
-        if (i >= 1 and i <= (int)lines.size()) {
-            std::cout << std::setw(5) << i << " | ";
-            std::cout << lines[i - 1] << "\n";
+        if (i >= 1 and i <= (int)line_starts.size()) {
+            auto const start = line_starts[i - 1];
+            auto const text = contents.substr(start, contents.find('\n', start) - start);
+            os << std::setw(5) << i << " | ";
+            os << text << "\n";
         }
     }
-    std::cout << "\n";
+    os << "\n";
 }
 
 auto Handler::help() -> void {
@@ -104,10 +227,25 @@ auto Handler::help() -> void {
     std::cout << "\t-o  | --out         => Specify the name of the executable (default to a.out)\n";
     std::cout << "\t-t  | --tokens      => Logs to stdout a summary of all the tokens\n";
     std::cout << "\t-p  | --parser      => Generates a printed parse tree\n";
+    std::cout << "\t-c                  => Generates an object file instead of an executable\n";
     std::cout << "\t-a  | --assembly    => Generates a .s file instead of an executable\n";
     std::cout << "\t-ir | --llvm-ir     => Generates a .ll file instead of an executable\n";
     std::cout << "\t-q  | --quiet       => Silence any non-crucial warnings\n";
     std::cout << "\t-s  | --stat        => Log statistics about the compilation times\n";
+    std::cout << "\t-j <n>              => Lex, parse and verify independent modules on n threads (default 1)\n";
+    std::cout << "\t--codegen-threads=<n>\n";
+    std::cout << "\t                    => Optimise and generate code in n partitions at once, then link them (default 1)\n";
+    std::cout << "\t--stat-json=<file>  => Write the compilation statistics to a JSON file\n";
+    std::cout << "\t--time-trace[=<file>]\n";
+    std::cout << "\t                    => Write a Chrome trace of the compilation (default time-trace.json)\n";
+    std::cout << "\t--linker=<program>  => Program used to link the executable (default clang, then cc)\n";
+    std::cout << "\t--jit-cache         => Cache JIT compiled code on disk between runs of -r\n";
+    std::cout << "\t--build-cache       => Cache module objects and interfaces on disk, only rebuilding and relinking what changed\n";
+    std::cout << "\t--precompile        => Compile a library to bitcode (.bc) and an interface (.xppi) for programs using it\n";
+    std::cout << "\t-O<n>               => Optimisation level, where n is one of 0, 1, 2, 3, s or z (default 0)\n";
+    std::cout << "\t--target-cpu=<cpu>  => CPU to generate code for, 'native' uses the host CPU (default generic)\n";
+    std::cout << "\t--target-features=<+feat,-feat,...>\n";
+    std::cout << "\t                    => Extra target features to enable or disable, e.g. +avx2,-bmi\n";
     std::cout << "\nDeveloped by Joshua Wills 2025\n";
 }
 
@@ -134,6 +272,83 @@ auto Handler::parse_cl_args(int argc, std::vector<std::string> const& argv) -> b
     quiet_ = exists_in_args("-q") or exists_in_args("--quiet");
     stats_ = exists_in_args("-s") or exists_in_args("--stat");
     llvm_ir_ = exists_in_args("-ir") or exists_in_args("--llvm-ir");
+    jit_cache_ = exists_in_args("--jit-cache");
+    build_cache_ = exists_in_args("--build-cache");
+    precompile_ = exists_in_args("--precompile");
+    object_only_ = exists_in_args("-c");
+
+    // The last optimisation level specified takes precedence
+    auto const opt_levels = std::map<std::string, OptLevel>{{"-O0", OptLevel::O0},
+                                                            {"-O1", OptLevel::O1},
+                                                            {"-O2", OptLevel::O2},
+                                                            {"-O3", OptLevel::O3},
+                                                            {"-Os", OptLevel::Os},
+                                                            {"-Oz", OptLevel::Oz}};
+    for (auto const& arg : argv) {
+        auto const it = opt_levels.find(arg);
+        if (it != opt_levels.end()) {
+            opt_level_ = it->second;
+        }
+    }
+
+    // Flags of the form --flag=value
+    auto const value_in_args = [&argv](const std::string& prefix) -> std::optional<std::string> {
+        auto const it = std::find_if(argv.rbegin(), argv.rend(), [&prefix](const std::string& arg) {
+            return arg.rfind(prefix, 0) == 0;
+        });
+        if (it == argv.rend()) {
+            return std::nullopt;
+        }
+        return it->substr(prefix.size());
+    };
+
+    if (auto const cpu = value_in_args("--target-cpu=")) {
+        if (cpu->empty()) {
+            std::cerr << "Error: No CPU specified after --target-cpu=\n";
+            return false;
+        }
+        target_cpu_ = *cpu;
+    }
+
+    if (auto const features = value_in_args("--target-features=")) {
+        auto entries = llvm::SmallVector<llvm::StringRef>{};
+        llvm::StringRef{*features}.split(entries, ',');
+        for (auto const entry : entries) {
+            if (entry.size() < 2 or (entry.front() != '+' and entry.front() != '-')) {
+                std::cerr << "Error: Expected target features of the form +feature or -feature, got '" << entry.str()
+                          << "'\n";
+                return false;
+            }
+        }
+        target_features_ = *features;
+    }
+
+    if (auto const stats_json = value_in_args("--stat-json=")) {
+        if (stats_json->empty()) {
+            std::cerr << "Error: No filename specified after --stat-json=\n";
+            return false;
+        }
+        stats_json_filename_ = *stats_json;
+    }
+
+    if (auto const time_trace = value_in_args("--time-trace=")) {
+        if (time_trace->empty()) {
+            std::cerr << "Error: No filename specified after --time-trace=\n";
+            return false;
+        }
+        time_trace_filename_ = *time_trace;
+    }
+    else if (exists_in_args("--time-trace")) {
+        time_trace_filename_ = "time-trace.json";
+    }
+
+    if (auto const linker = value_in_args("--linker=")) {
+        if (linker->empty()) {
+            std::cerr << "Error: No program specified after --linker=\n";
+            return false;
+        }
+        linker_ = *linker;
+    }
 
     if (exists_in_args("-o") or exists_in_args("--out")) {
         auto it = std::find(argv.begin(), argv.end(), "-o");
@@ -147,6 +362,9 @@ auto Handler::parse_cl_args(int argc, std::vector<std::string> const& argv) -> b
             else if (llvm_ir_) {
                 llvm_filename_ = *it;
             }
+            else if (object_only_) {
+                object_filename_ = *it;
+            }
             else {
                 output_filename_ = *it;
             }
@@ -157,6 +375,25 @@ auto Handler::parse_cl_args(int argc, std::vector<std::string> const& argv) -> b
         }
     }
 
+    if (exists_in_args("-j")) {
+        auto it = std::find(argv.begin(), argv.end(), "-j");
+        auto jobs = 0;
+        if (++it == argv.end() or llvm::StringRef{*it}.getAsInteger(10, jobs) or jobs < 1) {
+            std::cerr << "Error: Expected a positive number of threads after -j\n";
+            return false;
+        }
+        jobs_ = static_cast<unsigned>(jobs);
+    }
+
+    if (auto const threads = value_in_args("--codegen-threads=")) {
+        auto num_threads = 0;
+        if (llvm::StringRef{*threads}.getAsInteger(10, num_threads) or num_threads < 1) {
+            std::cerr << "Error: Expected a positive number of threads after --codegen-threads=\n";
+            return false;
+        }
+        codegen_threads_ = static_cast<unsigned>(num_threads);
+    }
+
     std::vector<std::string> valid_cl_args = {"-h",
                                               "--help",
                                               "-r",
@@ -167,6 +404,7 @@ auto Handler::parse_cl_args(int argc, std::vector<std::string> const& argv) -> b
                                               "--tokens",
                                               "-p",
                                               "--parser",
+                                              "-c",
                                               "-a",
                                               "--assembly",
                                               "-q",
@@ -174,7 +412,18 @@ auto Handler::parse_cl_args(int argc, std::vector<std::string> const& argv) -> b
                                               "-s",
                                               "--stat",
                                               "-ir",
-                                              "--llvm-ir"};
+                                              "--llvm-ir",
+                                              "--jit-cache",
+                                              "--build-cache",
+                                              "--precompile",
+                                              "--time-trace",
+                                              "-j",
+                                              "-O0",
+                                              "-O1",
+                                              "-O2",
+                                              "-O3",
+                                              "-Os",
+                                              "-Oz"};
 
     source_filename = std::filesystem::absolute(argv.back());
     if (std::find(valid_cl_args.begin(), valid_cl_args.end(), source_filename) != valid_cl_args.end()) {
@@ -187,4 +436,14 @@ auto Handler::parse_cl_args(int argc, std::vector<std::string> const& argv) -> b
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+auto Handler::get_cache_dir() const -> std::filesystem::path {
+    if (auto const xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache and *xdg_cache) {
+        return std::filesystem::path{xdg_cache} / "xpp";
+    }
+    if (auto const home = std::getenv("HOME"); home and *home) {
+        return std::filesystem::path{home} / ".cache" / "xpp";
+    }
+    return std::filesystem::temp_directory_path() / "xpp";
+}
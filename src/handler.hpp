@@ -1,15 +1,32 @@
 #ifndef HANDLER_HPP
 #define HANDLER_HPP
 
+#include <atomic>
+#include <deque>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/TimeProfiler.h"
+
+#include "./stats.hpp"
 #include "./token.hpp"
 #include "./type.hpp"
 
+enum class OptLevel { O0, O1, O2, O3, Os, Oz };
+
+// Line and column of either end of a position, counting from 1 with a tab taking up 4 columns
+struct Location {
+    size_t line_start_ = 0, line_end_ = 0, col_start_ = 0, col_end_ = 0;
+};
+
+auto operator<<(std::ostream& os, Location const& l) -> std::ostream&;
+
 class Handler {
  public:
     Handler() = default;
@@ -17,7 +34,21 @@ class Handler {
     : quiet_{is_quiet} {}
 
     auto add_file(std::string const filename) -> bool;
-    auto get_file_contents(std::string const& filename) -> std::shared_ptr<std::string>;
+    // The source stays mapped for the whole compilation, so views into it (e.g. token lexemes) never dangle
+    auto get_file_contents(std::string const& filename) -> std::string_view;
+    // The number positions in the file are made with, the file isn't read until something needs its contents
+    auto file_id(std::string const& filename) -> uint16_t;
+
+    // Works the line and column out from the file's line index, which is only built the first time it's needed
+    auto locate(Position const& pos) -> Location;
+    // Positions printed to the stream from now on show as lines and columns rather than offsets
+    auto attach_to(std::ostream& os) -> void;
+
+    // Keeps a lexeme that isn't a verbatim slice of its source alive for the rest of compilation
+    auto store_lexeme(std::string lexeme) -> std::string_view {
+        auto const lock = std::lock_guard{files_mutex_};
+        return stored_lexemes_.emplace_back(std::move(lexeme));
+    }
 
     auto
     report_error(std::string const& filename, std::string const& message, std::string const& token, Position const& pos)
@@ -26,6 +57,44 @@ class Handler {
                             std::string const& message,
                             std::string const& token,
                             Position const& pos) -> void;
+    // Reports the error, then gives up on the compilation, see fatal
+    [[noreturn]] auto report_fatal_error(std::string const& filename,
+                                         std::string const& message,
+                                         std::string const& token,
+                                         Position const& pos) -> void;
+
+    // Thrown in place of exiting while a module's diagnostics are held back, as that module may be one of several
+    // being worked on at once. Whoever is holding them back prints them and exits from the main thread
+    struct FatalError {};
+    // Exits after an error nothing can be made of the module past, or throws a FatalError within a DiagnosticScope
+    [[noreturn]] auto fatal() -> void;
+
+    struct Diagnostic {
+        Location location;
+        std::string text;
+        bool is_error;
+    };
+
+    // Holds back the diagnostics reported on this thread until the scope ends, so modules checked in parallel
+    // can be reported in a fixed order
+    class DiagnosticScope {
+     public:
+        DiagnosticScope(std::vector<Diagnostic>& diagnostics)
+        : previous_(current_diagnostics_) {
+            current_diagnostics_ = &diagnostics;
+        }
+        DiagnosticScope(DiagnosticScope const&) = delete;
+        auto operator=(DiagnosticScope const&) -> DiagnosticScope& = delete;
+        ~DiagnosticScope() {
+            current_diagnostics_ = previous_;
+        }
+
+     private:
+        std::vector<Diagnostic>* previous_;
+    };
+
+    // Prints held back diagnostics ordered by position
+    auto print_diagnostics(std::vector<Diagnostic>& diagnostics) -> void;
 
     auto parse_cl_args(int argc, std::vector<std::string> const& argv) -> bool;
 
@@ -49,6 +118,34 @@ class Handler {
         return run_;
     }
 
+    auto stats_mode() const noexcept -> bool {
+        return stats_ or !stats_json_filename_.empty();
+    }
+
+    auto get_stats_json_filename() const noexcept -> std::string const& {
+        return stats_json_filename_;
+    }
+
+    auto get_time_trace_filename() const noexcept -> std::string const& {
+        return time_trace_filename_;
+    }
+
+    auto jit_cache_mode() const noexcept -> bool {
+        return jit_cache_;
+    }
+
+    // Only executables are put together from cached objects
+    auto build_cache_mode() const noexcept -> bool {
+        return build_cache_ and !precompile_ and !run_ and !assembly_ and !llvm_ir_ and !object_only_;
+    }
+
+    // Compiles a library module to bitcode and an interface under precompiled_path, for programs using it to link against
+    auto precompile_mode() const noexcept -> bool {
+        return precompile_;
+    }
+
+    auto get_cache_dir() const -> std::filesystem::path;
+
     auto get_output_filename() -> std::string& {
         return output_filename_;
     }
@@ -68,25 +165,92 @@ class Handler {
         return assembly_;
     }
 
+    auto object_only_mode() const noexcept -> bool {
+        return object_only_;
+    }
+
+    auto get_linker() const noexcept -> std::string const& {
+        return linker_;
+    }
+
+    auto get_opt_level() const noexcept -> OptLevel {
+        return opt_level_;
+    }
+
+    auto get_target_cpu() const noexcept -> std::string const& {
+        return target_cpu_;
+    }
+
+    auto get_target_features() const noexcept -> std::string const& {
+        return target_features_;
+    }
+
+    auto get_jobs() const noexcept -> unsigned {
+        return jobs_;
+    }
+
+    auto get_codegen_threads() const noexcept -> unsigned {
+        return codegen_threads_;
+    }
+
+    // Runs on a worker thread, recording its phases in the time trace as well when there is one
+    template <typename Task>
+    auto traced(Task task) -> void {
+        // The profiler is per thread, finishing it hands this thread's events over to be written with the rest
+        auto const is_tracing = !time_trace_filename_.empty();
+        if (is_tracing) {
+            llvm::timeTraceProfilerInitialize(0, "compiler");
+        }
+        task();
+        if (is_tracing) {
+            llvm::timeTraceProfilerFinishThread();
+        }
+    }
+
     static auto help() -> void;
 
     std::string source_filename = {};
-    static const std::shared_ptr<Type> ERROR_TYPE;
-    static const std::shared_ptr<Type> BOOL_TYPE;
+    Stats stats = {};
+    static Type* const ERROR_TYPE;
+    static Type* const BOOL_TYPE;
 
-    size_t num_errors_ = 0;
+    std::atomic<size_t> num_errors_ = 0;
     std::string stdlib_path = (std::filesystem::current_path() / "lib").string();
+    // Where libraries are precompiled to, set by the build to a directory of its own
+    std::string precompiled_path = XPP_PRECOMPILED_DIR;
 
  private:
-    std::map<std::string, std::shared_ptr<std::string>> filename_to_contents_ = {};
-    std::map<std::string, std::vector<std::string>> filename_to_lines_ = {};
-    auto log_lines(const std::string& filename, int line, int col) -> void;
+    struct SourceFile {
+        std::unique_ptr<llvm::MemoryBuffer> buffer;
+        // Offset of the start of each line, only built once a diagnostic needs a line or column
+        std::vector<size_t> line_starts = {};
+        uint16_t id = 0;
+    };
+    std::map<std::string, SourceFile> files_ = {};
+    // The name of every numbered file, by its number less one
+    std::vector<std::string const*> filenames_ = {};
+    std::deque<std::string> stored_lexemes_ = {};
+    std::mutex files_mutex_ = {};
+    std::mutex output_mutex_ = {};
+    inline static thread_local std::vector<Diagnostic>* current_diagnostics_ = nullptr;
+    auto emit(Location const& location, std::string text, bool is_error) -> void;
+    auto log_lines(std::ostream& os, const std::string& filename, int line, int col) -> void;
+    static auto line_index(SourceFile& file, std::string_view contents) -> std::vector<size_t> const&;
     std::string const ANSI_RED_ = "\033[31m";
     std::string const ANSI_RESET_ = "\033[0m";
     std::string const ANSI_YELLOW_ = "\033[33m";
     std::string const ANSI_BLUE_ = "\033[34m";
     bool quiet_ = false, run_ = false, tokens_ = false, parser_ = false;
-    bool assembly_ = false, stats_ = false, llvm_ir_ = false;
+    bool assembly_ = false, stats_ = false, llvm_ir_ = false, jit_cache_ = false, object_only_ = false;
+    bool build_cache_ = false, precompile_ = false;
+    OptLevel opt_level_ = OptLevel::O0;
+    unsigned jobs_ = 1;
+    unsigned codegen_threads_ = 1;
+    std::string target_cpu_ = "generic";
+    std::string target_features_ = {};
+    std::string linker_ = {};
+    std::string stats_json_filename_ = {};
+    std::string time_trace_filename_ = {};
     std::string output_filename_ = "a.out";
     std::string object_filename_ = "default.o";
     std::string assembly_filename_ = "default.s";
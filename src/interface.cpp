@@ -0,0 +1,403 @@
+#include "./interface.hpp"
+
+#include "llvm/Support/Endian.h"
+
+// Bumped whenever the layout changes, so interfaces written by an older compiler are parsed over
+constexpr auto interface_version = uint32_t{2};
+constexpr auto interface_magic = llvm::StringLiteral{"XPPI"};
+
+constexpr auto pub_flag = uint32_t{1} << 0;
+constexpr auto mut_flag = uint32_t{1} << 1;
+
+InterfaceWriter::InterfaceWriter(AllModules const& modules) {
+    for (auto const& module : modules) {
+        for (auto const& class_ : module.get_classes()) {
+            owners_.emplace(class_, module.get_filepath());
+        }
+        for (auto const& enum_ : module.get_enums()) {
+            owners_.emplace(enum_, module.get_filepath());
+        }
+    }
+}
+
+auto InterfaceWriter::write(Module const& module) -> std::optional<std::string> {
+    buffer_ = interface_magic.str();
+    write_u32(interface_version);
+    write_string(module.get_cache_key());
+    write_filepaths(module.get_imported_filepaths());
+    write_filepaths(module.get_using_filepaths());
+
+    write_u32(module.get_enums().size());
+    for (auto const& enum_ : module.get_enums()) {
+        write_decl(enum_);
+        write_u32(enum_->get_fields().size());
+        for (auto const& field : enum_->get_fields()) {
+            write_string(field);
+        }
+    }
+
+    // Every class is named before any is written out, as their members can refer to one another
+    write_u32(module.get_classes().size());
+    for (auto const& class_ : module.get_classes()) {
+        write_decl(class_);
+    }
+    for (auto const& class_ : module.get_classes()) {
+        write_u32(class_->has_copy_constructor());
+        write_u32(class_->get_fields().size());
+        for (auto const& field : class_->get_fields()) {
+            write_decl(field);
+            write_type(field->get_type());
+        }
+        write_u32(class_->get_methods().size());
+        for (auto const& method : class_->get_methods()) {
+            write_decl(method);
+            write_type(method->get_type());
+            write_paras(method->get_paras());
+        }
+        write_u32(class_->get_constructors().size());
+        for (auto const& constructor : class_->get_constructors()) {
+            write_decl(constructor);
+            write_paras(constructor->get_paras());
+        }
+        write_u32(class_->get_destructors().size());
+        for (auto const& destructor : class_->get_destructors()) {
+            write_decl(destructor);
+        }
+    }
+
+    write_u32(module.get_externs().size());
+    for (auto const& extern_ : module.get_externs()) {
+        write_decl(extern_);
+        write_type(extern_->get_type());
+        auto const types = extern_->get_types();
+        write_u32(types.size());
+        for (auto const& type : types) {
+            write_type(type);
+        }
+        write_u32(extern_->is_variatic());
+    }
+
+    write_u32(module.get_global_vars().size());
+    for (auto const& global_var : module.get_global_vars()) {
+        write_decl(global_var);
+        write_type(global_var->get_type());
+    }
+
+    write_u32(module.get_functions().size());
+    for (auto const& function : module.get_functions()) {
+        write_decl(function);
+        write_type(function->get_type());
+        write_paras(function->get_paras());
+    }
+
+    if (failed_) {
+        return std::nullopt;
+    }
+    return std::move(buffer_);
+}
+
+auto InterfaceWriter::write_u32(uint32_t value) -> void {
+    char bytes[sizeof(value)];
+    llvm::support::endian::write32le(bytes, value);
+    buffer_.append(bytes, sizeof(bytes));
+}
+
+auto InterfaceWriter::write_string(llvm::StringRef str) -> void {
+    write_u32(str.size());
+    buffer_.append(str.data(), str.size());
+}
+
+auto InterfaceWriter::write_filepaths(llvm::ArrayRef<std::pair<std::string, bool>> filepaths) -> void {
+    write_u32(filepaths.size());
+    for (auto const& [filepath, is_lib] : filepaths) {
+        write_string(filepath);
+        write_u32(is_lib);
+    }
+}
+
+auto InterfaceWriter::write_decl(Decl const* decl) -> void {
+    auto const pos = decl->pos();
+    write_u32(pos.offset_);
+    write_u32(pos.length_);
+    write_string(decl->get_ident());
+    write_u32((decl->is_pub() ? pub_flag : 0) | (decl->is_mut() ? mut_flag : 0));
+}
+
+auto InterfaceWriter::write_type(Type const* type) -> void {
+    write_u32(type->get_type_spec());
+    switch (type->get_type_spec()) {
+    case TypeSpec::POINTER: write_type(static_cast<PointerType const*>(type)->get_sub_type()); break;
+    case TypeSpec::ARRAY: {
+        auto const array_type = static_cast<ArrayType const*>(type);
+        write_u32(array_type->get_length().has_value());
+        write_u32(array_type->get_length().value_or(0));
+        write_type(array_type->get_sub_type());
+        break;
+    }
+    case TypeSpec::CLASS:
+    case TypeSpec::ENUM: {
+        auto const* const decl = type->is_class()
+                                     ? static_cast<Decl const*>(static_cast<ClassType const*>(type)->get_ref())
+                                     : static_cast<EnumType const*>(type)->get_ref();
+        auto const it = owners_.find(decl);
+        if (it == owners_.end()) {
+            failed_ = true;
+            break;
+        }
+        write_string(it->second);
+        write_string(decl->get_ident());
+        break;
+    }
+    // Only left behind by declarations that failed to verify
+    case TypeSpec::ERROR:
+    case TypeSpec::MURKY:
+    case TypeSpec::IMPORT: failed_ = true; break;
+    default: break;
+    }
+}
+
+auto InterfaceWriter::write_paras(std::vector<ParaDecl*> const& paras) -> void {
+    write_u32(paras.size());
+    for (auto const& para : paras) {
+        write_decl(para);
+        write_type(para->get_type());
+    }
+}
+
+auto InterfaceReader::read_header() -> bool {
+    auto const contents = buffer_->getBuffer();
+    if (!contents.startswith(interface_magic)) {
+        return false;
+    }
+    offset_ = interface_magic.size();
+    if (read_u32() != interface_version) {
+        return false;
+    }
+    key_ = read_string();
+    imported_files_ = read_filepaths();
+    using_files_ = read_filepaths();
+    return !failed_;
+}
+
+auto InterfaceReader::read_module(std::string const& filepath, uint16_t file, Resolver const& resolve)
+    -> std::shared_ptr<Module> {
+    auto module = std::make_shared<Module>(filepath);
+    auto const arena_scope = Arena::Scope{module->get_arena()};
+    module_ = module.get();
+    file_ = file;
+    resolve_ = &resolve;
+
+    module->set_is_interface();
+    for (auto const& [path, is_lib] : imported_files_) {
+        module->add_imported_filepath(path, path, is_lib);
+    }
+    for (auto const& [path, is_lib] : using_files_) {
+        module->add_using_filepath(path, is_lib);
+    }
+
+    for (auto n = read_u32(); n > 0 and !failed_; --n) {
+        auto const header = read_decl();
+        auto fields = std::vector<std::string>{};
+        for (auto m = read_u32(); m > 0 and !failed_; --m) {
+            fields.push_back(read_string());
+        }
+        auto const enum_ = EnumDecl::make(header.pos, header.ident, fields);
+        set_flags(enum_, header.flags);
+        module->add_enums(enum_);
+    }
+
+    for (auto n = read_u32(); n > 0 and !failed_; --n) {
+        auto const header = read_decl();
+        auto const class_ = ClassDecl::make(header.pos, header.ident, {}, {}, {}, {});
+        set_flags(class_, header.flags);
+        module->add_class(class_);
+    }
+    for (auto const& class_ : module->get_classes()) {
+        class_->set_has_copy_constructor(read_u32());
+
+        auto fields = std::vector<ClassFieldDecl*>{};
+        for (auto n = read_u32(); n > 0 and !failed_; --n) {
+            auto const header = read_decl();
+            auto const field = make_node<ClassFieldDecl>(header.pos, header.ident, read_type());
+            set_flags(field, header.flags);
+            fields.push_back(field);
+        }
+
+        // Bodies are left empty, as they are never generated from an interface
+        auto methods = std::vector<MethodDecl*>{};
+        for (auto n = read_u32(); n > 0 and !failed_; --n) {
+            auto const header = read_decl();
+            auto const type = read_type();
+            auto const method = make_node<MethodDecl>(
+                header.pos, header.ident, read_paras(), type, make_node<CompoundStmt>(header.pos));
+            set_flags(method, header.flags);
+            method->set_class_ref(class_);
+            methods.push_back(method);
+        }
+
+        auto constructors = std::vector<ConstructorDecl*>{};
+        for (auto n = read_u32(); n > 0 and !failed_; --n) {
+            auto const header = read_decl();
+            auto const constructor = make_node<ConstructorDecl>(
+                header.pos, header.ident, read_paras(), make_node<CompoundStmt>(header.pos));
+            set_flags(constructor, header.flags);
+            constructor->set_type(ClassType::get(class_));
+            constructors.push_back(constructor);
+        }
+
+        auto destructors = std::vector<DestructorDecl*>{};
+        for (auto n = read_u32(); n > 0 and !failed_; --n) {
+            auto const header = read_decl();
+            auto const destructor =
+                make_node<DestructorDecl>(header.pos, header.ident, make_node<CompoundStmt>(header.pos));
+            set_flags(destructor, header.flags);
+            destructors.push_back(destructor);
+        }
+
+        class_->set_members(fields, methods, constructors, destructors);
+    }
+
+    for (auto n = read_u32(); n > 0 and !failed_; --n) {
+        auto const header = read_decl();
+        auto const type = read_type();
+        auto types = std::vector<Type*>{};
+        for (auto m = read_u32(); m > 0 and !failed_; --m) {
+            types.push_back(read_type());
+        }
+        auto const extern_ = make_node<Extern>(header.pos, header.ident, type, types);
+        set_flags(extern_, header.flags);
+        if (read_u32()) {
+            extern_->set_variatic();
+        }
+        module->add_extern(extern_);
+    }
+
+    for (auto n = read_u32(); n > 0 and !failed_; --n) {
+        auto const header = read_decl();
+        auto const global_var =
+            make_node<GlobalVarDecl>(header.pos, header.ident, read_type(), make_node<EmptyExpr>(header.pos));
+        set_flags(global_var, header.flags);
+        module->add_global_var(global_var);
+    }
+
+    for (auto n = read_u32(); n > 0 and !failed_; --n) {
+        auto const header = read_decl();
+        auto const type = read_type();
+        auto const function = make_node<Function>(
+            header.pos, header.ident, read_paras(), type, make_node<CompoundStmt>(header.pos));
+        set_flags(function, header.flags);
+        module->add_function(function);
+    }
+
+    if (failed_ or offset_ != buffer_->getBufferSize()) {
+        return nullptr;
+    }
+    return module;
+}
+
+auto InterfaceReader::read_u32() -> uint32_t {
+    if (failed_ or buffer_->getBufferSize() - offset_ < sizeof(uint32_t)) {
+        failed_ = true;
+        return 0;
+    }
+    auto const value = llvm::support::endian::read32le(buffer_->getBufferStart() + offset_);
+    offset_ += sizeof(uint32_t);
+    return value;
+}
+
+auto InterfaceReader::read_string() -> std::string {
+    auto const size = read_u32();
+    if (failed_ or buffer_->getBufferSize() - offset_ < size) {
+        failed_ = true;
+        return {};
+    }
+    auto str = std::string{buffer_->getBufferStart() + offset_, size};
+    offset_ += size;
+    return str;
+}
+
+auto InterfaceReader::read_filepaths() -> std::vector<std::pair<std::string, bool>> {
+    auto filepaths = std::vector<std::pair<std::string, bool>>{};
+    for (auto n = read_u32(); n > 0 and !failed_; --n) {
+        auto filepath = read_string();
+        filepaths.emplace_back(std::move(filepath), read_u32() != 0);
+    }
+    return filepaths;
+}
+
+auto InterfaceReader::read_decl() -> DeclHeader {
+    auto header = DeclHeader{};
+    header.pos.offset_ = read_u32();
+    header.pos.length_ = static_cast<uint16_t>(read_u32());
+    header.pos.file_ = file_;
+    header.ident = Symbol{read_string()};
+    header.flags = read_u32();
+    return header;
+}
+
+auto InterfaceReader::set_flags(Decl* decl, uint32_t flags) -> void {
+    if (flags & pub_flag) {
+        decl->set_pub();
+    }
+    if (flags & mut_flag) {
+        decl->set_mut();
+    }
+    // The modules depending on this one were verified against what it declares, not how much of it they use, so
+    // nothing read back is reported as unused
+    decl->set_used();
+}
+
+auto InterfaceReader::read_type() -> Type* {
+    auto const tag = read_u32();
+    if (tag > TypeSpec::IMPORT) {
+        failed_ = true;
+        return Type::get(TypeSpec::ERROR);
+    }
+
+    auto const spec = static_cast<TypeSpec>(tag);
+    switch (spec) {
+    case TypeSpec::POINTER: return PointerType::get(read_type());
+    case TypeSpec::ARRAY: {
+        auto const has_length = read_u32() != 0;
+        auto const length = read_u32();
+        auto const sub_type = read_type();
+        return has_length ? ArrayType::get(sub_type, length) : ArrayType::get(sub_type);
+    }
+    case TypeSpec::CLASS:
+    case TypeSpec::ENUM: {
+        auto const filepath = read_string();
+        auto const name = Symbol{read_string()};
+        auto* const owner = (filepath == module_->get_filepath()) ? module_ : (*resolve_)(filepath);
+        if (owner and spec == TypeSpec::CLASS) {
+            for (auto const& class_ : owner->get_classes()) {
+                if (class_->get_symbol() == name) {
+                    return ClassType::get(class_);
+                }
+            }
+        }
+        else if (owner) {
+            if (auto const enum_ = owner->get_enum(name)) {
+                return EnumType::get(*enum_);
+            }
+        }
+        break;
+    }
+    case TypeSpec::ERROR:
+    case TypeSpec::MURKY:
+    case TypeSpec::IMPORT: break;
+    default: return Type::get(spec);
+    }
+    failed_ = true;
+    return Type::get(TypeSpec::ERROR);
+}
+
+auto InterfaceReader::read_paras() -> std::vector<ParaDecl*> {
+    auto paras = std::vector<ParaDecl*>{};
+    for (auto n = read_u32(); n > 0 and !failed_; --n) {
+        auto const header = read_decl();
+        auto const para = make_node<ParaDecl>(header.pos, header.ident, read_type());
+        set_flags(para, header.flags);
+        paras.push_back(para);
+    }
+    return paras;
+}
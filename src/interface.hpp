@@ -0,0 +1,106 @@
+#ifndef INTERFACE_HPP
+#define INTERFACE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./module.hpp"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+// A module's interface (.xppi) is everything the modules depending on it are verified against, as it stood once the
+// module verified: the signatures of its functions, externs, methods and constructors, its classes' fields, its
+// enums and the types of its globals. Bodies are left out, so an interface is enough to verify against but not to
+// generate code from.
+//
+// Integers are little endian u32s and strings a length followed by their bytes. After "XPPI", the version and the
+// key the interface was written under come the module's imports and usings, so a dependency graph can be built from
+// interfaces alone, then its enums, classes, externs, globals and functions. Classes and enums named by a type are
+// written as the file of the module declaring them followed by their name, and positions as a byte offset into the
+// module's source followed by a length.
+class InterfaceWriter {
+ public:
+    InterfaceWriter(AllModules const& modules);
+
+    // Nothing is written for a module with a declaration the format can't hold, e.g. one that failed to verify
+    auto write(Module const& module) -> std::optional<std::string>;
+
+ private:
+    auto write_u32(uint32_t value) -> void;
+    auto write_string(llvm::StringRef str) -> void;
+    auto write_filepaths(llvm::ArrayRef<std::pair<std::string, bool>> filepaths) -> void;
+    // Position, name and flags, which every declaration starts with
+    auto write_decl(Decl const* decl) -> void;
+    auto write_type(Type const* type) -> void;
+    auto write_paras(std::vector<ParaDecl*> const& paras) -> void;
+
+    std::string buffer_ = {};
+    bool failed_ = false;
+    // The file of the module every class and enum was declared in
+    std::unordered_map<Decl const*, std::string> owners_ = {};
+};
+
+class InterfaceReader {
+ public:
+    InterfaceReader(std::unique_ptr<llvm::MemoryBuffer> buffer)
+    : buffer_(std::move(buffer)) {}
+
+    // Reads up to the declarations, false if this isn't an interface written by this version of the format
+    auto read_header() -> bool;
+
+    auto get_key() const -> std::string const& {
+        return key_;
+    }
+
+    auto get_imported_filepaths() const -> llvm::ArrayRef<std::pair<std::string, bool>> {
+        return imported_files_;
+    }
+
+    auto get_using_filepaths() const -> llvm::ArrayRef<std::pair<std::string, bool>> {
+        return using_files_;
+    }
+
+    // Finds the module loaded from a file, null if it hasn't been
+    using Resolver = std::function<Module*(std::string const& filepath)>;
+
+    // Makes the module the header belongs to, null if the interface is corrupt or names a class or enum that isn't
+    // declared where it says. The classes and enums of other modules are found through resolve, and positions are put
+    // in the file numbered file, the module's source
+    auto read_module(std::string const& filepath, uint16_t file, Resolver const& resolve) -> std::shared_ptr<Module>;
+
+ private:
+    auto read_u32() -> uint32_t;
+    auto read_string() -> std::string;
+    auto read_filepaths() -> std::vector<std::pair<std::string, bool>>;
+
+    struct DeclHeader {
+        Position pos;
+        Symbol ident;
+        uint32_t flags;
+    };
+
+    auto read_decl() -> DeclHeader;
+    static auto set_flags(Decl* decl, uint32_t flags) -> void;
+    auto read_type() -> Type*;
+    auto read_paras() -> std::vector<ParaDecl*>;
+
+    std::unique_ptr<llvm::MemoryBuffer> buffer_;
+    size_t offset_ = 0;
+    bool failed_ = false;
+    std::string key_ = {};
+    std::vector<std::pair<std::string, bool>> imported_files_ = {};
+    std::vector<std::pair<std::string, bool>> using_files_ = {};
+    Module* module_ = nullptr;
+    uint16_t file_ = 0;
+    Resolver const* resolve_ = nullptr;
+};
+
+#endif // INTERFACE_HPP
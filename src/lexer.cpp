@@ -1,5 +1,6 @@
 #include "./lexer.hpp"
 
+#include <algorithm>
 #include <cctype>
 #include <iostream>
 
@@ -8,279 +9,303 @@ auto isalpha_or_under(const char& c) -> bool {
 }
 
 auto Lexer::peek(char c, int j) -> bool {
-    return current_pos_ + j < contents_->size() and (*contents_)[current_pos_ + j] == c;
+    return current_pos_ + j < contents_.size() and contents_[current_pos_ + j] == c;
 }
 
-auto Lexer::tokenize() -> std::vector<std::shared_ptr<Token>> {
-    auto tokens = std::vector<std::shared_ptr<Token>>{};
-
-    contents_ = handler_->get_file_contents(filename_);
-    auto const size = contents_->size();
-
-    while (current_pos_ < size) {
-        skip_whitespace_and_comments();
-        auto const& t = generate_token();
-        if (t.has_value()) {
-            tokens.emplace_back(std::make_shared<Token>(*t));
-        }
-        else {
-            break;
-        }
+auto Lexer::next() -> std::optional<Token> {
+    skip_whitespace_and_comments();
+    auto token = generate_token();
+    if (token) {
+        ++num_tokens_;
+    }
+    else if (!is_finished_) {
+        is_finished_ = true;
+        handler_->stats.add_count("tokens", num_tokens_);
     }
+    return token;
+}
 
+auto Lexer::tokenize() -> std::vector<Token> {
+    auto const phase = handler_->stats.phase("lex", filename_);
+    auto tokens = std::vector<Token>{};
+    // Roughly one token per six bytes of source keeps regrowth rare
+    tokens.reserve(contents_.size() / 6);
+    while (auto const token = next()) {
+        tokens.push_back(*token);
+    }
     return tokens;
 }
 
 auto Lexer::generate_token() -> std::optional<Token> {
-    if (current_pos_ >= contents_->size()) {
+    if (current_pos_ >= contents_.size()) {
         return std::nullopt;
     }
 
-    switch ((*contents_)[current_pos_]) {
+    switch (contents_[current_pos_]) {
     case '.': {
         if (peek('.', 1) and peek('.', 2)) {
             consume();
             consume();
             consume();
-            return Token{"...", line_, col_ - 1, col_ - 1, TokenType::TYPE};
+            return Token{"...", at(1), TokenType::TYPE};
         }
-        if (current_pos_ + 1 < contents_->size() and isdigit((*contents_)[current_pos_ + 1])) {
-            auto buf = std::string{"0"};
-            buf += consume();
-            while (current_pos_ < contents_->size() and isdigit((*contents_)[current_pos_])) {
-                buf += consume();
+        if (current_pos_ + 1 < contents_.size() and isdigit(contents_[current_pos_ + 1])) {
+            auto const start = current_pos_;
+            consume();
+            while (current_pos_ < contents_.size() and isdigit(contents_[current_pos_])) {
+                consume();
             }
-            return Token{buf, line_, col_ - buf.size(), col_ - 1, TokenType::FLOAT_LITERAL};
+            auto const lexeme = handler_->store_lexeme("0" + std::string{source_from(start)});
+            return Token{lexeme, at(lexeme.size()), TokenType::FLOAT_LITERAL};
         }
         consume();
-        return Token{".", line_, col_ - 1, col_ - 1, TokenType::DOT};
+        return Token{".", at(1), TokenType::DOT};
     }
     case '>': {
         consume();
         if (peek('=')) {
             consume();
-            return Token{">=", line_, col_ - 2, col_ - 1, TokenType::GREATER_EQUAL};
+            return Token{">=", at(2), TokenType::GREATER_EQUAL};
         }
-        return Token{">", line_, col_ - 1, col_ - 1, TokenType::GREATER_THAN};
+        return Token{">", at(1), TokenType::GREATER_THAN};
     }
     case '<': {
         consume();
         if (peek('=')) {
             consume();
-            return Token{"<=", line_, col_ - 2, col_ - 1, TokenType::LESS_EQUAL};
+            return Token{"<=", at(2), TokenType::LESS_EQUAL};
         }
-        return Token{"<", line_, col_ - 1, col_ - 1, TokenType::LESS_THAN};
+        return Token{"<", at(1), TokenType::LESS_THAN};
     }
-    case '{': consume(); return Token{"{", line_, col_ - 1, col_ - 1, TokenType::OPEN_CURLY};
-    case '}': consume(); return Token{"}", line_, col_ - 1, col_ - 1, TokenType::CLOSE_CURLY};
-    case '[': consume(); return Token{"[", line_, col_ - 1, col_ - 1, TokenType::OPEN_SQUARE};
-    case ']': consume(); return Token{"]", line_, col_ - 1, col_ - 1, TokenType::CLOSE_SQUARE};
+    case '{': consume(); return Token{"{", at(1), TokenType::OPEN_CURLY};
+    case '}': consume(); return Token{"}", at(1), TokenType::CLOSE_CURLY};
+    case '[': consume(); return Token{"[", at(1), TokenType::OPEN_SQUARE};
+    case ']': consume(); return Token{"]", at(1), TokenType::CLOSE_SQUARE};
     case ':': {
         consume();
         if (peek(':')) {
             consume();
-            return Token{"::", line_, col_ - 2, col_ - 1, TokenType::DOUBLE_COLON};
+            return Token{"::", at(2), TokenType::DOUBLE_COLON};
         }
-        return Token{":", line_, col_ - 1, col_ - 1, TokenType::COLON};
+        return Token{":", at(1), TokenType::COLON};
     }
-    case ';': consume(); return Token{";", line_, col_ - 1, col_ - 1, TokenType::SEMICOLON};
-    case '(': consume(); return Token{"(", line_, col_ - 1, col_ - 1, TokenType::OPEN_BRACKET};
-    case ')': consume(); return Token{")", line_, col_ - 1, col_ - 1, TokenType::CLOSE_BRACKET};
-    case ',': consume(); return Token{",", line_, col_ - 1, col_ - 1, TokenType::COMMA};
+    case ';': consume(); return Token{";", at(1), TokenType::SEMICOLON};
+    case '(': consume(); return Token{"(", at(1), TokenType::OPEN_BRACKET};
+    case ')': consume(); return Token{")", at(1), TokenType::CLOSE_BRACKET};
+    case ',': consume(); return Token{",", at(1), TokenType::COMMA};
     case '=': {
         consume();
         if (peek('=')) {
             consume();
-            return Token{"==", line_, col_ - 1, col_ - 1, TokenType::EQUAL};
+            return Token{"==", at(1), TokenType::EQUAL};
         }
-        return Token{"=", line_, col_ - 1, col_ - 1, TokenType::ASSIGN};
+        return Token{"=", at(1), TokenType::ASSIGN};
     }
     case '!': {
         consume();
         if (peek('=')) {
             consume();
-            return Token{"!=", line_, col_ - 1, col_ - 1, TokenType::NOT_EQUAL};
+            return Token{"!=", at(1), TokenType::NOT_EQUAL};
         }
-        return Token{"!", line_, col_ - 1, col_ - 1, TokenType::NEGATE};
+        return Token{"!", at(1), TokenType::NEGATE};
     }
     case '|': {
         consume();
         if (peek('|')) {
             consume();
-            return Token{"||", line_, col_ - 2, col_ - 1, TokenType::LOGICAL_OR};
+            return Token{"||", at(2), TokenType::LOGICAL_OR};
         }
-        std::cerr << "Unexpected character '|' at line " << line_ << ", column " << col_ << "\n";
-        exit(EXIT_FAILURE);
+        handler_->report_fatal_error(filename_, "Unexpected character '%'", "|", at(1));
     }
     case '&': {
         consume();
         if (peek('&')) {
             consume();
-            return Token{"&&", line_, col_ - 2, col_ - 1, TokenType::LOGICAL_AND};
+            return Token{"&&", at(2), TokenType::LOGICAL_AND};
         }
-        return Token{"&", line_, col_ - 1, col_ - 1, TokenType::AMPERSAND};
+        return Token{"&", at(1), TokenType::AMPERSAND};
     }
     case '-': {
         consume();
         if (peek('-')) {
             consume();
-            return Token{"--", line_, col_ - 2, col_ - 1, TokenType::MINUS_MINUS};
+            return Token{"--", at(2), TokenType::MINUS_MINUS};
         }
         else if (peek('>')) {
             consume();
-            return Token{"->", line_, col_ - 2, col_ - 1, TokenType::ARROW};
+            return Token{"->", at(2), TokenType::ARROW};
         }
         else if (peek('=')) {
             consume();
-            return Token{"-=", line_, col_ - 2, col_ - 1, TokenType::MINUS_ASSIGN};
+            return Token{"-=", at(2), TokenType::MINUS_ASSIGN};
         }
-        return Token{"-", line_, col_ - 1, col_ - 1, TokenType::MINUS};
+        return Token{"-", at(1), TokenType::MINUS};
     }
     case '+': {
         consume();
         if (peek('+')) {
             consume();
-            return Token{"++", line_, col_ - 2, col_ - 1, TokenType::PLUS_PLUS};
+            return Token{"++", at(2), TokenType::PLUS_PLUS};
         }
         else if (peek('=')) {
             consume();
-            return Token{"+=", line_, col_ - 2, col_ - 1, TokenType::PLUS_ASSIGN};
+            return Token{"+=", at(2), TokenType::PLUS_ASSIGN};
         }
-        return Token{"+", line_, col_ - 1, col_ - 1, TokenType::PLUS};
+        return Token{"+", at(1), TokenType::PLUS};
     }
     case '/': {
         consume();
         if (peek('=')) {
             consume();
-            return Token{"/=", line_, col_ - 2, col_ - 1, TokenType::DIVIDE_ASSIGN};
+            return Token{"/=", at(2), TokenType::DIVIDE_ASSIGN};
         }
-        return Token{"/", line_, col_ - 1, col_ - 1, TokenType::DIVIDE};
+        return Token{"/", at(1), TokenType::DIVIDE};
     }
     case '*': {
         consume();
         if (peek('=')) {
             consume();
-            return Token{"*=", line_, col_ - 2, col_ - 1, TokenType::MULTIPLY_ASSIGN};
+            return Token{"*=", at(2), TokenType::MULTIPLY_ASSIGN};
         }
-        return Token{"*", line_, col_ - 1, col_ - 1, TokenType::MULTIPLY};
+        return Token{"*", at(1), TokenType::MULTIPLY};
     }
-    case '%': consume(); return Token{"%", line_, col_ - 1, col_ - 1, TokenType::MODULO};
+    case '%': consume(); return Token{"%", at(1), TokenType::MODULO};
     case '"': {
         consume();
+        auto const start = current_pos_;
         auto buf = std::string{};
-        while (current_pos_ < contents_->size() and !peek('"')) {
+        auto has_escape = false;
+        while (current_pos_ < contents_.size() and !peek('"')) {
             if (peek('\n')) {
-                std::cerr << "ERROR: Currently not supporting multiline strings\n";
-                exit(EXIT_FAILURE);
+                handler_->report_fatal_error(filename_, "Currently not supporting multiline strings", "", at(0));
             }
 
             if (peek('\\')) {
                 if (!valid_escape()) {
-                    std::cerr << "ERROR: Invalid escape sequence\n";
-                    exit(EXIT_FAILURE);
+                    handler_->report_fatal_error(filename_, "Invalid escape sequence", "", at(0));
                 }
                 else {
                     consume();
                     buf += consume_escape();
+                    has_escape = true;
                 }
             }
             else {
                 buf += consume();
             }
         }
+        // Only escaped literals differ from their source text
+        auto const lexeme = (has_escape) ? handler_->store_lexeme(std::move(buf)) : source_from(start);
         consume();
-        return Token{buf, line_, col_ - buf.size(), col_ - 1, TokenType::STRING_LITERAL};
+        return Token{lexeme, at(lexeme.size()), TokenType::STRING_LITERAL};
     }
     case '\'': {
         consume();
+        auto const start = current_pos_;
         auto buf = std::string{};
-        while (current_pos_ < contents_->size() and !peek('\'')) {
+        auto has_escape = false;
+        while (current_pos_ < contents_.size() and !peek('\'')) {
             if (peek('\n')) {
-                std::cerr << "ERROR: Currently not supporting multiline chars\n";
-                exit(EXIT_FAILURE);
+                handler_->report_fatal_error(filename_, "Currently not supporting multiline chars", "", at(0));
             }
 
             if (peek('\\')) {
                 if (!valid_escape()) {
-                    std::cerr << "ERROR: Invalid escape sequence\n";
-                    exit(EXIT_FAILURE);
+                    handler_->report_fatal_error(filename_, "Invalid escape sequence", "", at(0));
                 }
                 else {
                     consume();
                     buf += consume_escape();
+                    has_escape = true;
                 }
             }
             else {
                 buf += consume();
             }
         }
+        // Only escaped literals differ from their source text
+        auto const lexeme = (has_escape) ? handler_->store_lexeme(std::move(buf)) : source_from(start);
         consume();
-        return Token{buf, line_, col_ - buf.size(), col_ - 1, TokenType::CHAR_LITERAL};
+        return Token{lexeme, at(lexeme.size()), TokenType::CHAR_LITERAL};
     }
     }
 
-    auto buf = std::string{};
-    if (current_pos_ < contents_->size() and isalpha_or_under((*contents_)[current_pos_])) {
-        while (current_pos_ < contents_->size()
-               and (isalpha_or_under((*contents_)[current_pos_]) or isdigit((*contents_)[current_pos_])))
+    auto const start = current_pos_;
+    if (current_pos_ < contents_.size() and isalpha_or_under(contents_[current_pos_])) {
+        while (current_pos_ < contents_.size()
+               and (isalpha_or_under(contents_[current_pos_]) or isdigit(contents_[current_pos_])))
         {
-            buf += consume();
+            consume();
         }
     }
 
-    if (!buf.empty()) {
-        if (buf == "else" and else_if_case()) {
-            buf += consume();
-            buf += consume();
-            buf += consume();
+    if (current_pos_ != start) {
+        if (source_from(start) == "else" and else_if_case()) {
+            consume();
+            consume();
+            consume();
         }
-        auto const type = get_type_from_lexeme(buf);
+        auto const lexeme = source_from(start);
+        auto const type = get_type_from_lexeme(lexeme);
         if (type.has_value()) {
-            return Token{buf, line_, col_ - buf.size(), col_ - 1, *type};
+            return Token{lexeme, at(lexeme.size()), *type};
         }
         else {
-            return Token{buf, line_, col_ - buf.size(), col_ - 1, TokenType::IDENT};
+            auto token = Token{lexeme, at(lexeme.size()), TokenType::IDENT};
+            token.set_symbol(Symbol{lexeme});
+            return token;
         }
     }
 
     auto is_float = false;
-    if (current_pos_ < contents_->size() and isdigit((*contents_)[current_pos_])) {
-        while (current_pos_ < contents_->size() and isdigit((*contents_)[current_pos_])) {
-            buf += consume();
+    if (current_pos_ < contents_.size() and isdigit(contents_[current_pos_])) {
+        while (current_pos_ < contents_.size() and isdigit(contents_[current_pos_])) {
+            consume();
         }
         if (peek('.')) {
             is_float = true;
-            buf += consume();
+            consume();
         }
-        while (current_pos_ < contents_->size() and isdigit((*contents_)[current_pos_])) {
-            buf += consume();
+        while (current_pos_ < contents_.size() and isdigit(contents_[current_pos_])) {
+            consume();
         }
     }
 
-    if (!buf.empty()) {
+    if (current_pos_ != start) {
+        auto const lexeme = source_from(start);
         if (peek('u')) {
             consume();
-            return Token{buf, line_, col_ - buf.size(), col_ - 1, TokenType::UNSIGNED_INTEGER};
+            return Token{lexeme, at(lexeme.size()), TokenType::UNSIGNED_INTEGER};
         }
         if (is_float) {
-            return Token{buf, line_, col_ - buf.size(), col_ - 1, TokenType::FLOAT_LITERAL};
+            return Token{lexeme, at(lexeme.size()), TokenType::FLOAT_LITERAL};
         }
         else {
-            return Token{buf, line_, col_ - buf.size(), col_ - 1, TokenType::INTEGER};
+            return Token{lexeme, at(lexeme.size()), TokenType::INTEGER};
         }
     }
 
-    if (current_pos_ < contents_->size()) {
-        std::cerr << "Unexpected character '" << (*contents_)[current_pos_] << "' at line " << line_ << ", column "
-                  << col_ << "\n";
-        exit(EXIT_FAILURE);
+    if (current_pos_ < contents_.size()) {
+        handler_->report_fatal_error(filename_,
+                                     "Unexpected character '%'",
+                                     std::string{contents_[current_pos_]},
+                                     Position{static_cast<uint32_t>(current_pos_), file_, 1});
     }
 
     return std::nullopt;
 }
 
+auto Lexer::at(size_t length) const -> Position {
+    length = std::min(length, current_pos_);
+    return Position{static_cast<uint32_t>(current_pos_ - length), file_, static_cast<uint16_t>(length)};
+}
+
+auto Lexer::source_from(size_t start) const -> std::string_view {
+    return contents_.substr(start, current_pos_ - start);
+}
+
 auto Lexer::skip_whitespace() -> void {
-    while (current_pos_ < contents_->size() and isspace(contents_->at(current_pos_))) {
+    while (current_pos_ < contents_.size() and isspace(contents_.at(current_pos_))) {
         consume();
     }
 }
@@ -288,7 +313,7 @@ auto Lexer::skip_whitespace() -> void {
 auto Lexer::skip_whitespace_and_comments() -> void {
     skip_whitespace();
     if (peek('/') and peek('/', 1)) {
-        while (current_pos_ < contents_->size() and !peek('\n')) {
+        while (current_pos_ < contents_.size() and !peek('\n')) {
             consume();
         }
         consume();
@@ -311,19 +336,7 @@ auto Lexer::is_comment() -> bool {
 }
 
 auto Lexer::consume() -> char {
-    auto const curr_char = contents_->at(current_pos_);
-    if (curr_char == '\n') {
-        ++line_;
-        col_ = 1;
-    }
-    else if (curr_char == '\t') {
-        col_ += 4;
-    }
-    else {
-        ++col_;
-    }
-    ++current_pos_;
-    return curr_char;
+    return contents_.at(current_pos_++);
 }
 
 auto Lexer::consume_escape() -> char {
@@ -6,17 +6,23 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Lexer {
  public:
     Lexer(const std::string filename, const std::shared_ptr<Handler>& handler)
     : filename_{filename}
-    , handler_{handler} {}
+    , handler_{handler}
+    , contents_{handler->get_file_contents(filename)}
+    , file_{handler->file_id(filename)} {}
 
     ~Lexer() = default;
 
-    auto tokenize() -> std::vector<std::shared_ptr<Token>>;
+    // Lexes tokens one at a time as they're asked for, nothing once the source runs out
+    auto next() -> std::optional<Token>;
+    // Every token of the source at once
+    auto tokenize() -> std::vector<Token>;
 
  private:
     auto skip_whitespace() -> void;
@@ -28,11 +34,17 @@ class Lexer {
     auto valid_escape() -> bool;
     auto else_if_case() -> bool;
     auto peek(char c, int j = 0) -> bool;
+    auto source_from(size_t start) const -> std::string_view;
+    // The last length bytes consumed
+    auto at(size_t length) const -> Position;
 
     const std::string filename_;
     std::shared_ptr<Handler> handler_;
-    std::shared_ptr<std::string> contents_;
-    size_t current_pos_ = 0, line_ = 1, col_ = 1;
+    std::string_view contents_;
+    uint16_t file_ = 0;
+    size_t current_pos_ = 0;
+    size_t num_tokens_ = 0;
+    bool is_finished_ = false;
 };
 
 #endif // LEXER_HPP
\ No newline at end of file
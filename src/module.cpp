@@ -28,112 +28,160 @@ auto operator<<(std::ostream& os, Module const& mod) -> std::ostream& {
     return os;
 }
 
-auto Module::get_constructor_decl(std::shared_ptr<ConstructorCallExpr> constructor_call_expr, bool is_recursive) const
-    -> std::optional<std::shared_ptr<ConstructorDecl>> {
-    auto it = std::find_if(classes_.begin(), classes_.end(), [&constructor_call_expr](auto const& class_) {
-        return class_->get_ident() == constructor_call_expr->get_name();
-    });
-    if (it != classes_.end()) {
-        for (auto& constructor : (*it)->get_constructors()) {
-            auto const& call_args = constructor_call_expr->get_args();
-            auto const& constructor_args = constructor->get_paras();
-            if (call_args.size() != constructor_args.size()) {
-                continue;
-            }
-            bool match = true;
-            for (auto i = 0u; i < call_args.size(); ++i) {
-                if (!call_args[i]->get_type()->equal_soft(*constructor_args[i]->get_type())) {
-                    match = false;
-                    break;
-                }
-            }
-            if (match) {
+auto Module::get_constructor_decl(ConstructorCallExpr* constructor_call_expr, bool is_recursive) const
+    -> std::optional<ConstructorDecl*> {
+    if (!is_recursive) {
+        auto const it = overloads_.find(constructor_call_expr->get_symbol());
+        return (it != overloads_.end()) ? resolve_constructor(it->second, constructor_call_expr) : std::nullopt;
+    }
+
+    auto const it = visible_overloads_.find(constructor_call_expr->get_symbol());
+    if (it != visible_overloads_.end()) {
+        for (auto const* overloads : it->second) {
+            if (auto constructor = resolve_constructor(*overloads, constructor_call_expr)) {
                 return constructor;
             }
         }
     }
+    return std::nullopt;
+}
 
-    if (is_recursive) {
-        for (auto& mod : using_modules) {
-            auto constructor = mod.second->get_constructor_decl(constructor_call_expr, false);
-            if (constructor) {
-                return constructor;
+auto Module::get_decl(CallExpr* call_expr, bool is_recursive) const -> std::optional<Decl*> {
+    if (!is_recursive) {
+        auto const it = overloads_.find(call_expr->get_symbol());
+        return (it != overloads_.end()) ? resolve_call(it->second, call_expr) : std::nullopt;
+    }
+
+    auto const it = visible_overloads_.find(call_expr->get_symbol());
+    if (it != visible_overloads_.end()) {
+        for (auto const* overloads : it->second) {
+            if (auto decl = resolve_call(*overloads, call_expr)) {
+                return decl;
             }
         }
     }
-
     return std::nullopt;
 }
 
-auto Module::get_decl(std::shared_ptr<CallExpr> call_expr, bool is_recursive) const
-    -> std::optional<std::shared_ptr<Decl>> {
-    auto it = std::find_if(functions_.begin(), functions_.end(), [&call_expr](auto const& func) {
-        auto dot_pos = func->get_ident().find('.');
-        auto prefix = func->get_ident().substr(0, dot_pos);
-        if (prefix != call_expr->get_name()) {
-            return false;
+auto Module::function_with_name_exists(Symbol const name) const -> bool {
+    auto const it = visible_overloads_.find(name);
+    if (it != visible_overloads_.end()) {
+        for (auto const* overloads : it->second) {
+            if (!overloads->functions.empty() or !overloads->externs.empty()) {
+                return true;
+            }
+        }
+    }
+    // Names only reachable through a using module's own using modules are still known, just not resolvable
+    for (auto& mod : using_modules) {
+        if (mod.second->function_with_name_exists(name)) {
+            return true;
         }
-        auto const& call_args = call_expr->get_args();
+    }
+    return false;
+}
+
+auto Module::index_using_modules() -> void {
+    visible_overloads_.clear();
+    for (auto const& [name, overloads] : overloads_) {
+        visible_overloads_[name].push_back(&overloads);
+    }
+    for (auto const& mod : using_modules) {
+        for (auto const& [name, overloads] : mod.second->overloads_) {
+            visible_overloads_[name].push_back(&overloads);
+        }
+    }
+}
+
+auto Module::attach_dependencies(AllModules const& modules) -> void {
+    for (auto const& import : imported_files) {
+        add_imported_module(import.first, modules.get_module_from_filepath(import.first));
+    }
+    for (auto const& using_ : using_files) {
+        add_using_module(using_.first, modules.get_module_from_filepath(using_.first));
+    }
+    index_using_modules();
+}
+
+auto Module::resolve_call(OverloadSet const& overloads, CallExpr* call_expr) -> std::optional<Decl*> {
+    auto const& call_args = call_expr->get_args();
+    for (auto const& func : overloads.functions) {
         auto const& func_args = func->get_paras();
         if (call_args.size() != func_args.size()) {
-            return false;
+            continue;
         }
+        auto match = true;
         for (auto i = 0u; i < call_args.size(); ++i) {
-            if (!func_args[i]->get_type()->equal_soft(*call_args[i]->get_type())) {
-                return false;
+            // Types being unique, an argument of exactly the parameter's type needs no further comparing
+            auto const para_type = func_args[i]->get_type();
+            auto const arg_type = call_args[i]->get_type();
+            if (para_type != arg_type and !para_type->equal_soft(*arg_type)) {
+                match = false;
+                break;
             }
         }
-        return true;
-    });
-    if (it != functions_.end()) {
-        return std::optional{*it};
+        if (match) {
+            return func;
+        }
     }
 
-    auto it2 = std::find_if(externs_.begin(), externs_.end(), [&call_expr](auto const& extern_) {
-        if (extern_->get_ident() != call_expr->get_name()) {
-            return false;
-        }
-        auto const& call_args = call_expr->get_args();
+    for (auto const& extern_ : overloads.externs) {
         auto const& func_args = extern_->get_types();
-
         if (extern_->is_variatic()) {
             if (call_args.size() < func_args.size() - 1) {
-                return false;
+                continue;
             }
         }
         else {
             if (call_args.size() != func_args.size()) {
-                return false;
+                continue;
             }
         }
 
+        auto match = true;
         for (auto i = 0u; i < func_args.size() - 1; ++i) {
-            if (!call_args[i]->get_type()->equal_soft(*func_args[i])) {
-                return false;
+            if (call_args[i]->get_type() != func_args[i] and !call_args[i]->get_type()->equal_soft(*func_args[i])) {
+                match = false;
+                break;
             }
         }
-        return true;
-    });
-
-    if (it2 != externs_.end()) {
-        return std::optional{*it2};
+        if (match) {
+            return extern_;
+        }
     }
+    return std::nullopt;
+}
 
-    if (is_recursive) {
-        for (auto& mod : using_modules) {
-            auto decl = mod.second->get_decl(call_expr, false);
-            if (decl) {
-                return decl;
+auto Module::resolve_constructor(OverloadSet const& overloads, ConstructorCallExpr* constructor_call_expr)
+    -> std::optional<ConstructorDecl*> {
+    if (!overloads.class_) {
+        return std::nullopt;
+    }
+    auto const& call_args = constructor_call_expr->get_args();
+    for (auto& constructor : overloads.class_->get_constructors()) {
+        auto const& constructor_args = constructor->get_paras();
+        if (call_args.size() != constructor_args.size()) {
+            continue;
+        }
+        bool match = true;
+        for (auto i = 0u; i < call_args.size(); ++i) {
+            auto const arg_type = call_args[i]->get_type();
+            auto const para_type = constructor_args[i]->get_type();
+            if (arg_type != para_type and !arg_type->equal_soft(*para_type)) {
+                match = false;
+                break;
             }
         }
+        if (match) {
+            return constructor;
+        }
     }
-
     return std::nullopt;
 }
 
-auto Module::get_enum(std::string enum_name) const -> std::optional<std::shared_ptr<EnumDecl>> {
-    auto it = std::find_if(enums_.begin(), enums_.end(), [&enum_name](auto const& enum_) {
-        return enum_->get_ident() == enum_name;
+auto Module::get_enum(Symbol const enum_name) const -> std::optional<EnumDecl*> {
+    auto it = std::find_if(enums_.begin(), enums_.end(), [enum_name](auto const& enum_) {
+        return enum_->get_symbol() == enum_name;
     });
     return (it != enums_.end()) ? std::optional{*it} : std::nullopt;
 }
\ No newline at end of file
@@ -2,54 +2,68 @@
 #define MODULE_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <unordered_map>
 
 #include "./ast.hpp"
 #include "./decl.hpp"
 
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/iterator.h"
+
+class AllModules;
+
 class Module {
  public:
     Module(std::string filepath)
     : filepath_(filepath) {}
 
-    auto add_function(std::shared_ptr<Function> func) -> void {
+    auto add_function(Function* func) -> void {
         functions_.push_back(func);
+        overloads_[func->get_symbol()].functions.push_back(func);
     }
 
-    auto add_extern(std::shared_ptr<Extern> extern_) -> void {
+    auto add_extern(Extern* extern_) -> void {
         externs_.push_back(extern_);
+        overloads_[extern_->get_symbol()].externs.push_back(extern_);
     }
 
-    auto add_global_var(std::shared_ptr<GlobalVarDecl> global_var) -> void {
+    auto add_global_var(GlobalVarDecl* global_var) -> void {
         global_vars_.push_back(global_var);
     }
 
-    auto add_enums(std::shared_ptr<EnumDecl> enum_) -> void {
+    auto add_enums(EnumDecl* enum_) -> void {
         enums_.push_back(enum_);
     }
 
-    auto add_class(std::shared_ptr<ClassDecl> class_) -> void {
+    auto add_class(ClassDecl* class_) -> void {
         classes_.push_back(class_);
+        auto& overloads = overloads_[class_->get_symbol()];
+        if (!overloads.class_) {
+            overloads.class_ = class_;
+        }
     }
 
     auto get_filepath() const -> std::string const& {
         return filepath_;
     }
 
-    auto get_functions() const -> std::vector<std::shared_ptr<Function>> {
+    auto get_functions() const -> llvm::ArrayRef<Function*> {
         return functions_;
     }
 
-    auto get_externs() const -> std::vector<std::shared_ptr<Extern>> {
+    auto get_externs() const -> llvm::ArrayRef<Extern*> {
         return externs_;
     }
 
-    auto get_global_vars() const -> std::vector<std::shared_ptr<GlobalVarDecl>> {
+    auto get_global_vars() const -> llvm::ArrayRef<GlobalVarDecl*> {
         return global_vars_;
     }
 
-    auto get_global_var(std::string const& name) -> std::optional<std::shared_ptr<GlobalVarDecl>> {
-        auto it = std::find_if(global_vars_.begin(), global_vars_.end(), [&name](auto const& global_var) {
-            return global_var->get_ident() == name;
+    auto get_global_var(Symbol const name) -> std::optional<GlobalVarDecl*> {
+        auto it = std::find_if(global_vars_.begin(), global_vars_.end(), [name](auto const& global_var) {
+            return global_var->get_symbol() == name;
         });
         if (it != global_vars_.end()) {
             return std::optional{*it};
@@ -57,19 +71,19 @@ class Module {
         return std::nullopt;
     }
 
-    auto get_enums() const -> std::vector<std::shared_ptr<EnumDecl>> {
+    auto get_enums() const -> llvm::ArrayRef<EnumDecl*> {
         return enums_;
     }
 
-    auto get_classes() const -> std::vector<std::shared_ptr<ClassDecl>> {
+    auto get_classes() const -> llvm::ArrayRef<ClassDecl*> {
         return classes_;
     }
 
-    auto get_imported_filepaths() const -> std::vector<std::pair<std::string, bool>> {
+    auto get_imported_filepaths() const -> llvm::ArrayRef<std::pair<std::string, bool>> {
         return imported_files;
     }
 
-    auto get_using_filepaths() const -> std::vector<std::pair<std::string, bool>> {
+    auto get_using_filepaths() const -> llvm::ArrayRef<std::pair<std::string, bool>> {
         return using_files;
     }
 
@@ -82,31 +96,14 @@ class Module {
         using_files.push_back({filepath, is_libc});
     }
 
-    auto class_with_name_exists(std::string const& name) const -> bool {
-        return std::any_of(classes_.begin(), classes_.end(), [&name](auto const& class_) {
-            return class_->get_ident() == name;
+    auto class_with_name_exists(Symbol const name) const -> bool {
+        return std::any_of(classes_.begin(), classes_.end(), [name](auto const& class_) {
+            return class_->get_symbol() == name;
         });
     }
 
     // NOTE: considers using modules second
-    auto function_with_name_exists(std::string const& name) const -> bool {
-        auto const user_func = std::any_of(functions_.begin(), functions_.end(), [&name](auto const& func) {
-            return func->get_ident() == name;
-        });
-        if (user_func)
-            return true;
-        auto const extern_func = std::any_of(externs_.begin(), externs_.end(), [&name](auto const& extern_) {
-            return extern_->get_ident() == name;
-        });
-        if (extern_func)
-            return true;
-        for (auto& mod : using_modules) {
-            if (mod.second->function_with_name_exists(name)) {
-                return true;
-            }
-        }
-        return false;
-    }
+    auto function_with_name_exists(Symbol const name) const -> bool;
 
     auto get_module_from_alias(std::string const& alias) const -> std::optional<std::shared_ptr<Module>> {
         auto it = alias_import_to_path.find(alias);
@@ -119,7 +116,7 @@ class Module {
     auto get_module_from_filepath(std::string const& filepath) const -> std::optional<std::shared_ptr<Module>> {
         for (const auto& module : imported_modules) {
             if (module.second->get_filepath() == filepath) {
-                return module.second;
+                return share(module.second);
             }
         }
         return std::nullopt;
@@ -133,18 +130,21 @@ class Module {
         using_modules[name] = module;
     }
 
-    auto get_using_modules() -> std::vector<std::shared_ptr<Module>> {
-        std::vector<std::shared_ptr<Module>> modules;
-        for (auto const& using_module : using_modules) {
-            modules.push_back(using_module.second);
-        }
-        return modules;
+    // In name order, the order their declarations are visible in
+    auto get_using_modules() const {
+        return llvm::make_second_range(using_modules);
     }
 
-    auto get_decl(std::shared_ptr<CallExpr> call_expr, bool is_recursive) const -> std::optional<std::shared_ptr<Decl>>;
-    auto get_constructor_decl(std::shared_ptr<ConstructorCallExpr> constructor_call_expr, bool is_recursive) const
-        -> std::optional<std::shared_ptr<ConstructorDecl>>;
-    auto get_enum(std::string enum_name) const -> std::optional<std::shared_ptr<EnumDecl>>;
+    auto get_decl(CallExpr* call_expr, bool is_recursive) const -> std::optional<Decl*>;
+    auto get_constructor_decl(ConstructorCallExpr* constructor_call_expr, bool is_recursive) const
+        -> std::optional<ConstructorDecl*>;
+    auto get_enum(Symbol const enum_name) const -> std::optional<EnumDecl*>;
+
+    // Indexes what each using module declares under every name, called once they've all been loaded
+    auto index_using_modules() -> void;
+
+    // Resolves this module's imports and usings to the modules loaded for them, which must all be in modules
+    auto attach_dependencies(AllModules const& modules) -> void;
 
     auto set_is_lib(bool is_lib) -> void {
         is_lib_ = is_lib;
@@ -154,20 +154,79 @@ class Module {
         return is_lib_;
     }
 
+    // Declarations only, read back from the interface written the last time this module verified
+    auto set_is_interface() -> void {
+        is_interface_ = true;
+    }
+
+    auto is_interface() const -> bool {
+        return is_interface_;
+    }
+
+    // The precompiled library an interface was read alongside, which the module's definitions are linked in from
+    auto set_bitcode_path(std::string path) -> void {
+        bitcode_path_ = std::move(path);
+    }
+
+    auto get_bitcode_path() const -> std::string const& {
+        return bitcode_path_;
+    }
+
+    // Covers the module's source and everything it depends on, set whenever an interface could be read or written
+    auto set_cache_key(std::string key) -> void {
+        cache_key_ = std::move(key);
+    }
+
+    auto get_cache_key() const -> std::string const& {
+        return cache_key_;
+    }
+
+    // Owns every node parsed from this module, as well as those the verifier and emitter make for it
+    auto get_arena() -> Arena& {
+        return arena_;
+    }
+
+    // Copies of module handles made by the accessors that still return one, reported by -s/--stat
+    inline static std::atomic<size_t> num_refcounts{0};
+
+    static auto share(std::shared_ptr<Module> const& module) -> std::shared_ptr<Module> {
+        num_refcounts.fetch_add(1, std::memory_order_relaxed);
+        return module;
+    }
+
  private:
+    Arena arena_ = {};
     bool is_lib_ = false;
+    bool is_interface_ = false;
     std::string filepath_;
-    std::vector<std::shared_ptr<Function>> functions_ = {};
-    std::vector<std::shared_ptr<Extern>> externs_ = {};
-    std::vector<std::shared_ptr<GlobalVarDecl>> global_vars_ = {};
-    std::vector<std::shared_ptr<EnumDecl>> enums_ = {};
-    std::vector<std::shared_ptr<ClassDecl>> classes_ = {};
+    std::string cache_key_ = {};
+    std::string bitcode_path_ = {};
+    std::vector<Function*> functions_ = {};
+    std::vector<Extern*> externs_ = {};
+    std::vector<GlobalVarDecl*> global_vars_ = {};
+    std::vector<EnumDecl*> enums_ = {};
+    std::vector<ClassDecl*> classes_ = {};
 
     std::map<std::string, std::string> alias_import_to_path = {};
     std::vector<std::pair<std::string, bool>> imported_files = {};
     std::vector<std::pair<std::string, bool>> using_files = {};
     std::map<std::string, std::shared_ptr<Module>> imported_modules = {};
     std::map<std::string, std::shared_ptr<Module>> using_modules = {};
+
+    // Everything declared under one name, in the order overload resolution tries it
+    struct OverloadSet {
+        std::vector<Function*> functions = {};
+        std::vector<Extern*> externs = {};
+        ClassDecl* class_ = nullptr;
+    };
+
+    // Sets declared in this module, and the sets visible from it: its own then each using module's
+    std::unordered_map<Symbol, OverloadSet> overloads_ = {};
+    std::unordered_map<Symbol, std::vector<OverloadSet const*>> visible_overloads_ = {};
+
+    static auto resolve_call(OverloadSet const& overloads, CallExpr* call_expr) -> std::optional<Decl*>;
+    static auto resolve_constructor(OverloadSet const& overloads, ConstructorCallExpr* constructor_call_expr)
+        -> std::optional<ConstructorDecl*>;
 };
 
 auto operator<<(std::ostream& os, Module const& mod) -> std::ostream&;
@@ -185,6 +244,21 @@ class AllModules {
         add_module(module);
     }
 
+    // Swaps in another module loaded from the same file, keeping its place in the module order. The module swapped
+    // out is kept, as modules verified against it still point into it
+    auto replace_module(std::shared_ptr<Module> module) -> void {
+        for (auto& existing : modules_) {
+            if (existing->get_filepath() == module->get_filepath()) {
+                superseded_modules_.push_back(existing);
+                existing = module;
+            }
+        }
+    }
+
+    auto get_superseded_modules() const -> llvm::ArrayRef<std::shared_ptr<Module>> {
+        return superseded_modules_;
+    }
+
     auto module_exists_from_filename(std::string const& filename) const -> bool {
         for (const auto& module : modules_) {
             if (module->get_filepath() == filename) {
@@ -197,22 +271,34 @@ class AllModules {
     auto get_module_from_filepath(std::string const& filepath) const -> std::shared_ptr<Module> {
         for (const auto& module : modules_) {
             if (module->get_filepath() == filepath) {
-                return module;
+                return Module::share(module);
             }
         }
         return nullptr;
     }
 
-    auto get_modules() -> std::vector<std::shared_ptr<Module>> {
-        return modules_;
+    // Walks every module in the order they were first reached, as Module& rather than handles
+    using iterator = llvm::pointee_iterator<std::vector<std::shared_ptr<Module>>::const_iterator>;
+
+    auto begin() const -> iterator {
+        return iterator{modules_.begin()};
+    }
+
+    auto end() const -> iterator {
+        return iterator{modules_.end()};
+    }
+
+    auto size() const -> size_t {
+        return modules_.size();
     }
 
     auto get_main_module() const -> std::shared_ptr<Module> {
-        return main_module_;
+        return Module::share(main_module_);
     }
 
  private:
     std::vector<std::shared_ptr<Module>> modules_ = {};
+    std::vector<std::shared_ptr<Module>> superseded_modules_ = {};
     std::shared_ptr<Module> main_module_ = nullptr;
 };
 
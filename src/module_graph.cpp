@@ -0,0 +1,333 @@
+#include "./module_graph.hpp"
+#include "./lexer.hpp"
+#include "./object_cache.hpp"
+#include "./parser.hpp"
+#include "./verifier.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+
+auto ModuleGraph::load() -> void {
+    auto const main_module = modules_->get_main_module();
+    nodes_.push_back(Node{main_module->get_filepath(), main_module->is_lib(), main_module});
+    auto index = std::unordered_map<std::string, size_t>{{main_module->get_filepath(), 0}};
+
+    auto pool = llvm::ThreadPool{llvm::hardware_concurrency(handler_->get_jobs())};
+    for (auto level = size_t{0}; level < nodes_.size();) {
+        auto const next_level = nodes_.size();
+
+        // Number the modules first reached from this level in the order they're imported, so the graph (and the
+        // order diagnostics come out in) doesn't depend on which thread finishes first
+        for (auto i = level; i < next_level; ++i) {
+            auto const& node = nodes_[i];
+            auto const imports = node.module ? node.module->get_imported_filepaths()
+                                             : node.interface->get_imported_filepaths();
+            auto const usings =
+                node.module ? node.module->get_using_filepaths() : node.interface->get_using_filepaths();
+            auto const add_dependency = [this, &index, i](std::pair<std::string, bool> const& dependency) {
+                auto const [it, inserted] = index.try_emplace(dependency.first, nodes_.size());
+                if (inserted) {
+                    nodes_.push_back(Node{dependency.first, dependency.second});
+                }
+                auto& dependencies = nodes_[i].dependencies;
+                if (std::find(dependencies.begin(), dependencies.end(), it->second) == dependencies.end()) {
+                    dependencies.push_back(it->second);
+                }
+            };
+            for (auto const& import : imports) {
+                add_dependency(import);
+            }
+            for (auto const& using_ : usings) {
+                add_dependency(using_);
+            }
+        }
+
+        for (auto i = next_level; i < nodes_.size(); ++i) {
+            pool.async([this, i] {
+                handler_->traced([this, i] {
+                    auto& node = nodes_[i];
+                    if (!read_interface(node)) {
+                        parse(node);
+                    }
+                });
+            });
+        }
+        pool.wait();
+        exit_on_fatal_error();
+        level = next_level;
+    }
+
+    auto const has_interfaces = std::any_of(nodes_.begin(), nodes_.end(), [](Node const& node) {
+        return node.interface != nullptr;
+    });
+    if (has_interfaces or handler_->build_cache_mode() or handler_->precompile_mode()) {
+        load_interfaces(index);
+    }
+
+    for (auto i = size_t{0}; i < nodes_.size(); ++i) {
+        if (i != 0) {
+            modules_->add_module(nodes_[i].module);
+        }
+        for (auto const dependency : nodes_[i].dependencies) {
+            nodes_[dependency].dependents.push_back(i);
+        }
+    }
+
+    check_cycles();
+    if (handler_->num_errors_) {
+        print_diagnostics();
+    }
+}
+
+auto ModuleGraph::verify() -> void {
+    // A module is ready once none of its dependencies are left to verify
+    auto pending = std::vector<size_t>{};
+    for (auto const& node : nodes_) {
+        pending.push_back(node.dependencies.size());
+    }
+
+    auto pool = llvm::ThreadPool{llvm::hardware_concurrency(handler_->get_jobs())};
+    auto mutex = std::mutex{};
+    auto schedule = std::function<void(size_t)>{};
+    schedule = [&](size_t i) {
+        pool.async([&, i] {
+            handler_->traced([&] {
+                auto const& node = nodes_[i];
+                auto const diagnostics = Handler::DiagnosticScope{nodes_[i].diagnostics};
+                if (node.module->is_interface()) {
+                    node.module->attach_dependencies(*modules_);
+                    return;
+                }
+                auto verifier = std::make_shared<Verifier>(handler_, modules_);
+                verifier->check(node.module, i == 0 and !handler_->precompile_mode());
+                if (handler_->build_cache_mode() and i != 0) {
+                    write_interface(node);
+                }
+            });
+
+            auto const lock = std::lock_guard{mutex};
+            for (auto const dependent : nodes_[i].dependents) {
+                if (--pending[dependent] == 0) {
+                    schedule(dependent);
+                }
+            }
+        });
+    };
+
+    for (auto i = size_t{0}; i < nodes_.size(); ++i) {
+        if (pending[i] == 0) {
+            schedule(i);
+        }
+    }
+    pool.wait();
+    print_diagnostics();
+}
+
+auto ModuleGraph::load_bodies() -> void {
+    for (auto const i : post_order()) {
+        auto& node = nodes_[i];
+        if (!node.module->is_interface()) {
+            continue;
+        }
+        auto const interface = node.module;
+        parse(node);
+        exit_on_fatal_error();
+        node.module->set_cache_key(interface->get_cache_key());
+        modules_->replace_module(node.module);
+
+        auto const diagnostics = Handler::DiagnosticScope{node.diagnostics};
+        auto verifier = std::make_shared<Verifier>(handler_, modules_);
+        verifier->check(node.module, false);
+    }
+    print_diagnostics();
+}
+
+auto ModuleGraph::parse(Node& node) -> void {
+    auto const diagnostics = Handler::DiagnosticScope{node.diagnostics};
+    try {
+        auto lexer = Lexer(node.filepath, handler_);
+        auto parser = Parser(lexer, node.filepath, handler_);
+        node.module = parser.parse();
+        node.module->set_is_lib(node.is_lib);
+    }
+    catch (Handler::FatalError const&) {
+        node.has_fatal_error = true;
+    }
+}
+
+auto ModuleGraph::exit_on_fatal_error() -> void {
+    auto const has_fatal_error = std::any_of(nodes_.begin(), nodes_.end(), [](Node const& node) {
+        return node.has_fatal_error;
+    });
+    if (has_fatal_error) {
+        print_diagnostics();
+        exit(EXIT_FAILURE);
+    }
+}
+
+auto ModuleGraph::read_interface(Node& node) -> bool {
+    if (handler_->build_cache_mode()) {
+        node.source_hash =
+            BuildCache::hash(node.filepath + "\n" + std::string{handler_->get_file_contents(node.filepath)});
+    }
+
+    // A precompiled library comes with its definitions, so it's preferred to the build cache
+    auto buffer = std::unique_ptr<llvm::MemoryBuffer>{};
+    auto const precompiled =
+        std::filesystem::path{handler_->precompiled_path} / std::filesystem::path{node.filepath}.filename();
+    auto const bitcode_path = std::filesystem::path{precompiled}.replace_extension(".bc");
+    if (node.is_lib and std::filesystem::exists(bitcode_path)) {
+        auto const interface_path = std::filesystem::path{precompiled}.replace_extension(".xppi");
+        if (auto precompiled = llvm::MemoryBuffer::getFile(interface_path.string())) {
+            buffer = std::move(*precompiled);
+            node.bitcode_path = bitcode_path.string();
+        }
+    }
+    if (!buffer and handler_->build_cache_mode()) {
+        buffer = BuildCache{handler_->get_cache_dir() / "build"}.get_interface(node.source_hash);
+    }
+    if (!buffer) {
+        return false;
+    }
+
+    node.interface = std::make_unique<InterfaceReader>(std::move(buffer));
+    if (!node.interface->read_header()) {
+        node.interface = nullptr;
+        node.bitcode_path.clear();
+        return false;
+    }
+    return true;
+}
+
+auto ModuleGraph::load_interfaces(std::unordered_map<std::string, size_t> const& index) -> void {
+    auto const phase = handler_->stats.phase("interfaces");
+    auto const order = post_order();
+
+    // A module's key covers its source and the keys of everything it depends on, so an interface goes stale along
+    // with any module it was verified against
+    auto const stamp = BuildCache::compiler_stamp();
+    auto keys = std::vector<std::string>(nodes_.size());
+    auto stale = std::vector<size_t>{};
+    for (auto const i : order) {
+        auto& node = nodes_[i];
+        auto const is_main = i == 0 and !handler_->precompile_mode();
+        auto contents = stamp + "\n" + (is_main ? "main" : "module") + "\n" + node.filepath + "\n"
+                        + BuildCache::hash(handler_->get_file_contents(node.filepath));
+        for (auto const dependency : node.dependencies) {
+            contents += "\n" + keys[dependency];
+        }
+        keys[i] = BuildCache::hash(contents);
+        if (node.interface and node.interface->get_key() != keys[i]) {
+            node.interface = nullptr;
+            node.bitcode_path.clear();
+            stale.push_back(i);
+        }
+    }
+
+    auto pool = llvm::ThreadPool{llvm::hardware_concurrency(handler_->get_jobs())};
+    for (auto const i : stale) {
+        pool.async([this, i] {
+            handler_->traced([this, i] { parse(nodes_[i]); });
+        });
+    }
+    pool.wait();
+    exit_on_fatal_error();
+
+    // Dependencies are read first, so the classes and enums an interface names have been made by the time it's read
+    auto const resolve = InterfaceReader::Resolver{[this, &index](std::string const& filepath) -> Module* {
+        auto const it = index.find(filepath);
+        return (it == index.end()) ? nullptr : nodes_[it->second].module.get();
+    }};
+    auto num_interfaces = size_t{0};
+    for (auto const i : order) {
+        auto& node = nodes_[i];
+        if (node.interface) {
+            node.module = node.interface->read_module(node.filepath, handler_->file_id(node.filepath), resolve);
+            node.interface = nullptr;
+            if (node.module) {
+                node.module->set_is_lib(node.is_lib);
+                node.module->set_bitcode_path(node.bitcode_path);
+                ++num_interfaces;
+            }
+            else {
+                node.bitcode_path.clear();
+                parse(node);
+                exit_on_fatal_error();
+            }
+        }
+        node.module->set_cache_key(keys[i]);
+    }
+    handler_->stats.add_count("module interfaces", num_interfaces);
+}
+
+auto ModuleGraph::write_interface(Node const& node) -> void {
+    auto const has_errors = std::any_of(node.diagnostics.begin(), node.diagnostics.end(), [](auto const& diagnostic) {
+        return diagnostic.is_error;
+    });
+    if (has_errors) {
+        return;
+    }
+    if (auto const interface = InterfaceWriter{*modules_}.write(*node.module)) {
+        BuildCache{handler_->get_cache_dir() / "build"}.store_interface(node.source_hash, *interface);
+    }
+}
+
+auto ModuleGraph::check_cycles() -> void {
+    // Depth first, a dependency that's still on the path back to the main module closes a cycle
+    enum class State { UNVISITED, ON_PATH, DONE };
+    auto states = std::vector<State>(nodes_.size(), State::UNVISITED);
+    auto path = std::vector<size_t>{};
+    auto verifier = std::make_shared<Verifier>(handler_, modules_);
+
+    auto visit = std::function<void(size_t)>{};
+    visit = [&](size_t i) {
+        states[i] = State::ON_PATH;
+        path.push_back(i);
+        for (auto const dependency : nodes_[i].dependencies) {
+            if (states[dependency] == State::ON_PATH) {
+                auto cycle = std::string{};
+                for (auto it = std::find(path.begin(), path.end(), dependency); it != path.end(); ++it) {
+                    cycle += nodes_[*it].filepath + " -> ";
+                }
+                cycle += nodes_[dependency].filepath;
+                auto const diagnostics = Handler::DiagnosticScope{nodes_[i].diagnostics};
+                verifier->report_import_cycle(nodes_[i].filepath, cycle);
+            }
+            else if (states[dependency] == State::UNVISITED) {
+                visit(dependency);
+            }
+        }
+        path.pop_back();
+        states[i] = State::DONE;
+    };
+    visit(0);
+}
+
+auto ModuleGraph::post_order() const -> std::vector<size_t> {
+    auto order = std::vector<size_t>{};
+    auto visited = std::vector<bool>(nodes_.size(), false);
+    auto visit = std::function<void(size_t)>{};
+    visit = [&](size_t i) {
+        visited[i] = true;
+        for (auto const dependency : nodes_[i].dependencies) {
+            if (!visited[dependency]) {
+                visit(dependency);
+            }
+        }
+        order.push_back(i);
+    };
+    visit(0);
+    return order;
+}
+
+auto ModuleGraph::print_diagnostics() -> void {
+    for (auto& node : nodes_) {
+        handler_->print_diagnostics(node.diagnostics);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef MODULE_GRAPH_HPP
+#define MODULE_GRAPH_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./handler.hpp"
+#include "./interface.hpp"
+#include "./module.hpp"
+
+// Every module reachable from the main one through import and using, with an edge from each module to those it
+// depends on. Modules are lexed, parsed and verified on up to -j threads: the modules first reached at the same
+// depth are parsed together, and each module is verified as soon as everything it depends on has been.
+//
+// With --build-cache, a module whose interface was written from the same source, under the same dependencies, is
+// read back from that instead and isn't verified again. A library precompiled with --precompile is read from the
+// interface the build keeps for it whenever that's still current, with or without the cache.
+class ModuleGraph {
+ public:
+    ModuleGraph(std::shared_ptr<Handler> handler, std::shared_ptr<AllModules> modules)
+    : handler_(handler)
+    , modules_(modules) {}
+
+    // Lexes and parses everything the main module depends on, reporting an error for each cycle
+    auto load() -> void;
+
+    // Verifies every module, dependencies first and the main module last
+    auto verify() -> void;
+
+    // Parses and verifies every module only read from its interface so far, for when its code has to be generated
+    auto load_bodies() -> void;
+
+ private:
+    struct Node {
+        std::string filepath;
+        bool is_lib;
+        std::shared_ptr<Module> module = nullptr;
+        std::vector<size_t> dependencies = {};
+        std::vector<size_t> dependents = {};
+        // The file and its source, which the module's interface is stored under
+        std::string source_hash = {};
+        std::unique_ptr<InterfaceReader> interface = nullptr;
+        // The library's precompiled definitions, when its interface came from the precompiled path
+        std::string bitcode_path = {};
+        // Diagnostics are held back per module and printed in graph order once every thread is done
+        std::vector<Handler::Diagnostic> diagnostics = {};
+        // Lexing or parsing the module gave up part way through
+        bool has_fatal_error = false;
+    };
+
+    auto parse(Node& node) -> void;
+    // Prints the diagnostics and exits from the main thread once any module has failed to parse
+    auto exit_on_fatal_error() -> void;
+    // Reads as far as the modules the node depends on, false if it has no interface to read
+    auto read_interface(Node& node) -> bool;
+    // Keys every module, then reads the modules whose interfaces are still current and parses the rest
+    auto load_interfaces(std::unordered_map<std::string, size_t> const& index) -> void;
+    auto write_interface(Node const& node) -> void;
+    auto check_cycles() -> void;
+    auto print_diagnostics() -> void;
+    // Every module reachable from the main one, each after those it depends on
+    auto post_order() const -> std::vector<size_t>;
+
+    std::shared_ptr<Handler> handler_;
+    std::shared_ptr<AllModules> modules_;
+    // In the order modules are first reached, breadth first from the main module
+    std::vector<Node> nodes_ = {};
+};
+
+#endif // MODULE_GRAPH_HPP
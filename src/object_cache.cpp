@@ -0,0 +1,133 @@
+#include "./object_cache.hpp"
+
+#include <fstream>
+#include <optional>
+#include <sstream>
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+static auto write_cache_file(std::filesystem::path const& path, llvm::StringRef contents) -> void {
+    auto error_code = std::error_code{};
+    std::filesystem::create_directories(path.parent_path(), error_code);
+    if (error_code) {
+        return;
+    }
+
+    // Write to a temporary first so a concurrent run never sees a partially written file
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        auto stream = std::ofstream{temp_path, std::ios::binary};
+        if (!stream) {
+            return;
+        }
+        stream.write(contents.data(), contents.size());
+    }
+    std::filesystem::rename(temp_path, path, error_code);
+}
+
+auto DiskObjectCache::notifyObjectCompiled(llvm::Module const* module, llvm::MemoryBufferRef object) -> void {
+    write_cache_file(object_path(module), object.getBuffer());
+}
+
+auto DiskObjectCache::getObject(llvm::Module const* module) -> std::unique_ptr<llvm::MemoryBuffer> {
+    auto buffer = llvm::MemoryBuffer::getFile(object_path(module).string());
+    if (!buffer) {
+        return nullptr;
+    }
+    return std::move(*buffer);
+}
+
+auto DiskObjectCache::object_path(llvm::Module const* module) -> std::filesystem::path {
+    // The printed IR covers the code itself as well as the triple, data layout and target attributes
+    auto ir = std::string{};
+    auto stream = llvm::raw_string_ostream{ir};
+    module->print(stream, nullptr);
+    stream.flush();
+
+    return cache_dir_ / (BuildCache::hash(ir) + ".o");
+}
+
+auto BuildCache::hash(llvm::StringRef contents) -> std::string {
+    auto hash = std::string{};
+    auto hash_stream = llvm::raw_string_ostream{hash};
+    hash_stream << llvm::format_hex_no_prefix(llvm::xxHash64(contents), 16);
+    hash_stream.flush();
+    return hash;
+}
+
+auto BuildCache::compiler_stamp() -> std::string {
+    auto stamp = std::string{LLVM_VERSION_STRING};
+    auto const compiler = llvm::sys::fs::getMainExecutable(nullptr, nullptr);
+    auto error_code = std::error_code{};
+    auto const size = std::filesystem::file_size(compiler, error_code);
+    auto const modified = std::filesystem::last_write_time(compiler, error_code);
+    if (!error_code) {
+        stamp += "\n" + compiler + " " + std::to_string(size) + " "
+                 + std::to_string(modified.time_since_epoch().count());
+    }
+    return stamp;
+}
+
+auto BuildCache::get_object(std::string const& key) -> std::unique_ptr<llvm::MemoryBuffer> {
+    auto buffer = llvm::MemoryBuffer::getFile((cache_dir_ / "objects" / (key + ".o")).string());
+    if (!buffer) {
+        return nullptr;
+    }
+    return std::move(*buffer);
+}
+
+auto BuildCache::store_object(std::string const& key, llvm::ArrayRef<char> object) -> void {
+    write_cache_file(cache_dir_ / "objects" / (key + ".o"), llvm::StringRef{object.data(), object.size()});
+}
+
+auto BuildCache::get_interface(std::string const& name) -> std::unique_ptr<llvm::MemoryBuffer> {
+    auto buffer = llvm::MemoryBuffer::getFile((cache_dir_ / "interfaces" / (name + ".xppi")).string());
+    if (!buffer) {
+        return nullptr;
+    }
+    return std::move(*buffer);
+}
+
+auto BuildCache::store_interface(std::string const& name, llvm::StringRef interface) -> void {
+    write_cache_file(cache_dir_ / "interfaces" / (name + ".xppi"), interface);
+}
+
+static auto output_stamp(std::string const& output) -> std::optional<std::string> {
+    // Size and modification time catch the executable being rebuilt or touched by anything else since
+    auto error_code = std::error_code{};
+    auto const size = std::filesystem::file_size(output, error_code);
+    auto const modified = std::filesystem::last_write_time(output, error_code);
+    if (error_code) {
+        return std::nullopt;
+    }
+    return std::to_string(size) + " " + std::to_string(modified.time_since_epoch().count());
+}
+
+auto BuildCache::is_linked(std::string const& output, std::string const& key) -> bool {
+    auto const stamp = output_stamp(output);
+    if (!stamp) {
+        return false;
+    }
+    auto record = std::ifstream{link_record_path(output)};
+    if (!record) {
+        return false;
+    }
+    auto contents = std::stringstream{};
+    contents << record.rdbuf();
+    return contents.str() == key + " " + *stamp;
+}
+
+auto BuildCache::record_link(std::string const& output, std::string const& key) -> void {
+    if (auto const stamp = output_stamp(output)) {
+        write_cache_file(link_record_path(output), key + " " + *stamp);
+    }
+}
+
+auto BuildCache::link_record_path(std::string const& output) -> std::filesystem::path {
+    return cache_dir_ / "links" / hash(std::filesystem::absolute(output).string());
+}
@@ -0,0 +1,60 @@
+#ifndef OBJECT_CACHE_HPP
+#define OBJECT_CACHE_HPP
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+// Keeps JIT compiled objects on disk, keyed by a hash of the module's IR so repeat runs of an
+// unchanged program skip code generation entirely
+class DiskObjectCache : public llvm::ObjectCache {
+ public:
+    DiskObjectCache(std::filesystem::path cache_dir)
+    : cache_dir_(cache_dir) {}
+
+    auto notifyObjectCompiled(llvm::Module const* module, llvm::MemoryBufferRef object) -> void override;
+    auto getObject(llvm::Module const* module) -> std::unique_ptr<llvm::MemoryBuffer> override;
+
+ private:
+    auto object_path(llvm::Module const* module) -> std::filesystem::path;
+
+    std::filesystem::path cache_dir_;
+};
+
+// Keeps the object generated for each module on disk, keyed by a hash of everything that went into it, along with
+// the inputs every executable was last linked from so an unchanged build links nothing either, and the interface
+// each module verified to so its dependents can be verified without parsing it
+class BuildCache {
+ public:
+    BuildCache(std::filesystem::path cache_dir)
+    : cache_dir_(cache_dir) {}
+
+    static auto hash(llvm::StringRef contents) -> std::string;
+    // Identifies the compiler doing the caching, as everything cached goes stale when it's rebuilt
+    static auto compiler_stamp() -> std::string;
+
+    auto get_object(std::string const& key) -> std::unique_ptr<llvm::MemoryBuffer>;
+    auto store_object(std::string const& key, llvm::ArrayRef<char> object) -> void;
+
+    // Module interfaces (.xppi) are named after the module's file and source, the key they were written under is
+    // kept inside
+    auto get_interface(std::string const& name) -> std::unique_ptr<llvm::MemoryBuffer>;
+    auto store_interface(std::string const& name, llvm::StringRef interface) -> void;
+
+    // Whether output is still exactly what was linked from the inputs hashed into key
+    auto is_linked(std::string const& output, std::string const& key) -> bool;
+    auto record_link(std::string const& output, std::string const& key) -> void;
+
+ private:
+    auto link_record_path(std::string const& output) -> std::filesystem::path;
+
+    std::filesystem::path cache_dir_;
+};
+
+#endif // OBJECT_CACHE_HPP
@@ -1,37 +1,35 @@
 #include "./parser.hpp"
+#include <cassert>
 #include <filesystem>
 #include <iostream>
 #include <map>
 #include <sstream>
 
 auto Parser::syntactic_error(const std::string& _template, const std::string& quoted_token) -> void {
-    handler_->report_error(filename_, _template, quoted_token, (*curr_token_)->pos());
-    exit(EXIT_FAILURE);
+    handler_->report_fatal_error(filename_, _template, quoted_token, curr_token_->pos());
 }
 
 auto Parser::start(Position& pos) -> void {
-    if (curr_token_.has_value()) {
-        pos = (*curr_token_)->pos();
+    if (curr_token_) {
+        pos = curr_token_->pos();
     }
 }
 
 auto Parser::finish(Position& pos) -> void {
-    if (curr_token_.has_value()) {
-        pos.col_end_ = (*curr_token_)->pos().col_end_;
-        pos.line_end_ = (*curr_token_)->pos().line_end_;
+    if (curr_token_) {
+        pos.extend_to(curr_token_->pos());
     }
     else {
-        pos.col_end_ = tokens_.back()->pos().col_end_;
-        pos.line_end_ = tokens_.back()->pos().line_end_;
+        pos.extend_to(last_pos_);
     }
 }
 
 auto Parser::try_consume(TokenType t) -> bool {
-    if (!curr_token_.has_value()) {
+    if (!curr_token_) {
         return false;
     }
 
-    if ((*curr_token_)->type_matches(t)) {
+    if (curr_token_->type_matches(t)) {
         consume();
         return true;
     }
@@ -41,43 +39,59 @@ auto Parser::try_consume(TokenType t) -> bool {
 
 auto Parser::match(TokenType t) -> void {
     if (!try_consume(t)) {
-        std::cout << "Received: " << (*curr_token_)->type() << "\n";
+        std::cout << "Received: " << curr_token_->type() << "\n";
         auto stream = std::stringstream{};
         stream << t;
         syntactic_error("\"%\" expected here", stream.str());
     }
 }
 
-auto Parser::consume() -> void {
-    ++index;
-    if (index < tokens_.size()) {
-        curr_token_ = tokens_[index];
+auto Parser::fill(size_t pos) -> void {
+    while (window_size_ <= pos) {
+        auto token = lexer_.next();
+        if (!token) {
+            return;
+        }
+        last_pos_ = token->pos();
+        window_[(window_start_ + window_size_) % lookahead_] = *token;
+        ++window_size_;
     }
-    else {
-        curr_token_ = std::nullopt;
+}
+
+auto Parser::consume() -> void {
+    if (window_size_ == 0) {
+        return;
     }
+    window_start_ = (window_start_ + 1) % lookahead_;
+    --window_size_;
+    fill(0);
+    curr_token_ = (window_size_ > 0) ? &window_[window_start_] : nullptr;
 }
 
 auto Parser::peek(TokenType t, size_t pos) -> bool {
-    if (index + pos >= tokens_.size()) {
+    assert(pos < lookahead_);
+    fill(pos);
+    if (pos >= window_size_) {
         return false;
     }
-    return tokens_[index + pos]->type_matches(t);
+    return window_[(window_start_ + pos) % lookahead_].type_matches(t);
 }
 
 auto Parser::parse() -> std::shared_ptr<Module> {
+    auto const phase = handler_->stats.phase("parse", filename_);
     auto module = std::make_shared<Module>(filename_);
+    auto const arena_scope = Arena::Scope{module->get_arena()};
 
     while (peek(TokenType::IMPORT) or peek(TokenType::USING)) {
         if (try_consume(TokenType::USING)) {
-            while (curr_token_.has_value() and !(*curr_token_)->type_matches(TokenType::SEMICOLON)) {
+            while (curr_token_ and !curr_token_->type_matches(TokenType::SEMICOLON)) {
                 if (peek(TokenType::IDENT)) {
                     auto i = parse_ident();
-                    auto path = handler_->stdlib_path + "/" + i + ".xpp";
+                    auto path = handler_->stdlib_path + "/" + i.str() + ".xpp";
                     module->add_using_filepath(path, true);
                 }
                 else {
-                    std::filesystem::path p = (*curr_token_)->lexeme();
+                    std::filesystem::path p = curr_token_->lexeme();
                     match(TokenType::STRING_LITERAL);
                     auto path = static_cast<std::filesystem::path>(filename_).parent_path() / p;
                     path += ".xpp";
@@ -92,27 +106,27 @@ auto Parser::parse() -> std::shared_ptr<Module> {
         }
         else {
             match(TokenType::IMPORT);
-            while (curr_token_.has_value() and !(*curr_token_)->type_matches(TokenType::SEMICOLON)) {
+            while (curr_token_ and !curr_token_->type_matches(TokenType::SEMICOLON)) {
                 if (peek(TokenType::IDENT)) {
                     // Standard library paths
                     auto i = parse_ident();
-                    auto path = handler_->stdlib_path + "/" + i + ".xpp";
+                    auto path = handler_->stdlib_path + "/" + i.str() + ".xpp";
                     if (try_consume(TokenType::AS)) {
                         auto alias = parse_ident();
-                        module->add_imported_filepath(alias, path, true);
+                        module->add_imported_filepath(alias.str(), path, true);
                     }
                     else {
-                        module->add_imported_filepath(i, path, true);
+                        module->add_imported_filepath(i.str(), path, true);
                     }
                 }
                 else {
-                    std::filesystem::path p = (*curr_token_)->lexeme();
+                    std::filesystem::path p = curr_token_->lexeme();
                     match(TokenType::STRING_LITERAL);
                     auto path = static_cast<std::filesystem::path>(filename_).parent_path() / p;
                     path += ".xpp";
                     match(TokenType::AS);
                     auto alias = parse_ident();
-                    module->add_imported_filepath(alias, path);
+                    module->add_imported_filepath(alias.str(), path);
                 }
 
                 if (peek(TokenType::SEMICOLON)) {
@@ -124,7 +138,7 @@ auto Parser::parse() -> std::shared_ptr<Module> {
         match(TokenType::SEMICOLON);
     }
 
-    while (curr_token_.has_value()) {
+    while (curr_token_) {
         auto p = Position{};
         start(p);
         auto const is_pub = try_consume(TokenType::PUB);
@@ -134,7 +148,7 @@ auto Parser::parse() -> std::shared_ptr<Module> {
             auto type = parse_type();
             auto stmt = parse_compound_stmt();
             finish(p);
-            auto func = std::make_shared<Function>(p, ident, paras, type, stmt);
+            auto func = make_node<Function>(p, ident, paras, type, stmt);
             if (is_pub)
                 func->set_pub();
             stmt->set_parent(func);
@@ -146,7 +160,7 @@ auto Parser::parse() -> std::shared_ptr<Module> {
             auto return_type = parse_type();
             match(TokenType::SEMICOLON);
             finish(p);
-            auto extern_ = std::make_shared<Extern>(p, ident, return_type, types);
+            auto extern_ = make_node<Extern>(p, ident, return_type, types);
             if (is_pub)
                 extern_->set_pub();
             module->add_extern(extern_);
@@ -163,16 +177,16 @@ auto Parser::parse() -> std::shared_ptr<Module> {
         else if (try_consume(TokenType::LET)) {
             auto const is_mut = try_consume(TokenType::MUT);
             auto const ident = parse_ident();
-            auto type = std::make_shared<Type>();
+            auto type = Type::get();
             if (try_consume(TokenType::COLON)) {
                 type = parse_type();
             }
             finish(p);
-            std::shared_ptr<Expr> expr = std::make_shared<EmptyExpr>(p);
+            Expr* expr = make_node<EmptyExpr>(p);
             if (try_consume(TokenType::ASSIGN)) {
                 expr = parse_expr();
             }
-            auto global_var = std::make_shared<GlobalVarDecl>(p, ident, type, expr);
+            auto global_var = make_node<GlobalVarDecl>(p, ident, type, expr);
             expr->set_parent(global_var);
             if (is_mut) {
                 global_var->set_mut();
@@ -190,7 +204,7 @@ auto Parser::parse() -> std::shared_ptr<Module> {
         }
         else {
             auto stream = std::stringstream{};
-            stream << *(*curr_token_);
+            stream << *curr_token_;
             syntactic_error("Expected a type declaration, function declaration or global varariable declaration, "
                             "received %",
                             stream.str());
@@ -200,12 +214,12 @@ auto Parser::parse() -> std::shared_ptr<Module> {
     return module;
 }
 
-auto Parser::parse_class(Position p) -> std::shared_ptr<ClassDecl> {
+auto Parser::parse_class(Position p) -> ClassDecl* {
     auto const class_name = parse_ident();
-    auto fields_vec = std::vector<std::shared_ptr<ClassFieldDecl>>{};
-    auto methods_vec = std::vector<std::shared_ptr<MethodDecl>>{};
-    auto constructors_vec = std::vector<std::shared_ptr<ConstructorDecl>>{};
-    auto destructors_vec = std::vector<std::shared_ptr<DestructorDecl>>{};
+    auto fields_vec = std::vector<ClassFieldDecl*>{};
+    auto methods_vec = std::vector<MethodDecl*>{};
+    auto constructors_vec = std::vector<ConstructorDecl*>{};
+    auto destructors_vec = std::vector<DestructorDecl*>{};
 
     match(TokenType::OPEN_CURLY);
     while (!peek(TokenType::CLOSE_CURLY)) {
@@ -214,21 +228,21 @@ auto Parser::parse_class(Position p) -> std::shared_ptr<ClassDecl> {
         if (try_consume(TokenType::DESTRUCTOR)) {
             auto stmts = parse_compound_stmt();
             finish(p2);
-            auto destructor_decl = std::make_shared<DestructorDecl>(p2, class_name, stmts);
+            auto destructor_decl = make_node<DestructorDecl>(p2, class_name, stmts);
             destructors_vec.push_back(destructor_decl);
             continue;
         }
 
         auto const is_pub = try_consume(TokenType::PUB);
         auto const is_mut = try_consume(TokenType::MUT);
-        if (peek(TokenType::IDENT) and (*curr_token_)->lexeme() != class_name) {
-            auto lex = (*curr_token_)->lexeme();
+        if (peek(TokenType::IDENT) and curr_token_->symbol() != class_name) {
+            auto const lex = curr_token_->symbol();
             match(TokenType::IDENT);
             if (try_consume(TokenType::COLON)) {
                 auto type = parse_type();
                 match(TokenType::SEMICOLON);
                 finish(p2);
-                auto field_decl = std::make_shared<ClassFieldDecl>(p2, lex, type);
+                auto field_decl = make_node<ClassFieldDecl>(p2, lex, type);
                 if (is_pub) {
                     field_decl->set_pub();
                 }
@@ -241,12 +255,12 @@ auto Parser::parse_class(Position p) -> std::shared_ptr<ClassDecl> {
                 std::cout << "Parser::parse_class UNREACHABLE!\n";
             }
         }
-        else if (peek(TokenType::IDENT) and (*curr_token_)->lexeme() == class_name) { // constructor
+        else if (peek(TokenType::IDENT) and curr_token_->symbol() == class_name) { // constructor
             consume();
             auto paras = parse_para_list();
             auto stmts = parse_compound_stmt();
             finish(p2);
-            auto constructor_decl = std::make_shared<ConstructorDecl>(p2, class_name, paras, stmts);
+            auto constructor_decl = make_node<ConstructorDecl>(p2, class_name, paras, stmts);
             if (is_pub) {
                 constructor_decl->set_pub();
             }
@@ -258,7 +272,7 @@ auto Parser::parse_class(Position p) -> std::shared_ptr<ClassDecl> {
             auto type = parse_type();
             auto stmts = parse_compound_stmt();
             finish(p2);
-            auto method_decl = std::make_shared<MethodDecl>(p2, ident, paras, type, stmts);
+            auto method_decl = make_node<MethodDecl>(p2, ident, paras, type, stmts);
             if (is_pub) {
                 method_decl->set_pub();
             }
@@ -279,7 +293,7 @@ auto Parser::parse_class(Position p) -> std::shared_ptr<ClassDecl> {
 }
 
 auto Parser::parse_operator() -> Op {
-    if (!curr_token_.has_value()) {
+    if (!curr_token_) {
         syntactic_error("OPERATOR expected, but found end of file", "");
     }
 
@@ -304,8 +318,8 @@ auto Parser::parse_operator() -> Op {
                                                                   {TokenType::DIVIDE_ASSIGN, Op::DIVIDE_ASSIGN},
                                                                   {TokenType::GREATER_EQUAL, Op::GREATER_EQUAL}};
 
-    if (type_to_operator_mapping.find((*curr_token_)->type()) != type_to_operator_mapping.end()) {
-        auto const& op = type_to_operator_mapping.at((*curr_token_)->type());
+    if (type_to_operator_mapping.find(curr_token_->type()) != type_to_operator_mapping.end()) {
+        auto const& op = type_to_operator_mapping.at(curr_token_->type());
         consume();
         return op;
     }
@@ -316,85 +330,85 @@ auto Parser::parse_operator() -> Op {
     return Op::ASSIGN;
 }
 
-auto Parser::parse_ident() -> std::string {
-    if (!curr_token_.has_value()) {
+auto Parser::parse_ident() -> Symbol {
+    if (!curr_token_) {
         syntactic_error("IDENTIFIER expected, but found end of file", "");
     }
-    auto const& spelling = (*curr_token_)->lexeme();
+    auto const symbol = curr_token_->symbol();
     match(TokenType::IDENT);
-    return spelling;
+    return symbol;
 }
 
-auto Parser::parse_import_type() -> std::shared_ptr<Type> {
-    if (!curr_token_.has_value()) {
+auto Parser::parse_import_type() -> Type* {
+    if (!curr_token_) {
         syntactic_error("TYPE expected, but found end of file", "");
     }
 
-    auto const& curr_lexeme = (*curr_token_)->lexeme();
+    auto const curr_lexeme = std::string{curr_token_->lexeme()};
     consume();
 
     if (try_consume(TokenType::DOUBLE_COLON)) {
         auto sub_type = parse_import_type();
-        return std::make_shared<ImportType>(curr_lexeme, sub_type);
+        return ImportType::get(curr_lexeme, sub_type);
     }
     else {
-        return std::make_shared<MurkyType>(curr_lexeme);
+        return MurkyType::get(curr_lexeme);
     }
 }
 
-auto Parser::parse_type() -> std::shared_ptr<Type> {
-    if (!curr_token_.has_value()) {
+auto Parser::parse_type() -> Type* {
+    if (!curr_token_) {
         syntactic_error("TYPE expected, but found end of file", "");
     }
 
-    auto const& curr_lexeme = (*curr_token_)->lexeme();
+    auto const curr_lexeme = curr_token_->lexeme();
     auto const& type_spec = type_spec_from_lexeme(curr_lexeme);
 
     consume();
 
     // Handle pointer/array types
-    std::shared_ptr<Type> return_type;
+    Type* return_type;
     if (try_consume(TokenType::DOUBLE_COLON)) {
         // Entered an import type
         auto sub_type = parse_import_type();
-        return_type = std::make_shared<ImportType>(curr_lexeme, sub_type);
+        return_type = ImportType::get(std::string{curr_lexeme}, sub_type);
     }
     else if (type_spec == TypeSpec::MURKY) {
-        return_type = std::make_shared<MurkyType>(curr_lexeme);
+        return_type = MurkyType::get(std::string{curr_lexeme});
     }
     else {
-        return_type = std::make_shared<Type>(type_spec);
+        return_type = Type::get(type_spec);
     }
-    std::shared_ptr<Type> sub_type = nullptr;
+    Type* sub_type = nullptr;
     if (!in_new_expr_ and try_consume(TokenType::OPEN_SQUARE)) {
         sub_type = return_type;
         if (peek(TokenType::INTEGER)) {
-            auto value = std::stoul((*curr_token_)->lexeme());
+            auto value = std::stoul(std::string{curr_token_->lexeme()});
             consume();
             match(TokenType::CLOSE_SQUARE);
-            return std::make_shared<ArrayType>(sub_type, size_t{value});
+            return ArrayType::get(sub_type, size_t{value});
         }
         else {
             match(TokenType::CLOSE_SQUARE);
-            return std::make_shared<ArrayType>(sub_type);
+            return ArrayType::get(sub_type);
         }
         match(TokenType::CLOSE_SQUARE);
     }
     else {
         while (try_consume(TokenType::MULTIPLY)) {
             sub_type = return_type;
-            return_type = std::make_shared<PointerType>(sub_type);
+            return_type = PointerType::get(sub_type);
         }
     }
 
     return return_type;
 }
 
-auto Parser::parse_para_list() -> std::vector<std::shared_ptr<ParaDecl>> {
-    auto paras = std::vector<std::shared_ptr<ParaDecl>>{};
+auto Parser::parse_para_list() -> std::vector<ParaDecl*> {
+    auto paras = std::vector<ParaDecl*>{};
 
     match(TokenType::OPEN_BRACKET);
-    while (curr_token_.has_value() and !(*curr_token_)->type_matches(TokenType::CLOSE_BRACKET)) {
+    while (curr_token_ and !curr_token_->type_matches(TokenType::CLOSE_BRACKET)) {
         auto p = Position{};
         start(p);
         auto const is_mut = try_consume(TokenType::MUT);
@@ -402,7 +416,7 @@ auto Parser::parse_para_list() -> std::vector<std::shared_ptr<ParaDecl>> {
         match(TokenType::COLON);
         auto const type = parse_type();
         finish(p);
-        auto decl = std::make_shared<ParaDecl>(p, ident, type);
+        auto decl = make_node<ParaDecl>(p, ident, type);
         if (is_mut) {
             decl->set_mut();
         }
@@ -416,10 +430,10 @@ auto Parser::parse_para_list() -> std::vector<std::shared_ptr<ParaDecl>> {
     return paras;
 }
 
-auto Parser::parse_type_list() -> std::vector<std::shared_ptr<Type>> {
-    auto types = std::vector<std::shared_ptr<Type>>{};
+auto Parser::parse_type_list() -> std::vector<Type*> {
+    auto types = std::vector<Type*>{};
     match(TokenType::OPEN_BRACKET);
-    while (curr_token_.has_value() and !(*curr_token_)->type_matches(TokenType::CLOSE_BRACKET)) {
+    while (curr_token_ and !curr_token_->type_matches(TokenType::CLOSE_BRACKET)) {
         types.push_back(parse_type());
         if (peek(TokenType::CLOSE_BRACKET)) {
             break;
@@ -430,9 +444,9 @@ auto Parser::parse_type_list() -> std::vector<std::shared_ptr<Type>> {
     return types;
 }
 
-auto Parser::parse_arg_list() -> std::vector<std::shared_ptr<Expr>> {
-    auto args = std::vector<std::shared_ptr<Expr>>{};
-    while (curr_token_.has_value() and !(*curr_token_)->type_matches(TokenType::CLOSE_BRACKET)) {
+auto Parser::parse_arg_list() -> std::vector<Expr*> {
+    auto args = std::vector<Expr*>{};
+    while (curr_token_ and !curr_token_->type_matches(TokenType::CLOSE_BRACKET)) {
         args.push_back(parse_expr());
         if (peek(TokenType::CLOSE_BRACKET)) {
             break;
@@ -446,8 +460,8 @@ auto Parser::parse_arg_list() -> std::vector<std::shared_ptr<Expr>> {
 auto Parser::parse_enum_list() -> std::vector<std::string> {
     auto res = std::vector<std::string>{};
     match(TokenType::OPEN_CURLY);
-    while (curr_token_.has_value() and !(*curr_token_)->type_matches(TokenType::CLOSE_CURLY)) {
-        auto s = (*curr_token_)->lexeme();
+    while (curr_token_ and !curr_token_->type_matches(TokenType::CLOSE_CURLY)) {
+        auto s = std::string{curr_token_->lexeme()};
         match(TokenType::IDENT);
         res.push_back(s);
         if (peek(TokenType::CLOSE_CURLY)) {
@@ -459,20 +473,20 @@ auto Parser::parse_enum_list() -> std::vector<std::string> {
     return res;
 }
 
-auto Parser::parse_compound_stmt() -> std::shared_ptr<CompoundStmt> {
-    auto stmts = std::vector<std::shared_ptr<Stmt>>{};
+auto Parser::parse_compound_stmt() -> CompoundStmt* {
+    auto stmts = std::vector<Stmt*>{};
     match(TokenType::OPEN_CURLY);
 
     auto p = Position{};
     start(p);
     if (try_consume(TokenType::CLOSE_CURLY)) {
-        return std::make_shared<CompoundStmt>(p, stmts);
+        return make_node<CompoundStmt>(p, stmts);
     }
 
-    while (curr_token_.has_value() and !(*curr_token_)->type_matches(TokenType::CLOSE_CURLY)) {
+    while (curr_token_ and !curr_token_->type_matches(TokenType::CLOSE_CURLY)) {
         if (try_consume(TokenType::SEMICOLON)) {
             finish(p);
-            stmts.push_back(std::make_shared<EmptyStmt>(p));
+            stmts.push_back(make_node<EmptyStmt>(p));
         }
         else if (try_consume(TokenType::LET)) {
             stmts.push_back(parse_local_var_stmt());
@@ -496,19 +510,19 @@ auto Parser::parse_compound_stmt() -> std::shared_ptr<CompoundStmt> {
             auto expr = parse_expr();
             match(TokenType::SEMICOLON);
             finish(p);
-            stmts.push_back(std::make_shared<DeleteStmt>(p, expr));
+            stmts.push_back(make_node<DeleteStmt>(p, expr));
         }
         else if (try_consume(TokenType::BREAK)) {
             auto p2 = Position{};
             start(p2);
             finish(p2);
-            stmts.push_back(std::make_shared<BreakStmt>(p2));
+            stmts.push_back(make_node<BreakStmt>(p2));
         }
         else if (try_consume(TokenType::CONTINUE)) {
             auto p2 = Position{};
             start(p2);
             finish(p2);
-            stmts.push_back(std::make_shared<ContinueStmt>(p2));
+            stmts.push_back(make_node<ContinueStmt>(p2));
         }
         else {
             stmts.push_back(parse_expr_stmt(p));
@@ -517,99 +531,99 @@ auto Parser::parse_compound_stmt() -> std::shared_ptr<CompoundStmt> {
     match(TokenType::CLOSE_CURLY);
 
     finish(p);
-    return std::make_shared<CompoundStmt>(p, stmts);
+    return make_node<CompoundStmt>(p, stmts);
 }
 
-auto Parser::parse_local_var_stmt() -> std::shared_ptr<LocalVarStmt> {
+auto Parser::parse_local_var_stmt() -> LocalVarStmt* {
     Position p;
     start(p);
     auto const is_mut = try_consume(TokenType::MUT);
     auto ident = parse_ident();
-    auto t = std::make_shared<Type>();
+    auto t = Type::get();
     if (try_consume(TokenType::COLON)) {
         t = parse_type();
     }
     finish(p);
-    std::shared_ptr<Expr> e = std::make_shared<EmptyExpr>(p);
+    Expr* e = make_node<EmptyExpr>(p);
     if (try_consume(TokenType::ASSIGN)) {
         e = parse_expr();
     }
     match(TokenType::SEMICOLON);
-    std::shared_ptr<LocalVarDecl> decl = std::make_shared<LocalVarDecl>(p, ident, t, e);
+    LocalVarDecl* decl = make_node<LocalVarDecl>(p, ident, t, e);
     e->set_parent(decl);
     if (is_mut) {
         decl->set_mut();
     }
     finish(p);
-    return std::make_shared<LocalVarStmt>(p, decl);
+    return make_node<LocalVarStmt>(p, decl);
 }
-auto Parser::parse_return_stmt(Position p) -> std::shared_ptr<ReturnStmt> {
-    std::shared_ptr<Expr> expr;
+auto Parser::parse_return_stmt(Position p) -> ReturnStmt* {
+    Expr* expr;
     if (try_consume(TokenType::SEMICOLON)) {
         finish(p);
-        expr = std::make_shared<EmptyExpr>(p);
+        expr = make_node<EmptyExpr>(p);
     }
     else {
         expr = parse_expr();
         match(TokenType::SEMICOLON);
     }
     finish(p);
-    return std::make_shared<ReturnStmt>(p, expr);
+    return make_node<ReturnStmt>(p, expr);
 }
 
-auto Parser::parse_while_stmt(Position p) -> std::shared_ptr<WhileStmt> {
+auto Parser::parse_while_stmt(Position p) -> WhileStmt* {
     auto const cond = parse_expr();
     auto const stmts_ = parse_compound_stmt();
     finish(p);
-    auto while_stmt = std::make_shared<WhileStmt>(p, cond, stmts_);
+    auto while_stmt = make_node<WhileStmt>(p, cond, stmts_);
     stmts_->set_parent(while_stmt);
     return while_stmt;
 }
 
-auto Parser::parse_if_stmt(Position p) -> std::shared_ptr<IfStmt> {
+auto Parser::parse_if_stmt(Position p) -> IfStmt* {
     auto const cond = parse_expr();
     auto const stmt_one = parse_compound_stmt();
     auto else_if_p = p;
     finish(p);
-    std::shared_ptr<Stmt> stmt_two = std::make_shared<EmptyStmt>(p);
+    Stmt* stmt_two = make_node<EmptyStmt>(p);
     if (try_consume(TokenType::ELSE_IF)) {
         stmt_two = parse_else_if_stmt(else_if_p);
     }
 
     finish(p);
-    std::shared_ptr<Stmt> stmt_three = std::make_shared<EmptyStmt>(p);
+    Stmt* stmt_three = make_node<EmptyStmt>(p);
     if (try_consume(TokenType::ELSE)) {
         stmt_three = parse_compound_stmt();
     }
 
     finish(p);
-    return std::make_shared<IfStmt>(p, cond, stmt_one, stmt_two, stmt_three);
+    return make_node<IfStmt>(p, cond, stmt_one, stmt_two, stmt_three);
 }
 
-auto Parser::parse_else_if_stmt(Position p) -> std::shared_ptr<ElseIfStmt> {
+auto Parser::parse_else_if_stmt(Position p) -> ElseIfStmt* {
     auto const cond = parse_expr();
     auto const stmt = parse_compound_stmt();
     auto else_p = p;
     finish(p);
-    std::shared_ptr<Stmt> stmt_two = std::make_shared<EmptyStmt>(p);
+    Stmt* stmt_two = make_node<EmptyStmt>(p);
     if (try_consume(TokenType::ELSE_IF)) {
         stmt_two = parse_else_if_stmt(else_p);
     }
     finish(p);
-    return std::make_shared<ElseIfStmt>(p, cond, stmt, stmt_two);
+    return make_node<ElseIfStmt>(p, cond, stmt, stmt_two);
 }
 
-auto Parser::parse_expr_stmt(Position p) -> std::shared_ptr<ExprStmt> {
+auto Parser::parse_expr_stmt(Position p) -> ExprStmt* {
     auto const expr = parse_expr();
     match(TokenType::SEMICOLON);
     finish(p);
-    return std::make_shared<ExprStmt>(p, expr);
+    return make_node<ExprStmt>(p, expr);
 }
 
-auto Parser::parse_loop_stmt(Position p) -> std::shared_ptr<LoopStmt> {
+auto Parser::parse_loop_stmt(Position p) -> LoopStmt* {
     auto i = parse_ident();
-    std::optional<std::shared_ptr<Expr>> lower_bound = std::nullopt;
-    std::optional<std::shared_ptr<Expr>> upper_bound = std::nullopt;
+    std::optional<Expr*> lower_bound = std::nullopt;
+    std::optional<Expr*> upper_bound = std::nullopt;
     if (try_consume(TokenType::IN)) {
         auto e = parse_expr();
         if (try_consume(TokenType::COMMA)) {
@@ -622,13 +636,13 @@ auto Parser::parse_loop_stmt(Position p) -> std::shared_ptr<LoopStmt> {
     }
     auto stmts = parse_compound_stmt();
     finish(p);
-    return std::make_shared<LoopStmt>(p, i, lower_bound, upper_bound, stmts);
+    return make_node<LoopStmt>(p, i, lower_bound, upper_bound, stmts);
 }
 
-auto Parser::parse_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_expr() -> Expr* {
     auto p = Position{};
     start(p);
-    std::shared_ptr<Expr> expr;
+    Expr* expr;
     if (peek(TokenType::SIZE_OF)) {
         expr = parse_size_of_expr();
     }
@@ -641,12 +655,12 @@ auto Parser::parse_expr() -> std::shared_ptr<Expr> {
     if (try_consume(TokenType::AS)) {
         auto const type = parse_type();
         finish(p);
-        return std::make_shared<CastExpr>(p, expr, type);
+        return make_node<CastExpr>(p, expr, type);
     }
     return expr;
 }
 
-auto Parser::parse_assignment_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_assignment_expr() -> Expr* {
     auto p = Position{};
     start(p);
     auto left = parse_logical_or_expr();
@@ -656,92 +670,92 @@ auto Parser::parse_assignment_expr() -> std::shared_ptr<Expr> {
     auto op = parse_operator();
     auto right = parse_assignment_expr();
     finish(p);
-    auto assignment_expr = std::make_shared<AssignmentExpr>(p, left, op, right);
+    auto assignment_expr = make_node<AssignmentExpr>(p, left, op, right);
     left->set_parent(assignment_expr);
     return assignment_expr;
 }
 
-auto Parser::parse_logical_or_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_logical_or_expr() -> Expr* {
     auto p = Position{};
     start(p);
-    std::shared_ptr<Expr> left = parse_logical_and_expr();
+    Expr* left = parse_logical_and_expr();
     while (peek(TokenType::LOGICAL_OR)) {
         auto op = parse_operator();
         auto right = parse_logical_and_expr();
         finish(p);
-        left = std::make_shared<BinaryExpr>(p, left, op, right);
+        left = make_node<BinaryExpr>(p, left, op, right);
     }
     return left;
 }
 
-auto Parser::parse_logical_and_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_logical_and_expr() -> Expr* {
     auto p = Position{};
     start(p);
-    std::shared_ptr<Expr> left = parse_equality_expr();
+    Expr* left = parse_equality_expr();
     while (peek(TokenType::LOGICAL_AND)) {
         auto op = parse_operator();
         auto right = parse_equality_expr();
         finish(p);
-        left = std::make_shared<BinaryExpr>(p, left, op, right);
+        left = make_node<BinaryExpr>(p, left, op, right);
     }
     return left;
 }
 
-auto Parser::parse_equality_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_equality_expr() -> Expr* {
     auto p = Position{};
     start(p);
-    std::shared_ptr<Expr> left = parse_relational_expr();
+    Expr* left = parse_relational_expr();
     while (peek(TokenType::EQUAL) or peek(TokenType::NOT_EQUAL)) {
         auto op = parse_operator();
         auto right = parse_relational_expr();
         finish(p);
-        left = std::make_shared<BinaryExpr>(p, left, op, right);
+        left = make_node<BinaryExpr>(p, left, op, right);
     }
     return left;
 }
 
-auto Parser::parse_relational_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_relational_expr() -> Expr* {
     auto p = Position{};
     start(p);
-    std::shared_ptr<Expr> left = parse_additive_expr();
+    Expr* left = parse_additive_expr();
     while (peek(TokenType::LESS_THAN) or peek(TokenType::LESS_EQUAL) or peek(TokenType::GREATER_THAN)
            or peek(TokenType::GREATER_EQUAL))
     {
         auto op = parse_operator();
         auto right = parse_additive_expr();
         finish(p);
-        left = std::make_shared<BinaryExpr>(p, left, op, right);
+        left = make_node<BinaryExpr>(p, left, op, right);
     }
     return left;
 }
 
-auto Parser::parse_additive_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_additive_expr() -> Expr* {
     auto p = Position{};
     start(p);
-    std::shared_ptr<Expr> left = parse_multiplicative_expr();
+    Expr* left = parse_multiplicative_expr();
     while (peek(TokenType::PLUS) or peek(TokenType::MINUS)) {
         auto op = parse_operator();
         auto right = parse_multiplicative_expr();
         finish(p);
-        left = std::make_shared<BinaryExpr>(p, left, op, right);
+        left = make_node<BinaryExpr>(p, left, op, right);
     }
     return left;
 }
 
-auto Parser::parse_multiplicative_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_multiplicative_expr() -> Expr* {
     auto p = Position{};
     start(p);
-    std::shared_ptr<Expr> left = parse_unary_expr();
+    Expr* left = parse_unary_expr();
     while (peek(TokenType::MULTIPLY) or peek(TokenType::DIVIDE) or peek(TokenType::MODULO)) {
         auto op = parse_operator();
         auto right = parse_unary_expr();
         finish(p);
-        left = std::make_shared<BinaryExpr>(p, left, op, right);
+        left = make_node<BinaryExpr>(p, left, op, right);
     }
     return left;
 }
 
-auto Parser::parse_unary_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_unary_expr() -> Expr* {
     auto p = Position{};
     start(p);
 
@@ -750,7 +764,7 @@ auto Parser::parse_unary_expr() -> std::shared_ptr<Expr> {
         consume();
         auto const expr = parse_unary_expr();
         finish(p);
-        return std::make_shared<UnaryExpr>(p, is_plus ? Op::PREFIX_ADD : Op::PREFIX_MINUS, expr);
+        return make_node<UnaryExpr>(p, is_plus ? Op::PREFIX_ADD : Op::PREFIX_MINUS, expr);
     }
     else if (peek(TokenType::NEGATE) or peek(TokenType::PLUS) or peek(TokenType::MINUS) or peek(TokenType::MULTIPLY)
              or peek(TokenType::AMPERSAND))
@@ -761,7 +775,7 @@ auto Parser::parse_unary_expr() -> std::shared_ptr<Expr> {
         }
         auto expr = parse_unary_expr();
         finish(p);
-        return std::make_shared<UnaryExpr>(p, op, expr);
+        return make_node<UnaryExpr>(p, op, expr);
     }
     else if (peek(TokenType::OPEN_SQUARE)) {
         return parse_array_init_expr();
@@ -777,7 +791,7 @@ auto Parser::parse_unary_expr() -> std::shared_ptr<Expr> {
     }
 }
 
-auto Parser::parse_size_of_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_size_of_expr() -> Expr* {
     auto p = Position{};
     start(p);
     match(TokenType::SIZE_OF);
@@ -786,16 +800,16 @@ auto Parser::parse_size_of_expr() -> std::shared_ptr<Expr> {
         auto type = parse_type();
         finish(p);
         match(TokenType::CLOSE_BRACKET);
-        return std::make_shared<SizeOfExpr>(p, type);
+        return make_node<SizeOfExpr>(p, type);
     }
     else {
         auto expr = parse_unary_expr();
         finish(p);
-        return std::make_shared<SizeOfExpr>(p, expr);
+        return make_node<SizeOfExpr>(p, expr);
     }
 }
 
-auto Parser::parse_new_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_new_expr() -> Expr* {
     in_new_expr_ = true;
     auto p = Position{};
     start(p);
@@ -804,25 +818,25 @@ auto Parser::parse_new_expr() -> std::shared_ptr<Expr> {
     if (try_consume(TokenType::OPEN_SQUARE)) {
         auto e = parse_expr();
         match(TokenType::CLOSE_SQUARE);
-        return std::make_shared<NewExpr>(p, type, e);
+        return make_node<NewExpr>(p, type, e);
     }
 
     if (try_consume(TokenType::OPEN_BRACKET)) {
         auto args = parse_arg_list();
         finish(p);
-        return std::make_shared<NewExpr>(p, type, args);
+        return make_node<NewExpr>(p, type, args);
     }
 
     in_new_expr_ = true;
-    return std::make_shared<NewExpr>(p, type);
+    return make_node<NewExpr>(p, type);
 }
 
-auto Parser::parse_array_init_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_array_init_expr() -> Expr* {
     auto p = Position{};
     start(p);
-    auto exprs = std::vector<std::shared_ptr<Expr>>{};
+    auto exprs = std::vector<Expr*>{};
     match(TokenType::OPEN_SQUARE);
-    while (curr_token_.has_value() and !peek(TokenType::CLOSE_SQUARE)) {
+    while (curr_token_ and !peek(TokenType::CLOSE_SQUARE)) {
         exprs.push_back(parse_expr());
         if (peek(TokenType::CLOSE_SQUARE)) {
             break;
@@ -831,32 +845,32 @@ auto Parser::parse_array_init_expr() -> std::shared_ptr<Expr> {
     }
     match(TokenType::CLOSE_SQUARE);
     finish(p);
-    return std::make_shared<ArrayInitExpr>(p, exprs);
+    return make_node<ArrayInitExpr>(p, exprs);
 }
 
-auto Parser::parse_postfix_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_postfix_expr() -> Expr* {
     auto p = Position{};
     start(p);
     auto p_expr = parse_primary_expr();
-    auto v = std::dynamic_pointer_cast<VarExpr>(p_expr);
+    auto v = dyn_cast<VarExpr>(p_expr);
     if (peek(TokenType::OPEN_BRACKET) and v) {
         match(TokenType::OPEN_BRACKET);
         auto args = parse_arg_list();
         finish(p);
-        return std::make_shared<CallExpr>(p, v->get_name(), args);
+        return make_node<CallExpr>(p, v->get_name(), args);
     }
     else if (peek(TokenType::PLUS_PLUS) or peek(TokenType::MINUS_MINUS)) {
         auto const is_plus = peek(TokenType::PLUS_PLUS);
         consume();
         finish(p);
-        return std::make_shared<UnaryExpr>(p, (is_plus) ? Op::POSTFIX_ADD : Op::POSTFIX_MINUS, p_expr);
+        return make_node<UnaryExpr>(p, (is_plus) ? Op::POSTFIX_ADD : Op::POSTFIX_MINUS, p_expr);
     }
     else if (peek(TokenType::OPEN_SQUARE)) {
         match(TokenType::OPEN_SQUARE);
         auto const index_expr = parse_expr();
         match(TokenType::CLOSE_SQUARE);
         finish(p);
-        return std::make_shared<ArrayIndexExpr>(p, p_expr, index_expr);
+        return make_node<ArrayIndexExpr>(p, p_expr, index_expr);
     }
     else if (peek(TokenType::DOUBLE_COLON) and v) {
         // Could be an import access OR an enum access. This is resolved at verification stage
@@ -864,7 +878,7 @@ auto Parser::parse_postfix_expr() -> std::shared_ptr<Expr> {
         match(TokenType::DOUBLE_COLON);
         auto expr = parse_postfix_expr();
         finish(p);
-        return std::make_shared<ImportExpr>(p, expr, import_name);
+        return make_node<ImportExpr>(p, expr, import_name);
     }
     else if (peek(TokenType::DOT) or peek(TokenType::ARROW)) {
         auto is_arrow = try_consume(TokenType::ARROW);
@@ -874,13 +888,13 @@ auto Parser::parse_postfix_expr() -> std::shared_ptr<Expr> {
         auto field_name = parse_ident();
         if (!peek(TokenType::OPEN_BRACKET)) {
             finish(p);
-            return std::make_shared<FieldAccessExpr>(p, p_expr, field_name, is_arrow);
+            return make_node<FieldAccessExpr>(p, p_expr, field_name, is_arrow);
         }
         else {
             match(TokenType::OPEN_BRACKET);
             auto args = parse_arg_list();
             finish(p);
-            return std::make_shared<MethodAccessExpr>(p, p_expr, field_name, args, is_arrow);
+            return make_node<MethodAccessExpr>(p, p_expr, field_name, args, is_arrow);
         }
     }
     else {
@@ -888,36 +902,36 @@ auto Parser::parse_postfix_expr() -> std::shared_ptr<Expr> {
     }
 }
 
-auto Parser::parse_primary_expr() -> std::shared_ptr<Expr> {
+auto Parser::parse_primary_expr() -> Expr* {
     auto p = Position{};
     start(p);
     if (peek(TokenType::IDENT)) {
         auto const value = parse_ident();
         finish(p);
-        return std::make_shared<VarExpr>(p, value);
+        return make_node<VarExpr>(p, value);
     }
     else if (peek(TokenType::INTEGER)) {
-        auto const value = std::stoll((*curr_token_)->lexeme());
+        auto const value = std::stoll(std::string{curr_token_->lexeme()});
         consume();
         finish(p);
-        return std::make_shared<IntExpr>(p, value);
+        return make_node<IntExpr>(p, value);
     }
     else if (peek(TokenType::NULL_)) {
         consume();
         finish(p);
-        return std::make_shared<NullExpr>(p);
+        return make_node<NullExpr>(p);
     }
     else if (peek(TokenType::FLOAT_LITERAL)) {
-        auto const value = std::stod((*curr_token_)->lexeme());
+        auto const value = std::stod(std::string{curr_token_->lexeme()});
         consume();
         finish(p);
-        return std::make_shared<DecimalExpr>(p, value);
+        return make_node<DecimalExpr>(p, value);
     }
     else if (peek(TokenType::UNSIGNED_INTEGER)) {
-        auto const value = std::stoull((*curr_token_)->lexeme());
+        auto const value = std::stoull(std::string{curr_token_->lexeme()});
         consume();
         finish(p);
-        return std::make_shared<UIntExpr>(p, value);
+        return make_node<UIntExpr>(p, value);
     }
     else if (peek(TokenType::OPEN_BRACKET)) {
         match(TokenType::OPEN_BRACKET);
@@ -926,31 +940,31 @@ auto Parser::parse_primary_expr() -> std::shared_ptr<Expr> {
         return expr;
     }
     else if (peek(TokenType::TRUE) or peek(TokenType::FALSE)) {
-        auto const value = (*curr_token_)->type_matches(TokenType::TRUE);
+        auto const value = curr_token_->type_matches(TokenType::TRUE);
         consume();
         finish(p);
-        return std::make_shared<BoolExpr>(p, value);
+        return make_node<BoolExpr>(p, value);
     }
     else if (peek(TokenType::STRING_LITERAL)) {
-        auto const value = (*curr_token_)->lexeme();
+        auto const value = std::string{curr_token_->lexeme()};
         consume();
         finish(p);
-        return std::make_shared<StringExpr>(p, value);
+        return make_node<StringExpr>(p, value);
     }
     else if (peek(TokenType::CHAR_LITERAL)) {
-        auto const value = (*curr_token_)->lexeme();
+        auto const value = curr_token_->lexeme();
         if (value.size() > 1) {
-            syntactic_error("18: character literal may only have one character: '%'", value);
+            syntactic_error("18: character literal may only have one character: '%'", std::string{value});
         }
         consume();
         finish(p);
-        return std::make_shared<CharExpr>(p, value.at(0));
+        return make_node<CharExpr>(p, value.at(0));
     }
 
     auto stream = std::stringstream{};
-    stream << *(*curr_token_);
+    stream << *curr_token_;
     syntactic_error("UNRECOGNIZED PRIMARY EXPRESSION: %", stream.str());
-    return std::make_shared<EmptyExpr>(p);
+    return make_node<EmptyExpr>(p);
 }
 
 auto Parser::is_assignment_operator() -> bool {
@@ -2,21 +2,21 @@
 #define PARSER_HPP
 
 #include "./handler.hpp"
+#include "./lexer.hpp"
 #include "./module.hpp"
 #include "./token.hpp"
+#include <array>
 #include <vector>
 
 class Parser {
  public:
-    Parser(std::vector<std::shared_ptr<Token>>& tokens,
-           std::string const& filename,
-           std::shared_ptr<Handler> handler = nullptr)
-    : tokens_{tokens}
+    // Tokens are pulled from the lexer as parsing goes, so only a few are ever held at once
+    Parser(Lexer& lexer, std::string const& filename, std::shared_ptr<Handler> handler = nullptr)
+    : lexer_{lexer}
     , filename_{filename}
     , handler_{handler} {
-        if (!tokens.empty()) {
-            curr_token_ = tokens_.front();
-        }
+        fill(0);
+        curr_token_ = (window_size_ > 0) ? &window_.front() : nullptr;
     }
 
     ~Parser() = default;
@@ -25,11 +25,22 @@ class Parser {
     bool in_new_expr_ = false;
 
  private:
-    std::vector<std::shared_ptr<Token>>& tokens_;
+    // How far ahead peek can look, the current token included
+    static constexpr auto lookahead_ = size_t{4};
+
+    Lexer& lexer_;
     std::string const& filename_;
     std::shared_ptr<Handler> handler_;
-    std::optional<std::shared_ptr<Token>> curr_token_ = std::nullopt;
-    std::size_t index = 0;
+    // Ring buffer of the tokens pulled but not yet consumed, starting from the current one
+    std::array<Token, lookahead_> window_ = {};
+    size_t window_start_ = 0;
+    size_t window_size_ = 0;
+    // Where the last token of the source is, once the lexer has given it
+    Position last_pos_ = {};
+    Token const* curr_token_ = nullptr;
+
+    // Pulls tokens until the one pos ahead of the current one is in the window, or the source runs out
+    auto fill(size_t pos) -> void;
 
     auto try_consume(TokenType t) -> bool;
     auto consume() -> void;
@@ -38,40 +49,40 @@ class Parser {
     auto finish(Position& pos) -> void;
     auto peek(TokenType t, size_t pos = 0) -> bool;
 
-    auto parse_class(Position p) -> std::shared_ptr<ClassDecl>;
+    auto parse_class(Position p) -> ClassDecl*;
 
     auto parse_operator() -> Op;
-    auto parse_ident() -> std::string;
-    auto parse_type() -> std::shared_ptr<Type>;
-    auto parse_import_type() -> std::shared_ptr<Type>;
-    auto parse_para_list() -> std::vector<std::shared_ptr<ParaDecl>>;
-    auto parse_type_list() -> std::vector<std::shared_ptr<Type>>;
-    auto parse_arg_list() -> std::vector<std::shared_ptr<Expr>>;
+    auto parse_ident() -> Symbol;
+    auto parse_type() -> Type*;
+    auto parse_import_type() -> Type*;
+    auto parse_para_list() -> std::vector<ParaDecl*>;
+    auto parse_type_list() -> std::vector<Type*>;
+    auto parse_arg_list() -> std::vector<Expr*>;
     auto parse_enum_list() -> std::vector<std::string>;
 
-    auto parse_compound_stmt() -> std::shared_ptr<CompoundStmt>;
-    auto parse_local_var_stmt() -> std::shared_ptr<LocalVarStmt>;
-    auto parse_return_stmt(Position p) -> std::shared_ptr<ReturnStmt>;
-    auto parse_while_stmt(Position p) -> std::shared_ptr<WhileStmt>;
-    auto parse_if_stmt(Position p) -> std::shared_ptr<IfStmt>;
-    auto parse_else_if_stmt(Position p) -> std::shared_ptr<ElseIfStmt>;
-    auto parse_expr_stmt(Position p) -> std::shared_ptr<ExprStmt>;
-    auto parse_loop_stmt(Position p) -> std::shared_ptr<LoopStmt>;
+    auto parse_compound_stmt() -> CompoundStmt*;
+    auto parse_local_var_stmt() -> LocalVarStmt*;
+    auto parse_return_stmt(Position p) -> ReturnStmt*;
+    auto parse_while_stmt(Position p) -> WhileStmt*;
+    auto parse_if_stmt(Position p) -> IfStmt*;
+    auto parse_else_if_stmt(Position p) -> ElseIfStmt*;
+    auto parse_expr_stmt(Position p) -> ExprStmt*;
+    auto parse_loop_stmt(Position p) -> LoopStmt*;
 
-    auto parse_expr() -> std::shared_ptr<Expr>;
-    auto parse_assignment_expr() -> std::shared_ptr<Expr>;
-    auto parse_logical_or_expr() -> std::shared_ptr<Expr>;
-    auto parse_logical_and_expr() -> std::shared_ptr<Expr>;
-    auto parse_equality_expr() -> std::shared_ptr<Expr>;
-    auto parse_relational_expr() -> std::shared_ptr<Expr>;
-    auto parse_additive_expr() -> std::shared_ptr<Expr>;
-    auto parse_multiplicative_expr() -> std::shared_ptr<Expr>;
-    auto parse_unary_expr() -> std::shared_ptr<Expr>;
-    auto parse_postfix_expr() -> std::shared_ptr<Expr>;
-    auto parse_primary_expr() -> std::shared_ptr<Expr>;
-    auto parse_array_init_expr() -> std::shared_ptr<Expr>;
-    auto parse_size_of_expr() -> std::shared_ptr<Expr>;
-    auto parse_new_expr() -> std::shared_ptr<Expr>;
+    auto parse_expr() -> Expr*;
+    auto parse_assignment_expr() -> Expr*;
+    auto parse_logical_or_expr() -> Expr*;
+    auto parse_logical_and_expr() -> Expr*;
+    auto parse_equality_expr() -> Expr*;
+    auto parse_relational_expr() -> Expr*;
+    auto parse_additive_expr() -> Expr*;
+    auto parse_multiplicative_expr() -> Expr*;
+    auto parse_unary_expr() -> Expr*;
+    auto parse_postfix_expr() -> Expr*;
+    auto parse_primary_expr() -> Expr*;
+    auto parse_array_init_expr() -> Expr*;
+    auto parse_size_of_expr() -> Expr*;
+    auto parse_new_expr() -> Expr*;
 
     auto is_assignment_operator() -> bool;
 
@@ -0,0 +1,130 @@
+#include "./stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sys/resource.h>
+
+#include "llvm/Support/TimeProfiler.h"
+
+Stats::Phase::Phase(Stats& stats, std::string name, std::string module)
+: stats_(stats)
+, name_(std::move(name))
+, module_(std::move(module))
+, start_(Clock::now())
+, parent_(stats.active_) {
+    stats_.active_ = this;
+    if (llvm::timeTraceProfilerEnabled()) {
+        llvm::timeTraceProfilerBegin(name_, module_);
+    }
+}
+
+Stats::Phase::~Phase() {
+    if (llvm::timeTraceProfilerEnabled()) {
+        llvm::timeTraceProfilerEnd();
+    }
+
+    auto const elapsed = Clock::now() - start_;
+    if (parent_) {
+        parent_->nested_ += elapsed;
+    }
+    stats_.active_ = parent_;
+
+    auto const self_ms = std::chrono::duration<double, std::milli>(elapsed - nested_).count();
+    auto const lock = std::lock_guard{stats_.mutex_};
+    stats_.samples_.push_back(Sample{name_, module_, self_ms, peak_rss_kb()});
+}
+
+auto Stats::add_count(std::string const& name, size_t count) -> void {
+    auto const lock = std::lock_guard{mutex_};
+    auto it = std::find_if(counts_.begin(), counts_.end(), [&name](auto const& c) { return c.first == name; });
+    if (it == counts_.end()) {
+        counts_.emplace_back(name, count);
+    }
+    else {
+        it->second += count;
+    }
+}
+
+auto Stats::peak_rss_kb() -> long {
+    auto usage = rusage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static auto json_escape(std::string const& str) -> std::string {
+    auto escaped = std::string{};
+    for (auto const c : str) {
+        if (c == '"' or c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+auto Stats::print(std::ostream& os) const -> void {
+    // Phase totals in the order each phase first finished, RSS is the peak seen at the end of the phase
+    struct Total {
+        std::string name;
+        double ms;
+        long peak_rss_kb;
+    };
+    auto totals = std::vector<Total>{};
+    for (auto const& sample : samples_) {
+        auto it = std::find_if(totals.begin(), totals.end(), [&sample](auto const& t) { return t.name == sample.name; });
+        if (it == totals.end()) {
+            totals.push_back(Total{sample.name, sample.ms, sample.peak_rss_kb});
+        }
+        else {
+            it->ms += sample.ms;
+            it->peak_rss_kb = std::max(it->peak_rss_kb, sample.peak_rss_kb);
+        }
+    }
+
+    auto const row = [&os](std::string const& name) -> std::ostream& {
+        return os << "    " << std::left << std::setw(20) << name << std::right << std::setw(12);
+    };
+
+    os << std::fixed << std::setprecision(3);
+    os << "Compilation statistics:\n";
+    row("phase") << "time (ms)" << std::setw(16) << "peak RSS (MiB)" << "\n";
+    for (auto const& total : totals) {
+        row(total.name) << total.ms << std::setw(16) << total.peak_rss_kb / 1024.0 << "\n";
+    }
+    auto const wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - created_).count();
+    row("total") << wall_ms << std::setw(16) << peak_rss_kb() / 1024.0 << "\n";
+
+    os << "\nPer module:\n";
+    for (auto const& sample : samples_) {
+        if (!sample.module.empty()) {
+            row(sample.name) << sample.ms << "  " << sample.module << "\n";
+        }
+    }
+
+    os << "\nCounts:\n";
+    for (auto const& [name, count] : counts_) {
+        row(name) << count << "\n";
+    }
+    os << std::defaultfloat;
+}
+
+auto Stats::print_json(std::ostream& os) const -> void {
+    auto const wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - created_).count();
+    os << "{\n  \"total_ms\": " << wall_ms << ",\n  \"peak_rss_kb\": " << peak_rss_kb() << ",\n";
+
+    os << "  \"phases\": [";
+    for (auto i = 0u; i < samples_.size(); ++i) {
+        auto const& sample = samples_[i];
+        os << ((i == 0) ? "\n" : ",\n");
+        os << "    {\"name\": \"" << sample.name << "\", \"module\": \"" << json_escape(sample.module)
+           << "\", \"ms\": " << sample.ms << ", \"peak_rss_kb\": " << sample.peak_rss_kb << "}";
+    }
+    os << "\n  ],\n";
+
+    os << "  \"counts\": {";
+    for (auto i = 0u; i < counts_.size(); ++i) {
+        os << ((i == 0) ? "\n" : ",\n");
+        os << "    \"" << counts_[i].first << "\": " << counts_[i].second;
+    }
+    os << "\n  }\n}\n";
+}
@@ -0,0 +1,63 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Collects per-phase timings and counters for -s/--stat. Phases nest (e.g. a file is read while it's being
+// lexed), so each phase records its self time only. Phases nest per thread and may run on several at once.
+// Every phase is also a --time-trace event when the LLVM time trace profiler is running.
+class Stats {
+ public:
+    using Clock = std::chrono::steady_clock;
+
+    class Phase {
+     public:
+        Phase(Stats& stats, std::string name, std::string module);
+        Phase(Phase const&) = delete;
+        auto operator=(Phase const&) -> Phase& = delete;
+        ~Phase();
+
+     private:
+        Stats& stats_;
+        std::string name_;
+        std::string module_;
+        Clock::time_point start_;
+        Clock::duration nested_ = {};
+        Phase* parent_ = nullptr;
+
+        friend class Stats;
+    };
+
+    // Usage: auto phase = stats.phase("lex", filename);
+    auto phase(std::string name, std::string module = "") -> Phase {
+        return Phase{*this, std::move(name), std::move(module)};
+    }
+
+    auto add_count(std::string const& name, size_t count) -> void;
+
+    auto print(std::ostream& os) const -> void;
+    auto print_json(std::ostream& os) const -> void;
+
+ private:
+    struct Sample {
+        std::string name;
+        std::string module;
+        double ms;
+        long peak_rss_kb;
+    };
+
+    static auto peak_rss_kb() -> long;
+
+    inline static thread_local Phase* active_ = nullptr;
+    std::mutex mutex_ = {};
+    Clock::time_point created_ = Clock::now();
+    std::vector<Sample> samples_;
+    std::vector<std::pair<std::string, size_t>> counts_;
+};
+
+#endif // STATS_HPP
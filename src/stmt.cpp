@@ -11,6 +11,17 @@ auto EmptyStmt::print(std::ostream& os) const -> void {
     os << ";\n";
 }
 
+CompoundStmt::CompoundStmt(Position const pos, std::vector<Stmt*> stmts)
+: Stmt(NodeKind::COMPOUND_STMT, pos)
+, stmts_(stmts) {
+    for (auto const& stmt : stmts_) {
+        if (isa<ReturnStmt>(stmt)) {
+            has_return_ = true;
+            break;
+        }
+    }
+}
+
 auto CompoundStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     for (auto& stmt : stmts_) {
         stmt->codegen(emitter);
@@ -40,7 +51,7 @@ auto LocalVarStmt::print(std::ostream& os) const -> void {
     return;
 }
 auto ReturnStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
-    if (std::dynamic_pointer_cast<EmptyExpr>(expr_)) {
+    if (isa<EmptyExpr>(expr_)) {
         return emitter->llvm_builder->CreateRetVoid();
     }
     auto const& val = expr_->codegen(emitter);
@@ -127,7 +138,7 @@ auto IfStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     emitter->llvm_builder->SetInsertPoint(middle_block);
 
     stmt_one_->codegen(emitter);
-    auto temp = std::dynamic_pointer_cast<CompoundStmt>(stmt_one_);
+    auto temp = dyn_cast<CompoundStmt>(stmt_one_);
     if ((!temp or (temp and !temp->has_return())) and !emitter->llvm_builder->GetInsertBlock()->getTerminator()) {
         emitter->llvm_builder->CreateBr(bottom_block);
     }
@@ -135,11 +146,11 @@ auto IfStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     emitter->llvm_builder->SetInsertPoint(else_block);
     stmt_two_->codegen(emitter);
     stmt_three_->codegen(emitter);
-    if (std::dynamic_pointer_cast<EmptyStmt>(stmt_three_)) {
+    if (isa<EmptyStmt>(stmt_three_)) {
         emitter->llvm_builder->CreateBr(bottom_block);
     }
 
-    temp = std::dynamic_pointer_cast<CompoundStmt>(stmt_one_);
+    temp = dyn_cast<CompoundStmt>(stmt_one_);
     if ((!temp or (temp and !temp->has_return())) and !emitter->llvm_builder->GetInsertBlock()->getTerminator()) {
         emitter->llvm_builder->CreateBr(bottom_block);
     }
@@ -174,7 +185,7 @@ auto ElseIfStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     emitter->llvm_builder->SetInsertPoint(middle_block);
     stmt_one_->codegen(emitter);
 
-    auto temp = std::dynamic_pointer_cast<CompoundStmt>(stmt_one_);
+    auto temp = dyn_cast<CompoundStmt>(stmt_one_);
     if ((!temp or (temp and !temp->has_return())) and !emitter->llvm_builder->GetInsertBlock()->getTerminator()) {
         emitter->llvm_builder->CreateBr(emitter->true_bottom);
     }
@@ -198,8 +209,8 @@ auto ElseIfStmt::print(std::ostream& os) const -> void {
 auto LoopStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     auto l_v = var_decl_;
     auto llvm_type = emitter->llvm_type(l_v->get_type());
-    auto alloca = emitter->llvm_builder->CreateAlloca(llvm_type, nullptr, l_v->get_ident() + l_v->get_append());
-    emitter->named_values[l_v->get_ident() + l_v->get_append()] = alloca;
+    auto alloca = emitter->llvm_builder->CreateAlloca(llvm_type, nullptr, l_v->get_local_symbol().str());
+    emitter->locals[l_v->get_slot()] = alloca;
 
     llvm::Value* val;
     if (lower_bound_.has_value()) {
@@ -298,27 +309,27 @@ auto ContinueStmt::print(std::ostream& os) const -> void {
     os << "continue;\n";
 }
 
-auto DeleteStmt::get_pointer(std::shared_ptr<Emitter> emitter, std::shared_ptr<VarExpr> e) -> llvm::Value* {
-    auto is_field_access = std::dynamic_pointer_cast<ClassFieldDecl>(e->get_ref());
+auto DeleteStmt::get_pointer(std::shared_ptr<Emitter> emitter, VarExpr* e) -> llvm::Value* {
+    auto is_field_access = dyn_cast<ClassFieldDecl>(e->get_ref());
     if (is_field_access) {
         assert(emitter->curr_class_ != nullptr);
         auto const field_index = emitter->curr_class_->get_index_for_field(is_field_access->get_ident());
-        auto const this_ptr = emitter->named_values["this"];
+        auto const this_ptr = emitter->locals[Emitter::this_slot];
         auto const class_type = emitter->llvm_type(emitter->curr_class_);
 
         auto const this_pointer = emitter->llvm_builder->CreateLoad(llvm::PointerType::getUnqual(class_type), this_ptr);
-        auto const val = emitter->llvm_builder->CreateStructGEP(class_type, this_pointer, field_index);
-        return emitter->llvm_builder->CreateLoad(emitter->llvm_type(e->get_type()), val);
+        // The field itself is nulled, not the memory it pointed to
+        return emitter->llvm_builder->CreateStructGEP(class_type, this_pointer, field_index);
     }
 
-    return emitter->named_values[e->get_name() + e->get_ref()->get_append()];
+    return emitter->storage(e->get_ref());
 }
 
 auto DeleteStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
     auto val = expr_->codegen(emitter);
     auto t = expr_->get_type();
     if (t->is_pointer()) {
-        auto free_func = emitter->llvm_module->getFunction("free");
+        auto free_func = emitter->free_function;
 
         auto const& function = emitter->llvm_builder->GetInsertBlock()->getParent();
         auto const if_block_value = std::to_string(emitter->global_counter++);
@@ -334,15 +345,14 @@ auto DeleteStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
 
         emitter->llvm_builder->SetInsertPoint(if_block);
 
-        auto p_t = std::dynamic_pointer_cast<PointerType>(t);
+        auto p_t = cast<PointerType>(t);
         if (p_t->get_sub_type()->is_class()) {
-            auto a_t = std::dynamic_pointer_cast<ClassType>(p_t->get_sub_type());
-            auto destructor = emitter->llvm_module->getFunction("destructor." + a_t->get_ref()->get_ident());
-            emitter->llvm_builder->CreateCall(destructor, {val});
+            auto a_t = cast<ClassType>(p_t->get_sub_type());
+            emitter->llvm_builder->CreateCall(a_t->get_ref()->get_llvm_destructor(), {val});
         }
 
         emitter->llvm_builder->CreateCall(free_func, {val});
-        if (auto e = std::dynamic_pointer_cast<VarExpr>(expr_)) {
+        if (auto e = dyn_cast<VarExpr>(expr_)) {
             auto mem = get_pointer(emitter, e);
             emitter->llvm_builder->CreateStore(
                 llvm::ConstantPointerNull::get(llvm::PointerType::getUnqual(llvm::Type::getInt8Ty(*(emitter->context)))),
@@ -353,9 +363,8 @@ auto DeleteStmt::codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* {
         emitter->llvm_builder->SetInsertPoint(else_block);
     }
     else {
-        auto class_t = std::dynamic_pointer_cast<ClassType>(t);
-        auto destructor = emitter->llvm_module->getFunction("destructor." + class_t->get_ref()->get_ident());
-        emitter->llvm_builder->CreateCall(destructor, {val});
+        auto class_t = cast<ClassType>(t);
+        emitter->llvm_builder->CreateCall(class_t->get_ref()->get_llvm_destructor(), {val});
     }
 
     return nullptr;
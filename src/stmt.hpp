@@ -9,8 +9,12 @@ class Expr;
 
 class Stmt : public AST {
  public:
-    Stmt(Position pos)
-    : AST(pos) {}
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() >= NodeKind::EMPTY_STMT and node->get_kind() <= NodeKind::DELETE_STMT;
+    }
+
+    Stmt(NodeKind kind, Position pos)
+    : AST(kind, pos) {}
 
     virtual ~Stmt() = default;
     auto visit(std::shared_ptr<Visitor> visitor) -> void override = 0;
@@ -20,45 +24,40 @@ class Stmt : public AST {
  private:
 };
 
-class EmptyStmt
-: public Stmt
-, public std::enable_shared_from_this<EmptyStmt> {
+class EmptyStmt : public Stmt {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::EMPTY_STMT;
+    }
+
     EmptyStmt(Position pos)
-    : Stmt(pos) {}
+    : Stmt(NodeKind::EMPTY_STMT, pos) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_empty_stmt(shared_from_this());
+        visitor->visit_empty_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 };
 
-class CompoundStmt
-: public Stmt
-, public std::enable_shared_from_this<CompoundStmt> {
+class CompoundStmt : public Stmt {
  public:
-    CompoundStmt(Position const pos, std::vector<std::shared_ptr<Stmt>> stmts)
-    : Stmt(pos)
-    , stmts_(stmts) {
-        for (auto const& stmt : stmts_) {
-            if (auto l = std::dynamic_pointer_cast<ReturnStmt>(stmt)) {
-                has_return_ = true;
-                break;
-            }
-        }
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::COMPOUND_STMT;
     }
+
+    CompoundStmt(Position const pos, std::vector<Stmt*> stmts);
     CompoundStmt(Position const pos)
-    : Stmt(pos)
+    : Stmt(NodeKind::COMPOUND_STMT, pos)
     , stmts_({}) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_compound_stmt(shared_from_this());
+        visitor->visit_compound_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto get_stmts() const -> std::vector<std::shared_ptr<Stmt>> {
+    auto get_stmts() const -> std::vector<Stmt*> {
         return stmts_;
     }
 
@@ -66,210 +65,220 @@ class CompoundStmt
         return has_return_;
     }
 
-    auto add_stmt(std::shared_ptr<Stmt> stmt) -> void {
+    auto add_stmt(Stmt* stmt) -> void {
         stmts_.push_back(stmt);
     }
 
  private:
-    std::vector<std::shared_ptr<Stmt>> stmts_;
+    std::vector<Stmt*> stmts_;
     bool has_return_ = false;
 };
 
-class LocalVarStmt
-: public Stmt
-, public std::enable_shared_from_this<LocalVarStmt> {
+class LocalVarStmt : public Stmt {
  public:
-    LocalVarStmt(Position pos, std::shared_ptr<LocalVarDecl> decl)
-    : Stmt(pos)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::LOCAL_VAR_STMT;
+    }
+
+    LocalVarStmt(Position pos, LocalVarDecl* decl)
+    : Stmt(NodeKind::LOCAL_VAR_STMT, pos)
     , decl_(decl) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_local_var_stmt(shared_from_this());
+        visitor->visit_local_var_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto get_decl() const -> std::shared_ptr<LocalVarDecl> {
+    auto get_decl() const -> LocalVarDecl* {
         return decl_;
     }
 
  private:
-    std::shared_ptr<LocalVarDecl> decl_;
+    LocalVarDecl* decl_;
 };
 
-class ReturnStmt
-: public Stmt
-, public std::enable_shared_from_this<ReturnStmt> {
+class ReturnStmt : public Stmt {
  public:
-    ReturnStmt(Position const pos, std::shared_ptr<Expr> expr)
-    : Stmt(pos)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::RETURN_STMT;
+    }
+
+    ReturnStmt(Position const pos, Expr* expr)
+    : Stmt(NodeKind::RETURN_STMT, pos)
     , expr_(expr) {}
 
-    auto get_expr() const -> std::shared_ptr<Expr> {
+    auto get_expr() const -> Expr* {
         return expr_;
     }
-    auto set_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr(Expr* expr) -> void {
         expr_ = expr;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_return_stmt(shared_from_this());
+        visitor->visit_return_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Expr> expr_;
+    Expr* expr_;
 };
 
-class ExprStmt
-: public Stmt
-, public std::enable_shared_from_this<ExprStmt> {
+class ExprStmt : public Stmt {
  public:
-    ExprStmt(Position const pos, std::shared_ptr<Expr> expr)
-    : Stmt(pos)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::EXPR_STMT;
+    }
+
+    ExprStmt(Position const pos, Expr* expr)
+    : Stmt(NodeKind::EXPR_STMT, pos)
     , expr_(expr) {}
 
-    auto get_expr() const -> std::shared_ptr<Expr> {
+    auto get_expr() const -> Expr* {
         return expr_;
     }
-    auto set_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr(Expr* expr) -> void {
         expr_ = expr;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_expr_stmt(shared_from_this());
+        visitor->visit_expr_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Expr> expr_;
+    Expr* expr_;
 };
 
-class WhileStmt
-: public Stmt
-, public std::enable_shared_from_this<WhileStmt> {
+class WhileStmt : public Stmt {
  public:
-    WhileStmt(Position const pos, std::shared_ptr<Expr> const cond, std::shared_ptr<CompoundStmt> const compound_stmt)
-    : Stmt(pos)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::WHILE_STMT;
+    }
+
+    WhileStmt(Position const pos, Expr* const cond, CompoundStmt* const compound_stmt)
+    : Stmt(NodeKind::WHILE_STMT, pos)
     , cond_(cond)
     , compound_stmt_{compound_stmt} {}
 
-    auto get_cond() const -> std::shared_ptr<Expr> {
+    auto get_cond() const -> Expr* {
         return cond_;
     }
 
-    auto get_stmts() const -> std::shared_ptr<CompoundStmt> {
+    auto get_stmts() const -> CompoundStmt* {
         return compound_stmt_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_while_stmt(shared_from_this());
+        visitor->visit_while_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Expr> const cond_;
-    std::shared_ptr<CompoundStmt> compound_stmt_;
+    Expr* const cond_;
+    CompoundStmt* compound_stmt_;
 };
 
-class IfStmt
-: public Stmt
-, public std::enable_shared_from_this<IfStmt> {
+class IfStmt : public Stmt {
  public:
-    IfStmt(Position const pos,
-           std::shared_ptr<Expr> const cond,
-           std::shared_ptr<Stmt> const stmt_one,
-           std::shared_ptr<Stmt> const stmt_two,
-           std::shared_ptr<Stmt> const stmt_three)
-    : Stmt(pos)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::IF_STMT;
+    }
+
+    IfStmt(Position const pos, Expr* const cond, Stmt* const stmt_one, Stmt* const stmt_two, Stmt* const stmt_three)
+    : Stmt(NodeKind::IF_STMT, pos)
     , cond_(cond)
     , stmt_one_(stmt_one)
     , stmt_two_(stmt_two)
     , stmt_three_(stmt_three) {}
 
-    auto get_cond() const -> std::shared_ptr<Expr> {
+    auto get_cond() const -> Expr* {
         return cond_;
     }
 
-    auto get_body_stmt() const -> std::shared_ptr<Stmt> {
+    auto get_body_stmt() const -> Stmt* {
         return stmt_one_;
     }
 
-    auto get_else_if_stmt() const -> std::shared_ptr<Stmt> {
+    auto get_else_if_stmt() const -> Stmt* {
         return stmt_two_;
     }
 
-    auto get_else_stmt() const -> std::shared_ptr<Stmt> {
+    auto get_else_stmt() const -> Stmt* {
         return stmt_three_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_if_stmt(shared_from_this());
+        visitor->visit_if_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Expr> const cond_;
-    std::shared_ptr<Stmt> const stmt_one_, stmt_two_, stmt_three_;
+    Expr* const cond_;
+    Stmt* const stmt_one_;
+    Stmt* const stmt_two_;
+    Stmt* const stmt_three_;
 };
 
-class ElseIfStmt
-: public Stmt
-, public std::enable_shared_from_this<ElseIfStmt> {
+class ElseIfStmt : public Stmt {
  public:
-    ElseIfStmt(Position const pos,
-               std::shared_ptr<Expr> const cond,
-               std::shared_ptr<Stmt> const stmt_one,
-               std::shared_ptr<Stmt> const stmt_two)
-    : Stmt(pos)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::ELSE_IF_STMT;
+    }
+
+    ElseIfStmt(Position const pos, Expr* const cond, Stmt* const stmt_one, Stmt* const stmt_two)
+    : Stmt(NodeKind::ELSE_IF_STMT, pos)
     , cond_(cond)
     , stmt_one_(stmt_one)
     , stmt_two_(stmt_two) {}
 
-    auto get_cond() const -> std::shared_ptr<Expr> {
+    auto get_cond() const -> Expr* {
         return cond_;
     }
 
-    auto get_body_stmt() const -> std::shared_ptr<Stmt> {
+    auto get_body_stmt() const -> Stmt* {
         return stmt_one_;
     }
 
-    auto get_nested_else_if_stmt() const -> std::shared_ptr<Stmt> {
+    auto get_nested_else_if_stmt() const -> Stmt* {
         return stmt_two_;
     }
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_else_if_stmt(shared_from_this());
+        visitor->visit_else_if_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
  private:
-    std::shared_ptr<Expr> const cond_;
-    std::shared_ptr<Stmt> const stmt_one_, stmt_two_;
+    Expr* const cond_;
+    Stmt* const stmt_one_;
+    Stmt* const stmt_two_;
 };
 
-class LoopStmt
-: public Stmt
-, public std::enable_shared_from_this<LoopStmt> {
+class LoopStmt : public Stmt {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::LOOP_STMT;
+    }
+
     LoopStmt(Position const pos,
-             std::string const& var_name,
-             std::optional<std::shared_ptr<Expr>> lower_bound,
-             std::optional<std::shared_ptr<Expr>> upper_bound,
-             std::shared_ptr<Stmt> body_stmt)
-    : Stmt(pos)
+             Symbol const var_name,
+             std::optional<Expr*> lower_bound,
+             std::optional<Expr*> upper_bound,
+             Stmt* body_stmt)
+    : Stmt(NodeKind::LOOP_STMT, pos)
     , var_name_(var_name)
     , lower_bound_(lower_bound)
     , upper_bound_(upper_bound)
     , body_stmt_(body_stmt) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_loop_stmt(shared_from_this());
+        visitor->visit_loop_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
@@ -277,95 +286,101 @@ class LoopStmt
     auto has_lower_bound() const -> bool {
         return lower_bound_.has_value();
     }
-    auto get_lower_bound() const -> std::optional<std::shared_ptr<Expr>> {
+    auto get_lower_bound() const -> std::optional<Expr*> {
         return lower_bound_;
     }
-    auto set_lower_bound(std::shared_ptr<Expr> expr) -> void {
+    auto set_lower_bound(Expr* expr) -> void {
         lower_bound_ = expr;
     }
     auto has_upper_bound() const -> bool {
         return upper_bound_.has_value();
     }
-    auto get_upper_bound() const -> std::optional<std::shared_ptr<Expr>> {
+    auto get_upper_bound() const -> std::optional<Expr*> {
         return upper_bound_;
     }
-    auto set_upper_bound(std::shared_ptr<Expr> expr) -> void {
+    auto set_upper_bound(Expr* expr) -> void {
         upper_bound_ = expr;
     }
-    auto get_var_name() const -> std::string {
-        return var_name_;
+    auto get_var_name() const -> std::string const& {
+        return var_name_.str();
     }
-    auto set_var_decl(std::shared_ptr<LocalVarDecl> var_decl) -> void {
+    auto set_var_decl(LocalVarDecl* var_decl) -> void {
         var_decl_ = var_decl;
     }
-    auto get_var_decl() const -> std::shared_ptr<LocalVarDecl> {
+    auto get_var_decl() const -> LocalVarDecl* {
         return var_decl_;
     }
-    auto get_body_stmt() const -> std::shared_ptr<Stmt> {
+    auto get_body_stmt() const -> Stmt* {
         return body_stmt_;
     }
 
  private:
-    std::string var_name_;
-    std::optional<std::shared_ptr<Expr>> lower_bound_;
-    std::optional<std::shared_ptr<Expr>> upper_bound_;
-    std::shared_ptr<Stmt> body_stmt_;
-    std::shared_ptr<LocalVarDecl> var_decl_;
+    Symbol var_name_;
+    std::optional<Expr*> lower_bound_;
+    std::optional<Expr*> upper_bound_;
+    Stmt* body_stmt_;
+    LocalVarDecl* var_decl_;
 };
 
-class BreakStmt
-: public Stmt
-, public std::enable_shared_from_this<BreakStmt> {
+class BreakStmt : public Stmt {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::BREAK_STMT;
+    }
+
     BreakStmt(Position const pos)
-    : Stmt(pos) {}
+    : Stmt(NodeKind::BREAK_STMT, pos) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_break_stmt(shared_from_this());
+        visitor->visit_break_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 };
 
-class ContinueStmt
-: public Stmt
-, public std::enable_shared_from_this<ContinueStmt> {
+class ContinueStmt : public Stmt {
  public:
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::CONTINUE_STMT;
+    }
+
     ContinueStmt(Position const pos)
-    : Stmt(pos) {}
+    : Stmt(NodeKind::CONTINUE_STMT, pos) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_continue_stmt(shared_from_this());
+        visitor->visit_continue_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 };
 
-class DeleteStmt
-: public Stmt
-, public std::enable_shared_from_this<DeleteStmt> {
+class DeleteStmt : public Stmt {
  public:
-    DeleteStmt(Position const pos, std::shared_ptr<Expr> expr)
-    : Stmt(pos)
+    static auto classof(AST const* node) -> bool {
+        return node->get_kind() == NodeKind::DELETE_STMT;
+    }
+
+    DeleteStmt(Position const pos, Expr* expr)
+    : Stmt(NodeKind::DELETE_STMT, pos)
     , expr_(std::move(expr)) {}
 
     auto visit(std::shared_ptr<Visitor> visitor) -> void override {
-        visitor->visit_delete_stmt(shared_from_this());
+        visitor->visit_delete_stmt(this);
     }
     auto codegen(std::shared_ptr<Emitter> emitter) -> llvm::Value* override;
     auto print(std::ostream& os) const -> void override;
 
-    auto get_pointer(std::shared_ptr<Emitter> emitter, std::shared_ptr<VarExpr> e) -> llvm::Value*;
+    auto get_pointer(std::shared_ptr<Emitter> emitter, VarExpr* e) -> llvm::Value*;
 
-    auto get_expr() const -> std::shared_ptr<Expr> {
+    auto get_expr() const -> Expr* {
         return expr_;
     }
-    auto set_expr(std::shared_ptr<Expr> expr) -> void {
+    auto set_expr(Expr* expr) -> void {
         expr_ = expr;
     }
 
  private:
-    std::shared_ptr<Expr> expr_;
+    Expr* expr_;
 };
 
 #endif // STMT_HPP
\ No newline at end of file
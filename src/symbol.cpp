@@ -0,0 +1,110 @@
+#include "./symbol.hpp"
+
+#include <llvm/Support/MathExtras.h>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+class Interner {
+ public:
+    Interner() {
+        intern("");
+    }
+
+    ~Interner() {
+        for (auto& segment : segments_) {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Modules are lexed on several threads, and each thread mostly meets spellings it's already interned, so it
+    // remembers their ids and only shares the table for the ones it hasn't seen
+    auto intern(std::string_view spelling) -> uint32_t {
+        thread_local auto seen = std::unordered_map<std::string_view, uint32_t>{};
+        auto const it = seen.find(spelling);
+        if (it != seen.end()) {
+            return it->second;
+        }
+        auto const id = intern_shared(spelling);
+        seen.emplace(this->spelling(id), id);
+        return id;
+    }
+
+    // Spellings are published as they're interned, so reading one back never waits on a writer
+    auto spelling(uint32_t id) const -> std::string const& {
+        auto const [segment, offset] = locate(id);
+        return *segments_[segment].load(std::memory_order_acquire)[offset].load(std::memory_order_acquire);
+    }
+
+    auto size() const -> size_t {
+        auto const lock = std::shared_lock{mutex_};
+        return spellings_.size();
+    }
+
+ private:
+    // Ids index segments that double in size, so none is ever reallocated once readers can see it
+    static constexpr auto first_segment_bits = 10u;
+    static constexpr auto num_segments = 33u - first_segment_bits;
+
+    static auto locate(uint32_t id) -> std::pair<uint32_t, uint32_t> {
+        auto const segment = llvm::Log2_32((id >> first_segment_bits) + 1);
+        return {segment, id - (((1u << segment) - 1) << first_segment_bits)};
+    }
+
+    auto intern_shared(std::string_view spelling) -> uint32_t {
+        {
+            auto const lock = std::shared_lock{mutex_};
+            auto const it = ids_.find(spelling);
+            if (it != ids_.end()) {
+                return it->second;
+            }
+        }
+        auto const lock = std::unique_lock{mutex_};
+        auto const it = ids_.find(spelling);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        // The deque never moves its strings, so the map can key on views of them
+        auto const& stored = spellings_.emplace_back(spelling);
+        auto const id = static_cast<uint32_t>(spellings_.size() - 1);
+        ids_.emplace(stored, id);
+
+        auto const [segment, offset] = locate(id);
+        if (offset == 0) {
+            segments_[segment].store(new std::atomic<std::string const*>[size_t{1} << (segment + first_segment_bits)]{},
+                                     std::memory_order_release);
+        }
+        segments_[segment].load(std::memory_order_relaxed)[offset].store(&stored, std::memory_order_release);
+        return id;
+    }
+
+    mutable std::shared_mutex mutex_ = {};
+    std::deque<std::string> spellings_ = {};
+    std::unordered_map<std::string_view, uint32_t> ids_ = {};
+    std::array<std::atomic<std::atomic<std::string const*>*>, num_segments> segments_ = {};
+};
+
+auto session_interner() -> Interner& {
+    static auto interner = Interner{};
+    return interner;
+}
+
+Symbol::Symbol(std::string_view spelling)
+: id_(session_interner().intern(spelling)) {}
+
+auto Symbol::str() const -> std::string const& {
+    return session_interner().spelling(id_);
+}
+
+auto Symbol::num_interned() -> size_t {
+    return session_interner().size();
+}
+
+auto operator<<(std::ostream& os, Symbol symbol) -> std::ostream& {
+    return os << symbol.str();
+}
@@ -0,0 +1,54 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// An interned identifier. Each spelling is interned once for the whole compilation session, so symbols from any
+// module compare and hash as 32-bit integers and only become strings again for diagnostics and LLVM names.
+class Symbol {
+ public:
+    // The empty identifier
+    Symbol() = default;
+
+    // Interns the spelling, implicit so names built as strings (e.g. "this") can be passed where a Symbol is taken
+    Symbol(std::string_view spelling);
+    Symbol(std::string const& spelling)
+    : Symbol(std::string_view{spelling}) {}
+    Symbol(char const* spelling)
+    : Symbol(std::string_view{spelling}) {}
+
+    auto id() const noexcept -> uint32_t {
+        return id_;
+    }
+
+    auto str() const -> std::string const&;
+
+    auto operator==(Symbol other) const noexcept -> bool {
+        return id_ == other.id_;
+    }
+    auto operator!=(Symbol other) const noexcept -> bool {
+        return id_ != other.id_;
+    }
+
+    // Number of distinct spellings interned so far, reported by -s/--stat
+    static auto num_interned() -> size_t;
+
+ private:
+    uint32_t id_ = 0;
+};
+
+auto operator<<(std::ostream& os, Symbol symbol) -> std::ostream&;
+
+template <>
+struct std::hash<Symbol> {
+    auto operator()(Symbol symbol) const noexcept -> size_t {
+        return symbol.id();
+    }
+};
+
+#endif // SYMBOL_HPP
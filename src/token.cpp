@@ -1,71 +1,78 @@
 #include "./token.hpp"
 
 #include <iostream>
-#include <map>
 
-auto operator<<(std::ostream& os, Position const& p) -> std::ostream& {
-    os << "{(";
-    os << p.line_start_ << ", " << p.col_start_ << ") -> (";
-    os << p.line_end_ << ", " << p.col_end_ << ")}";
+auto operator<<(std::ostream& os, Token const& t) -> std::ostream& {
+    os << "Token{lexeme: '" << t.lexeme() << "', position: " << t.pos() << ", type: " << t.type() << "}";
     return os;
 }
 
-Token::Token(std::string lexeme, size_t line_num, size_t line_end, size_t col_start, size_t col_end, TokenType type)
-: lexeme_{std::move(lexeme)}
-, position_{line_num, line_end, col_start, col_end}
-, type_{type} {}
+struct Keyword {
+    std::string_view spelling;
+    TokenType type;
+};
 
-Token::Token(std::string lexeme, size_t line_num, size_t col_start, size_t col_end, TokenType type)
-: lexeme_{std::move(lexeme)}
-, position_{line_num, line_num, col_start, col_end}
-, type_{type} {}
+// Keywords bucketed by length, so an identifier is only ever compared against a handful of candidates
+constexpr Keyword keywords_2[] = {{"fn", TokenType::FN},
+                                  {"as", TokenType::AS},
+                                  {"if", TokenType::IF},
+                                  {"i8", TokenType::TYPE},
+                                  {"u8", TokenType::TYPE},
+                                  {"or", TokenType::LOGICAL_OR},
+                                  {"in", TokenType::IN}};
+constexpr Keyword keywords_3[] = {{"i64", TokenType::TYPE},
+                                  {"i32", TokenType::TYPE},
+                                  {"u64", TokenType::TYPE},
+                                  {"u32", TokenType::TYPE},
+                                  {"f64", TokenType::TYPE},
+                                  {"f32", TokenType::TYPE},
+                                  {"mut", TokenType::MUT},
+                                  {"let", TokenType::LET},
+                                  {"and", TokenType::LOGICAL_AND},
+                                  {"pub", TokenType::PUB},
+                                  {"new", TokenType::NEW}};
+constexpr Keyword keywords_4[] = {{"else", TokenType::ELSE},
+                                  {"bool", TokenType::TYPE},
+                                  {"void", TokenType::TYPE},
+                                  {"true", TokenType::TRUE},
+                                  {"enum", TokenType::ENUM},
+                                  {"loop", TokenType::LOOP},
+                                  {"null", TokenType::NULL_}};
+constexpr Keyword keywords_5[] = {{"using", TokenType::USING},
+                                  {"while", TokenType::WHILE},
+                                  {"false", TokenType::FALSE},
+                                  {"class", TokenType::CLASS},
+                                  {"break", TokenType::BREAK}};
+constexpr Keyword keywords_6[] = {{"return", TokenType::RETURN},
+                                  {"extern", TokenType::EXTERN},
+                                  {"import", TokenType::IMPORT},
+                                  {"delete", TokenType::DELETE}};
+constexpr Keyword keywords_7[] = {{"else if", TokenType::ELSE_IF}, {"size_of", TokenType::SIZE_OF}};
+constexpr Keyword keywords_8[] = {{"continue", TokenType::CONTINUE}};
+constexpr Keyword keywords_10[] = {{"destructor", TokenType::DESTRUCTOR}};
 
-auto operator<<(std::ostream& os, Token const& t) -> std::ostream& {
-    os << "Token{lexeme: '" << t.lexeme() << "', position: " << t.pos() << ", type: " << t.type() << "}";
-    return os;
+template <size_t N>
+constexpr auto find_keyword(Keyword const (&bucket)[N], std::string_view str) -> std::optional<TokenType> {
+    for (auto const& keyword : bucket) {
+        if (keyword.spelling == str) {
+            return keyword.type;
+        }
+    }
+    return std::nullopt;
 }
 
-auto get_type_from_lexeme(std::string const& str) -> std::optional<TokenType> {
-    auto const lookup_map = std::map<std::string, TokenType>{{"fn", TokenType::FN},
-                                                             {"using", TokenType::USING},
-                                                             {"as", TokenType::AS},
-                                                             {"i64", TokenType::TYPE},
-                                                             {"i32", TokenType::TYPE},
-                                                             {"i8", TokenType::TYPE},
-                                                             {"u64", TokenType::TYPE},
-                                                             {"u32", TokenType::TYPE},
-                                                             {"u8", TokenType::TYPE},
-                                                             {"f64", TokenType::TYPE},
-                                                             {"f32", TokenType::TYPE},
-                                                             {"if", TokenType::IF},
-                                                             {"else", TokenType::ELSE},
-                                                             {"else if", TokenType::ELSE_IF},
-                                                             {"bool", TokenType::TYPE},
-                                                             {"void", TokenType::TYPE},
-                                                             {"mut", TokenType::MUT},
-                                                             {"let", TokenType::LET},
-                                                             {"return", TokenType::RETURN},
-                                                             {"extern", TokenType::EXTERN},
-                                                             {"while", TokenType::WHILE},
-                                                             {"true", TokenType::TRUE},
-                                                             {"false", TokenType::FALSE},
-                                                             {"enum", TokenType::ENUM},
-                                                             {"pub", TokenType::PUB},
-                                                             {"class", TokenType::CLASS},
-                                                             {"size_of", TokenType::SIZE_OF},
-                                                             {"and", TokenType::LOGICAL_AND},
-                                                             {"or", TokenType::LOGICAL_OR},
-                                                             {"loop", TokenType::LOOP},
-                                                             {"in", TokenType::IN},
-                                                             {"break", TokenType::BREAK},
-                                                             {"continue", TokenType::CONTINUE},
-                                                             {"import", TokenType::IMPORT},
-                                                             {"destructor", TokenType::DESTRUCTOR},
-                                                             {"delete", TokenType::DELETE},
-                                                             {"null", TokenType::NULL_},
-                                                             {"new", TokenType::NEW}};
-
-    return lookup_map.find(str) != lookup_map.end() ? std::make_optional(lookup_map.at(str)) : std::nullopt;
+auto get_type_from_lexeme(std::string_view str) -> std::optional<TokenType> {
+    switch (str.size()) {
+    case 2: return find_keyword(keywords_2, str);
+    case 3: return find_keyword(keywords_3, str);
+    case 4: return find_keyword(keywords_4, str);
+    case 5: return find_keyword(keywords_5, str);
+    case 6: return find_keyword(keywords_6, str);
+    case 7: return find_keyword(keywords_7, str);
+    case 8: return find_keyword(keywords_8, str);
+    case 10: return find_keyword(keywords_10, str);
+    default: return std::nullopt;
+    }
 }
 
 auto operator<<(std::ostream& os, TokenType const& t) -> std::ostream& {
@@ -138,9 +145,3 @@ auto operator<<(std::ostream& os, TokenType const& t) -> std::ostream& {
     }
     return os;
 }
-
-auto log_tokens(const std::vector<std::shared_ptr<Token>>& tokens) -> void {
-    for (const auto& token : tokens) {
-        std::cout << *token << "\n";
-    }
-}
\ No newline at end of file
@@ -1,14 +1,29 @@
 #ifndef TOKEN_HPP
 #define TOKEN_HPP
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "./symbol.hpp"
+
+// Where in the source something is: the file as numbered by the Handler, the byte offset it starts at and how many
+// bytes it spans. Line and column are only worked out, by Handler::locate, when a diagnostic needs them
 struct Position {
-    size_t line_start_, line_end_, col_start_, col_end_;
+    uint32_t offset_ = 0;
+    uint16_t file_ = 0;
+    uint16_t length_ = 0;
+
+    // Widens the position to end where a later one in the same file does
+    auto extend_to(Position const& end) -> void {
+        auto const end_offset = std::max(end.offset_ + end.length_, offset_ + length_);
+        length_ = static_cast<uint16_t>(std::min<uint32_t>(end_offset - offset_, UINT16_MAX));
+    }
 };
 
 auto operator<<(std::ostream& os, Position const& p) -> std::ostream&;
@@ -83,12 +98,16 @@ enum class TokenType {
     NEW,
 };
 
+// Tokens are plain values kept contiguously by the lexer. The lexeme is a view into the source buffer
+// owned by the Handler, or into Handler-owned storage for the few lexemes the lexer rewrites.
+// Identifiers are interned as they're lexed, so the rest of the pipeline works with their symbol.
 class Token {
  public:
     Token() = default;
-    Token(std::string lexeme, size_t line_num, size_t line_end, size_t col_start, size_t col_end, TokenType type);
-    Token(std::string lexeme, size_t line_num, size_t col_start, size_t col_end, TokenType type);
-    ~Token() = default;
+    Token(std::string_view lexeme, Position pos, TokenType type)
+    : lexeme_{lexeme}
+    , position_{pos}
+    , type_{type} {}
 
     auto pos() const -> Position {
         return position_;
@@ -96,22 +115,28 @@ class Token {
     auto type() const -> TokenType {
         return type_;
     }
-    auto lexeme() const -> std::string {
+    auto lexeme() const -> std::string_view {
         return lexeme_;
     }
+    auto symbol() const -> Symbol {
+        return symbol_;
+    }
+    auto set_symbol(Symbol symbol) -> void {
+        symbol_ = symbol;
+    }
 
-    auto type_matches(TokenType other) -> bool {
+    auto type_matches(TokenType other) const -> bool {
         return type_ == other;
     }
 
  private:
-    std::string lexeme_;
+    std::string_view lexeme_;
+    Symbol symbol_;
     Position position_;
     TokenType type_;
 };
 
-auto get_type_from_lexeme(std::string const& str) -> std::optional<TokenType>;
-auto log_tokens(const std::vector<std::shared_ptr<Token>>& tokens) -> void;
+auto get_type_from_lexeme(std::string_view str) -> std::optional<TokenType>;
 auto operator<<(std::ostream& os, TokenType const& t) -> std::ostream&;
 auto operator<<(std::ostream& os, Token const& t) -> std::ostream&;
 
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <map>
+#include <mutex>
 
 auto operator<<(std::ostream& os, Type const& t) -> std::ostream& {
     t.print(os);
@@ -10,35 +11,132 @@ auto operator<<(std::ostream& os, Type const& t) -> std::ostream& {
 }
 
 auto soft_typespec_equals(TypeSpec const& a, TypeSpec const& b) -> bool {
-    auto signed_int = std::vector<TypeSpec>{TypeSpec::I8, TypeSpec::I32, TypeSpec::I64};
-    auto is_signed_int = [signed_int](TypeSpec const& a) -> bool {
-        return std::find(signed_int.begin(), signed_int.end(), a) != signed_int.end();
+    // Integers of the same signedness match whatever their width, as do floats
+    enum class Family { SIGNED_INT, UNSIGNED_INT, FLOAT, OTHER };
+    auto const family = [](TypeSpec t) -> Family {
+        switch (t) {
+        case TypeSpec::I8:
+        case TypeSpec::I32:
+        case TypeSpec::I64: return Family::SIGNED_INT;
+        case TypeSpec::U8:
+        case TypeSpec::U32:
+        case TypeSpec::U64: return Family::UNSIGNED_INT;
+        case TypeSpec::F32:
+        case TypeSpec::F64: return Family::FLOAT;
+        default: return Family::OTHER;
+        }
     };
+    return a == b or (family(a) != Family::OTHER and family(a) == family(b));
+}
+
+auto Type::predicates_of(TypeSpec t) -> uint8_t {
+    switch (t) {
+    case TypeSpec::I8:
+    case TypeSpec::I32:
+    case TypeSpec::I64: return primitive_bit | signed_int_bit;
+    case TypeSpec::U8:
+    case TypeSpec::U32:
+    case TypeSpec::U64: return primitive_bit | unsigned_int_bit;
+    case TypeSpec::F32:
+    case TypeSpec::F64: return primitive_bit | decimal_bit;
+    case TypeSpec::BOOL:
+    case TypeSpec::POINTER:
+    case TypeSpec::ARRAY: return primitive_bit;
+    default: return 0;
+    }
+}
 
-    if (is_signed_int(a) and is_signed_int(b))
-        return true;
+auto TypeContext::get() -> TypeContext& {
+    static auto context = TypeContext{};
+    return context;
+}
 
-    auto unsigned_int = std::vector<TypeSpec>{TypeSpec::U8, TypeSpec::U32, TypeSpec::U64};
-    auto is_unsigned_int = [unsigned_int](TypeSpec const& a) -> bool {
-        return std::find(unsigned_int.begin(), unsigned_int.end(), a) != unsigned_int.end();
-    };
+template <typename T, typename Key, typename... Args>
+auto TypeContext::unique(std::map<Key, T*>& types, Key const& key, Args&&... args) -> T* {
+    {
+        auto const lock = std::shared_lock{mutex_};
+        auto const it = types.find(key);
+        if (it != types.end()) {
+            return it->second;
+        }
+    }
+    auto const lock = std::unique_lock{mutex_};
+    auto const [it, inserted] = types.try_emplace(key, nullptr);
+    if (inserted) {
+        it->second = arena_.make<T>(std::forward<Args>(args)...);
+    }
+    return it->second;
+}
 
-    if (is_unsigned_int(a) and is_unsigned_int(b))
-        return true;
+auto TypeContext::get_type(TypeSpec t) -> Type* {
+    return unique(types_, t, t);
+}
 
-    auto floats = std::vector<TypeSpec>{TypeSpec::F32, TypeSpec::F64};
-    auto is_float = [floats](TypeSpec const& a) -> bool {
-        return std::find(floats.begin(), floats.end(), a) != floats.end();
-    };
+auto TypeContext::get_pointer(Type* sub_type) -> PointerType* {
+    return unique(pointers_, sub_type, sub_type);
+}
+
+auto TypeContext::get_array(Type* sub_type, std::optional<size_t> length) -> ArrayType* {
+    auto const key = std::pair{sub_type, length};
+    return length ? unique(arrays_, key, sub_type, *length) : unique(arrays_, key, sub_type);
+}
+
+auto TypeContext::get_enum(EnumDecl* ref) -> EnumType* {
+    return unique(enums_, ref, ref);
+}
+
+auto TypeContext::get_class(ClassDecl* ref) -> ClassType* {
+    return unique(classes_, ref, ref);
+}
+
+auto TypeContext::get_import(std::string const& import_path, Type* sub_type) -> ImportType* {
+    return unique(imports_, std::pair{import_path, sub_type}, import_path, sub_type);
+}
+
+auto TypeContext::get_murky(std::string const& name) -> MurkyType* {
+    return unique(murky_types_, name, name);
+}
 
-    if (is_float(a) and is_float(b))
-        return true;
+auto TypeContext::num_types() const -> size_t {
+    auto const lock = std::shared_lock{mutex_};
+    return types_.size() + pointers_.size() + arrays_.size() + enums_.size() + classes_.size() + imports_.size()
+           + murky_types_.size();
+}
+
+auto Type::get(TypeSpec t) -> Type* {
+    return TypeContext::get().get_type(t);
+}
+
+auto PointerType::get(Type* sub_type) -> PointerType* {
+    return TypeContext::get().get_pointer(sub_type);
+}
+
+auto ArrayType::get(Type* sub_type) -> ArrayType* {
+    return TypeContext::get().get_array(sub_type, std::nullopt);
+}
+
+auto ArrayType::get(Type* sub_type, size_t length) -> ArrayType* {
+    return TypeContext::get().get_array(sub_type, length);
+}
+
+auto EnumType::get(EnumDecl* ref) -> EnumType* {
+    return TypeContext::get().get_enum(ref);
+}
+
+auto ClassType::get(ClassDecl* ref) -> ClassType* {
+    return TypeContext::get().get_class(ref);
+}
+
+auto ImportType::get(std::string const& import_path, Type* sub_type) -> ImportType* {
+    return TypeContext::get().get_import(import_path, sub_type);
+}
 
-    return a == b;
+auto MurkyType::get(std::string const& name) -> MurkyType* {
+    return TypeContext::get().get_murky(name);
 }
 
-auto type_spec_from_lexeme(std::string const& lexeme) -> TypeSpec {
-    auto const lexeme_to_spec_map = std::map<std::string, TypeSpec>{{"void", TypeSpec::VOID},
+auto type_spec_from_lexeme(std::string_view lexeme) -> TypeSpec {
+    auto const lexeme_to_spec_map = std::map<std::string_view, TypeSpec>{{"void", TypeSpec::VOID},
                                                                     {"i64", TypeSpec::I64},
                                                                     {"i32", TypeSpec::I32},
                                                                     {"i8", TypeSpec::I8},
@@ -79,18 +177,11 @@ auto operator<<(std::ostream& os, TypeSpec const& ts) -> std::ostream& {
     return os;
 }
 
-EnumType::EnumType()
-: Type(TypeSpec::ENUM) {}
-
-EnumType::EnumType(std::shared_ptr<EnumDecl> ref)
+EnumType::EnumType(EnumDecl* ref)
 : Type(TypeSpec::ENUM)
 , ref_(ref) {}
 
-auto EnumType::set_ref(std::shared_ptr<EnumDecl> ref) -> void {
-    ref_ = ref;
-}
-
-auto EnumType::get_ref() const -> std::shared_ptr<EnumDecl> {
+auto EnumType::get_ref() const -> EnumDecl* {
     return ref_;
 }
 
@@ -102,11 +193,11 @@ auto EnumType::equals(const Type& other) const -> bool {
     if (t_ != other.get_type_spec())
         return false;
 
-    auto* other_ptr = dynamic_cast<const EnumType*>(&other);
+    auto* other_ptr = dyn_cast<EnumType>(&other);
     if (!other_ptr)
         return false;
 
-    return ref_->get_ident() == other_ptr->get_ref()->get_ident()
+    return ref_->get_symbol() == other_ptr->get_ref()->get_symbol()
            and ref_->get_fields() == other_ptr->get_ref()->get_fields();
 }
 
@@ -122,7 +213,7 @@ auto ClassType::equals(const Type& other) const -> bool {
     if (t_ != other.get_type_spec())
         return false;
 
-    auto* other_ptr = dynamic_cast<const ClassType*>(&other);
+    auto* other_ptr = dyn_cast<ClassType>(&other);
     if (!other_ptr)
         return false;
 
@@ -133,14 +224,10 @@ auto ClassType::equal_soft(const Type& other) const -> bool {
     return equals(other);
 }
 
-auto ClassType::get_ref() const -> std::shared_ptr<ClassDecl> {
+auto ClassType::get_ref() const -> ClassDecl* {
     return ref_;
 }
 
-auto ClassType::set_ref(std::shared_ptr<ClassDecl> ref) -> void {
-    ref_ = ref;
-}
-
 auto MurkyType::print(std::ostream& os) const -> void {
     os << name_;
 }
@@ -1,8 +1,14 @@
 #ifndef TYPE_HPP
 #define TYPE_HPP
 
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <optional>
+#include <shared_mutex>
 #include <sstream>
+#include <string>
+#include <utility>
 
 #include "./ast.hpp"
 
@@ -32,16 +38,25 @@ auto operator<<(std::ostream& os, TypeSpec const& ts) -> std::ostream&;
 
 auto soft_typespec_equals(TypeSpec const& a, TypeSpec const& b) -> bool;
 
+// The type spec doubles as the kind isa, cast and dyn_cast go by, each of the subclasses below being the only type
+// with its spec.
+//
+// Types are unique: each is made once for the whole session by the TypeContext and handed out through the get
+// functions, never constructed directly, so the same type is always the same node.
 class Type {
  public:
     Type(TypeSpec t)
-    : t_(t) {}
+    : t_(t)
+    , predicates_(predicates_of(t)) {}
 
     Type()
-    : t_(TypeSpec::UNKNOWN) {}
+    : Type(TypeSpec::UNKNOWN) {}
 
     virtual ~Type() = default;
 
+    // A type without anything more to it than its spec, unknown being what's yet to be inferred
+    static auto get(TypeSpec t = TypeSpec::UNKNOWN) -> Type*;
+
     virtual auto equals(const Type& other) const -> bool {
         return t_ == other.t_;
     }
@@ -50,12 +65,14 @@ class Type {
         return soft_typespec_equals(t_, other.get_type_spec());
     }
 
+    // Being unique, a type is only ever compared further when it's a different node, e.g. for void* matching any
+    // pointer
     auto operator==(const Type& other) -> bool {
-        return equals(other);
+        return this == &other or equals(other);
     }
 
     auto operator!=(const Type& other) -> bool {
-        return !equals(other);
+        return !(*this == other);
     }
 
     auto to_string() const -> std::string {
@@ -73,18 +90,7 @@ class Type {
     }
 
     auto is_primitive() const noexcept -> bool {
-        auto primitive_types = std::vector<TypeSpec>{TypeSpec::I64,
-                                                     TypeSpec::I32,
-                                                     TypeSpec::I8,
-                                                     TypeSpec::U64,
-                                                     TypeSpec::U32,
-                                                     TypeSpec::U8,
-                                                     TypeSpec::F32,
-                                                     TypeSpec::F64,
-                                                     TypeSpec::BOOL,
-                                                     TypeSpec::POINTER,
-                                                     TypeSpec::ARRAY};
-        return std::find(primitive_types.begin(), primitive_types.end(), t_) != primitive_types.end();
+        return predicates_ & primitive_bit;
     }
 
     auto is_variatic() const noexcept -> bool {
@@ -104,15 +110,15 @@ class Type {
     }
 
     auto is_numeric() const noexcept -> bool {
-        return is_signed_int() or is_unsigned_int() or is_decimal();
+        return predicates_ & (signed_int_bit | unsigned_int_bit | decimal_bit);
     }
 
     auto is_int() const noexcept -> bool {
-        return is_signed_int() or is_unsigned_int();
+        return predicates_ & (signed_int_bit | unsigned_int_bit);
     }
 
     auto is_signed_int() const noexcept -> bool {
-        return t_ == TypeSpec::I64 or t_ == TypeSpec::I32 or t_ == TypeSpec::I8;
+        return predicates_ & signed_int_bit;
     }
 
     auto is_i64() const noexcept -> bool {
@@ -120,11 +126,11 @@ class Type {
     }
 
     auto is_unsigned_int() const noexcept -> bool {
-        return t_ == TypeSpec::U64 or t_ == TypeSpec::U32 or t_ == TypeSpec::U8;
+        return predicates_ & unsigned_int_bit;
     }
 
     auto is_decimal() const noexcept -> bool {
-        return t_ == TypeSpec::F32 or t_ == TypeSpec::F64;
+        return predicates_ & decimal_bit;
     }
 
     auto is_pointer() const noexcept -> bool {
@@ -157,20 +163,38 @@ class Type {
 
  protected:
     TypeSpec t_;
+
+ private:
+    // The predicates the verifier asks most, worked out once from the spec
+    static constexpr uint8_t primitive_bit = 1 << 0;
+    static constexpr uint8_t signed_int_bit = 1 << 1;
+    static constexpr uint8_t unsigned_int_bit = 1 << 2;
+    static constexpr uint8_t decimal_bit = 1 << 3;
+    static auto predicates_of(TypeSpec t) -> uint8_t;
+
+    uint8_t predicates_;
 };
 
 class ArrayType : public Type {
  public:
-    ArrayType(std::shared_ptr<Type> sub_type)
+    static auto classof(Type const* t) -> bool {
+        return t->get_type_spec() == TypeSpec::ARRAY;
+    }
+
+    ArrayType(Type* sub_type)
     : Type(TypeSpec::ARRAY)
     , sub_type_(sub_type) {}
 
-    ArrayType(std::shared_ptr<Type> sub_type, size_t length)
+    ArrayType(Type* sub_type, size_t length)
     : Type(TypeSpec::ARRAY)
     , sub_type_(sub_type)
     , length_(std::optional(length)) {}
 
-    auto get_sub_type() const -> std::shared_ptr<Type> {
+    // An array of unspecified length, e.g. a parameter's, matches arrays of any length
+    static auto get(Type* sub_type) -> ArrayType*;
+    static auto get(Type* sub_type, size_t length) -> ArrayType*;
+
+    auto get_sub_type() const -> Type* {
         return sub_type_;
     }
 
@@ -187,7 +211,7 @@ class ArrayType : public Type {
         if (t_ != other.get_type_spec())
             return false;
 
-        auto* other_ptr = dynamic_cast<const ArrayType*>(&other);
+        auto* other_ptr = dyn_cast<ArrayType>(&other);
         if (!other_ptr)
             return false;
 
@@ -200,7 +224,7 @@ class ArrayType : public Type {
     }
 
     auto equal_soft(const Type& other) const -> bool override {
-        auto* other_ptr = dynamic_cast<const ArrayType*>(&other);
+        auto* other_ptr = dyn_cast<ArrayType>(&other);
         if (!other_ptr) {
             return false;
         }
@@ -208,17 +232,23 @@ class ArrayType : public Type {
     }
 
  private:
-    std::shared_ptr<Type> sub_type_;
+    Type* sub_type_;
     std::optional<size_t> length_ = std::nullopt;
 };
 
 class PointerType : public Type {
  public:
-    PointerType(std::shared_ptr<Type> sub_type)
+    static auto classof(Type const* t) -> bool {
+        return t->get_type_spec() == TypeSpec::POINTER;
+    }
+
+    PointerType(Type* sub_type)
     : Type(TypeSpec::POINTER)
     , sub_type_(sub_type) {}
 
-    auto get_sub_type() const -> std::shared_ptr<Type> {
+    static auto get(Type* sub_type) -> PointerType*;
+
+    auto get_sub_type() const -> Type* {
         return sub_type_;
     }
 
@@ -231,7 +261,7 @@ class PointerType : public Type {
         if (t_ != other.get_type_spec())
             return false;
 
-        auto* other_ptr = dynamic_cast<const PointerType*>(&other);
+        auto* other_ptr = dyn_cast<PointerType>(&other);
         if (!other_ptr)
             return false;
 
@@ -242,7 +272,7 @@ class PointerType : public Type {
     }
 
     auto equal_soft(const Type& other) const -> bool override {
-        auto* array_ptr = dynamic_cast<const ArrayType*>(&other);
+        auto* array_ptr = dyn_cast<ArrayType>(&other);
         if (array_ptr) {
             return *sub_type_ == *array_ptr->get_sub_type();
         }
@@ -250,7 +280,7 @@ class PointerType : public Type {
         if (t_ != other.get_type_spec())
             return false;
 
-        auto* other_ptr = dynamic_cast<const PointerType*>(&other);
+        auto* other_ptr = dyn_cast<PointerType>(&other);
         if (!other_ptr)
             return false;
 
@@ -261,51 +291,65 @@ class PointerType : public Type {
     }
 
  private:
-    std::shared_ptr<Type> sub_type_;
+    Type* sub_type_;
 };
 
 class EnumType : public Type {
  public:
-    EnumType();
-    EnumType(std::shared_ptr<EnumDecl> ref);
+    static auto classof(Type const* t) -> bool {
+        return t->get_type_spec() == TypeSpec::ENUM;
+    }
+
+    EnumType(EnumDecl* ref);
 
-    auto set_ref(std::shared_ptr<EnumDecl> ref) -> void;
-    auto get_ref() const -> std::shared_ptr<EnumDecl>;
+    static auto get(EnumDecl* ref) -> EnumType*;
+
+    auto get_ref() const -> EnumDecl*;
 
     auto print(std::ostream& os) const -> void override;
     auto equals(const Type& other) const -> bool override;
     auto equal_soft(const Type& other) const -> bool override;
 
  private:
-    std::shared_ptr<EnumDecl> ref_ = nullptr;
+    EnumDecl* ref_ = nullptr;
 };
 
 class ClassType : public Type {
  public:
-    ClassType();
-    ClassType(std::shared_ptr<ClassDecl> ref)
+    static auto classof(Type const* t) -> bool {
+        return t->get_type_spec() == TypeSpec::CLASS;
+    }
+
+    ClassType(ClassDecl* ref)
     : Type(TypeSpec::CLASS)
     , ref_(ref) {}
 
-    auto get_ref() const -> std::shared_ptr<ClassDecl>;
-    auto set_ref(std::shared_ptr<ClassDecl> ref) -> void;
+    static auto get(ClassDecl* ref) -> ClassType*;
+
+    auto get_ref() const -> ClassDecl*;
 
     auto print(std::ostream& os) const -> void override;
     auto equals(const Type& other) const -> bool override;
     auto equal_soft(const Type& other) const -> bool override;
 
  private:
-    std::shared_ptr<ClassDecl> ref_ = nullptr;
+    ClassDecl* ref_ = nullptr;
 };
 
 class ImportType : public Type {
  public:
-    ImportType(std::string import_path, std::shared_ptr<Type> sub_type)
+    static auto classof(Type const* t) -> bool {
+        return t->get_type_spec() == TypeSpec::IMPORT;
+    }
+
+    ImportType(std::string import_path, Type* sub_type)
     : Type(TypeSpec::IMPORT)
     , import_path_(import_path)
     , sub_type_(sub_type) {}
 
-    auto get_sub_type() const -> std::shared_ptr<Type> {
+    static auto get(std::string const& import_path, Type* sub_type) -> ImportType*;
+
+    auto get_sub_type() const -> Type* {
         return sub_type_;
     }
 
@@ -315,7 +359,7 @@ class ImportType : public Type {
     }
 
     auto equals(const Type& other) const -> bool override {
-        auto* import_ptr = dynamic_cast<const ImportType*>(&other);
+        auto* import_ptr = dyn_cast<ImportType>(&other);
         if (import_ptr) {
             return *sub_type_ == *import_ptr->get_sub_type();
         }
@@ -325,7 +369,7 @@ class ImportType : public Type {
     }
 
     auto equal_soft(const Type& other) const -> bool override {
-        auto* import_ptr = dynamic_cast<const ImportType*>(&other);
+        auto* import_ptr = dyn_cast<ImportType>(&other);
         if (import_ptr) {
             return sub_type_->equal_soft(*import_ptr->get_sub_type());
         }
@@ -340,15 +384,21 @@ class ImportType : public Type {
 
  private:
     std::string import_path_;
-    std::shared_ptr<Type> sub_type_ = nullptr;
+    Type* sub_type_ = nullptr;
 };
 
 class MurkyType : public Type {
  public:
+    static auto classof(Type const* t) -> bool {
+        return t->get_type_spec() == TypeSpec::MURKY;
+    }
+
     MurkyType(std::string const name)
     : Type(TypeSpec::MURKY)
     , name_(name) {}
 
+    static auto get(std::string const& name) -> MurkyType*;
+
     auto get_name() const -> std::string {
         return name_;
     }
@@ -361,8 +411,43 @@ class MurkyType : public Type {
     std::string const name_;
 };
 
+// Makes each type the first time it's asked for and hands out the same node from then on. Modules are parsed and
+// verified on several threads, so most lookups only need to share the tables
+class TypeContext {
+ public:
+    static auto get() -> TypeContext&;
+
+    auto get_type(TypeSpec t) -> Type*;
+    auto get_pointer(Type* sub_type) -> PointerType*;
+    auto get_array(Type* sub_type, std::optional<size_t> length) -> ArrayType*;
+    auto get_enum(EnumDecl* ref) -> EnumType*;
+    auto get_class(ClassDecl* ref) -> ClassType*;
+    auto get_import(std::string const& import_path, Type* sub_type) -> ImportType*;
+    auto get_murky(std::string const& name) -> MurkyType*;
+
+    // Number of distinct types made so far, reported by -s/--stat
+    auto num_types() const -> size_t;
+
+ private:
+    TypeContext() = default;
+
+    template <typename T, typename Key, typename... Args>
+    auto unique(std::map<Key, T*>& types, Key const& key, Args&&... args) -> T*;
+
+    mutable std::shared_mutex mutex_ = {};
+    // Never tied to a module, as any module can end up holding any type
+    Arena arena_ = {};
+    std::map<TypeSpec, Type*> types_ = {};
+    std::map<Type*, PointerType*> pointers_ = {};
+    std::map<std::pair<Type*, std::optional<size_t>>, ArrayType*> arrays_ = {};
+    std::map<EnumDecl*, EnumType*> enums_ = {};
+    std::map<ClassDecl*, ClassType*> classes_ = {};
+    std::map<std::pair<std::string, Type*>, ImportType*> imports_ = {};
+    std::map<std::string, MurkyType*> murky_types_ = {};
+};
+
 auto operator<<(std::ostream& os, Type const& t) -> std::ostream&;
 
-auto type_spec_from_lexeme(std::string const& lexeme) -> TypeSpec;
+auto type_spec_from_lexeme(std::string_view lexeme) -> TypeSpec;
 
 #endif // TYPE_HPP
\ No newline at end of file
@@ -1,6 +1,4 @@
 #include "verifier.hpp"
-#include "lexer.hpp"
-#include "parser.hpp"
 
 #include <algorithm>
 #include <iostream>
@@ -8,48 +6,67 @@
 #include <sstream>
 #include <string>
 
-auto SymbolTable::retrieve_one_level(std::string const& id) -> std::optional<TableEntry> {
-    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
-        if (it->level != level_) {
-            return std::nullopt;
-        }
-        auto dot_pos = it->id.find('.');
-        auto prefix = it->id.substr(0, dot_pos);
-        if (prefix == id) {
-            return *it;
+auto SymbolTable::close_scope() -> void {
+    while (!slots_.empty() and slots_.back().entry.level == level_) {
+        if (!slots_.back().removed) {
+            bindings_[slots_.back().entry.id].pop_back();
         }
+        slots_.pop_back();
     }
-    return std::nullopt;
+    --level_;
 }
 
-auto SymbolTable::retrieve(std::string const& id) -> std::optional<TableEntry> {
-    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
-        auto dot_pos = it->id.find('.');
-        auto prefix = it->id.substr(0, dot_pos);
-        if (prefix == id) {
-            return *it;
+auto SymbolTable::insert(Symbol id, Decl* attr) -> void {
+    bindings_[id].push_back(slots_.size());
+    slots_.push_back(Slot{TableEntry{id, level_, attr}, false});
+}
+
+auto SymbolTable::remove(TableEntry const& entry) -> void {
+    auto& binding = bindings_[entry.id];
+    for (auto it = binding.begin(); it != binding.end();) {
+        auto& slot = slots_[*it];
+        if (slot.entry.attr == entry.attr and slot.entry.level == entry.level) {
+            slot.removed = true;
+            it = binding.erase(it);
+        }
+        else {
+            ++it;
         }
     }
+}
+
+auto SymbolTable::retrieve_one_level(Symbol id) -> std::optional<TableEntry> {
+    // Entries are stacked by level, so the innermost binding of the name is the only candidate
+    auto const entry = retrieve(id);
+    if (entry and entry->level == level_) {
+        return entry;
+    }
     return std::nullopt;
 }
 
+auto SymbolTable::retrieve(Symbol id) -> std::optional<TableEntry> {
+    auto const it = bindings_.find(id);
+    if (it == bindings_.end() or it->second.empty()) {
+        return std::nullopt;
+    }
+    return slots_[it->second.back()].entry;
+}
+
 auto SymbolTable::retrieve_latest_scope() -> std::vector<TableEntry> {
     auto res = std::vector<TableEntry>{};
-    for (auto i = entries_.rbegin(); i != entries_.rend(); ++i) {
-        if (i->level == level_) {
-            res.push_back(*i);
-        }
-        else {
-            break;
+    for (auto i = slots_.rbegin(); i != slots_.rend() and i->entry.level == level_; ++i) {
+        if (!i->removed) {
+            res.push_back(i->entry);
         }
     }
     return res;
 }
 
-auto Verifier::visit_para_decl(std::shared_ptr<ParaDecl> para_decl) -> void {
+auto Verifier::visit_para_decl(ParaDecl* para_decl) -> void {
     para_decl->set_statement_num(global_statement_counter_);
     para_decl->set_depth_num(loop_depth_);
-    declare_variable(para_decl->get_ident() + para_decl->get_append(), para_decl);
+    assign_slot(para_decl);
+    declare_variable(para_decl);
 
     if (para_decl->get_type()->is_void()) {
         handler_->report_error(current_filename_, all_errors_[4], para_decl->get_ident(), para_decl->pos());
@@ -61,18 +78,19 @@ auto Verifier::visit_para_decl(std::shared_ptr<ParaDecl> para_decl) -> void {
     return;
 }
 
-auto Verifier::visit_local_var_decl(std::shared_ptr<LocalVarDecl> local_var_decl) -> void {
+auto Verifier::visit_local_var_decl(LocalVarDecl* local_var_decl) -> void {
     unmurk_decl(local_var_decl);
 
     local_var_decl->set_statement_num(global_statement_counter_);
     local_var_decl->set_depth_num(loop_depth_);
-    declare_variable(local_var_decl->get_ident() + local_var_decl->get_append(), local_var_decl);
+    assign_slot(local_var_decl);
+    declare_variable(local_var_decl);
 
     if (local_var_decl->get_type()->is_void()) {
         handler_->report_error(current_filename_, all_errors_[4], local_var_decl->get_ident(), local_var_decl->pos());
     }
     else if (local_var_decl->get_type()->is_array()) {
-        auto a_t = std::dynamic_pointer_cast<ArrayType>(local_var_decl->get_type());
+        auto a_t = cast<ArrayType>(local_var_decl->get_type());
         if (a_t->get_sub_type()->is_void()) {
             handler_->report_error(current_filename_, all_errors_[47], local_var_decl->get_ident(), local_var_decl->pos());
         }
@@ -90,7 +108,7 @@ auto Verifier::visit_local_var_decl(std::shared_ptr<LocalVarDecl> local_var_decl
     current_numerical_type = std::nullopt;
 
     auto const& expr_type = local_var_decl->get_expr()->get_type();
-    auto const has_expr = !(std::dynamic_pointer_cast<EmptyExpr>(local_var_decl->get_expr()));
+    auto const has_expr = !isa<EmptyExpr>(local_var_decl->get_expr());
 
     if (local_var_decl->get_type()->is_unknown()) {
         if (expr_type->is_void()) {
@@ -105,8 +123,8 @@ auto Verifier::visit_local_var_decl(std::shared_ptr<LocalVarDecl> local_var_decl
         // Implicit casting from array to pointer in assignment expressions
         auto r = local_var_decl->get_expr();
         if (local_var_decl->get_type()->is_pointer() and r->get_type()->is_array()) {
-            auto p_l = std::dynamic_pointer_cast<PointerType>(local_var_decl->get_type());
-            auto a_r = std::dynamic_pointer_cast<ArrayType>(r->get_type());
+            auto p_l = cast<PointerType>(local_var_decl->get_type());
+            auto a_r = cast<ArrayType>(r->get_type());
             if (*p_l->get_sub_type() != *a_r->get_sub_type()) {
                 auto stream = std::stringstream{};
                 stream << "expected " << *p_l->get_sub_type() << " as an inner type, got " << *a_r->get_sub_type();
@@ -132,12 +150,12 @@ auto Verifier::visit_local_var_decl(std::shared_ptr<LocalVarDecl> local_var_decl
         local_var_decl->set_type(handler_->ERROR_TYPE);
     }
 
-    std::shared_ptr<ArrayType> l;
-    if (has_expr and (l = std::dynamic_pointer_cast<ArrayType>(expr_type))) {
+    ArrayType* l;
+    if (has_expr and (l = dyn_cast<ArrayType>(expr_type))) {
         local_var_decl->set_type(l);
     }
     if (local_var_decl->get_type()->is_array() and !expr_type->is_error()) {
-        auto a_t = std::dynamic_pointer_cast<ArrayType>(local_var_decl->get_type());
+        auto a_t = cast<ArrayType>(local_var_decl->get_type());
         if (!a_t->get_length().has_value()) {
             handler_->report_error(current_filename_, all_errors_[46], local_var_decl->get_ident(), local_var_decl->pos());
             local_var_decl->set_type(handler_->ERROR_TYPE);
@@ -147,14 +165,14 @@ auto Verifier::visit_local_var_decl(std::shared_ptr<LocalVarDecl> local_var_decl
     return;
 }
 
-auto Verifier::visit_global_var_decl(std::shared_ptr<GlobalVarDecl> global_var_decl) -> void {
+auto Verifier::visit_global_var_decl(GlobalVarDecl* global_var_decl) -> void {
     auto const name = global_var_decl->get_ident();
 
     if (global_var_decl->get_type()->is_void()) {
         handler_->report_error(current_filename_, all_errors_[4], name, global_var_decl->pos());
     }
     else if (global_var_decl->get_type()->is_array()) {
-        auto const a_t = std::dynamic_pointer_cast<ArrayType>(global_var_decl->get_type());
+        auto const a_t = cast<ArrayType>(global_var_decl->get_type());
         if (a_t->get_sub_type()->is_void()) {
             handler_->report_error(current_filename_, all_errors_[47], name, global_var_decl->pos());
         }
@@ -171,7 +189,7 @@ auto Verifier::visit_global_var_decl(std::shared_ptr<GlobalVarDecl> global_var_d
     current_numerical_type = std::nullopt;
 
     auto const& expr_type = global_var_decl->get_expr()->get_type();
-    auto const has_expr = !(std::dynamic_pointer_cast<EmptyExpr>(global_var_decl->get_expr()));
+    auto const has_expr = !isa<EmptyExpr>(global_var_decl->get_expr());
     if (global_var_decl->get_type()->is_unknown()) {
         if (expr_type->is_void()) {
             handler_->report_error(current_filename_, all_errors_[29], name, global_var_decl->pos());
@@ -194,12 +212,12 @@ auto Verifier::visit_global_var_decl(std::shared_ptr<GlobalVarDecl> global_var_d
         global_var_decl->set_type(handler_->ERROR_TYPE);
     }
 
-    std::shared_ptr<ArrayType> l;
-    if (has_expr and (l = std::dynamic_pointer_cast<ArrayType>(expr_type))) {
+    ArrayType* l;
+    if (has_expr and (l = dyn_cast<ArrayType>(expr_type))) {
         global_var_decl->set_type(l);
     }
     if (global_var_decl->get_type()->is_array() and !expr_type->is_error()) {
-        auto a_t = std::dynamic_pointer_cast<ArrayType>(global_var_decl->get_type());
+        auto a_t = cast<ArrayType>(global_var_decl->get_type());
         if (!a_t->get_length().has_value()) {
             handler_->report_error(current_filename_,
                                    all_errors_[46],
@@ -212,7 +230,7 @@ auto Verifier::visit_global_var_decl(std::shared_ptr<GlobalVarDecl> global_var_d
     return;
 }
 
-auto Verifier::visit_enum_decl(std::shared_ptr<EnumDecl> enum_decl) -> void {
+auto Verifier::visit_enum_decl(EnumDecl* enum_decl) -> void {
     if (enum_decl->get_fields().size() == 0) {
         handler_->report_error(current_filename_, all_errors_[37], enum_decl->get_ident(), enum_decl->pos());
     }
@@ -234,21 +252,21 @@ auto Verifier::visit_enum_decl(std::shared_ptr<EnumDecl> enum_decl) -> void {
     }
 }
 
-auto Verifier::visit_class_field_decl(std::shared_ptr<ClassFieldDecl> class_field_decl) -> void {
+auto Verifier::visit_class_field_decl(ClassFieldDecl* class_field_decl) -> void {
     auto const n = class_field_decl->get_ident();
     auto const t = class_field_decl->get_type();
     if (t->is_void()) {
         handler_->report_error(current_filename_, all_errors_[50], n, class_field_decl->pos());
     }
     else if (t->is_array()) {
-        auto a_t = std::dynamic_pointer_cast<ArrayType>(t);
+        auto a_t = cast<ArrayType>(t);
         if (a_t->get_sub_type()->is_void()) {
             handler_->report_error(current_filename_, all_errors_[51], n, class_field_decl->pos());
         }
     }
 }
 
-auto Verifier::visit_class_decl(std::shared_ptr<ClassDecl> class_decl) -> void {
+auto Verifier::visit_class_decl(ClassDecl* class_decl) -> void {
     curr_class = class_decl;
     auto const class_name = class_decl->get_ident();
 
@@ -294,7 +312,7 @@ auto Verifier::visit_class_decl(std::shared_ptr<ClassDecl> class_decl) -> void {
     return;
 }
 
-auto Verifier::visit_extern(std::shared_ptr<Extern> extern_) -> void {
+auto Verifier::visit_extern(Extern* extern_) -> void {
     auto i = 0u;
     auto const size = extern_->get_types().size();
     for (auto const& type : extern_->get_types()) {
@@ -309,17 +327,17 @@ auto Verifier::visit_extern(std::shared_ptr<Extern> extern_) -> void {
     }
 }
 
-auto Verifier::visit_constructor_decl(std::shared_ptr<ConstructorDecl> constructor_decl) -> void {
+auto Verifier::visit_constructor_decl(ConstructorDecl* constructor_decl) -> void {
     global_statement_counter_ = 0;
     in_constructor_ = true;
     has_return_ = false;
 
     current_function_or_method_ = constructor_decl;
     symbol_table_.open_scope();
-    // Add in the this keyword
-    auto this_decl = std::make_shared<ParaDecl>(constructor_decl->pos(),
-                                                "this",
-                                                std::make_shared<PointerType>(curr_class->get_type()));
+    // Add in the this keyword, visited first so it takes the slot the emitter keeps "this" in
+    auto this_decl = make_node<ParaDecl>(constructor_decl->pos(),
+                                         "this",
+                                         PointerType::get(curr_class->get_type()));
     this_decl->set_mut();
     this_decl->visit(shared_from_this());
     for (auto const& para : constructor_decl->get_paras()) {
@@ -329,7 +347,7 @@ auto Verifier::visit_constructor_decl(std::shared_ptr<ConstructorDecl> construct
 
     auto args = constructor_decl->get_paras();
     if (args.size() == 1) {
-        if (auto l = std::dynamic_pointer_cast<PointerType>(args[0]->get_type())) {
+        if (auto l = dyn_cast<PointerType>(args[0]->get_type())) {
             if (*l->get_sub_type() == *curr_class->get_type()) {
                 curr_class->set_has_copy_constructor(true);
             }
@@ -358,13 +376,13 @@ auto Verifier::visit_constructor_decl(std::shared_ptr<ConstructorDecl> construct
     return;
 }
 
-auto Verifier::visit_destructor_decl(std::shared_ptr<DestructorDecl> destructor_decl) -> void {
+auto Verifier::visit_destructor_decl(DestructorDecl* destructor_decl) -> void {
     in_destructor_ = true;
     current_function_or_method_ = destructor_decl;
 
     symbol_table_.open_scope();
     auto this_decl =
-        std::make_shared<ParaDecl>(destructor_decl->pos(), "this", std::make_shared<PointerType>(curr_class->get_type()));
+        make_node<ParaDecl>(destructor_decl->pos(), "this", PointerType::get(curr_class->get_type()));
     this_decl->set_mut();
     this_decl->visit(shared_from_this());
     destructor_decl->get_compound_stmt()->visit(shared_from_this());
@@ -389,7 +407,7 @@ auto Verifier::visit_destructor_decl(std::shared_ptr<DestructorDecl> destructor_
     in_destructor_ = false;
 }
 
-auto Verifier::visit_method_decl(std::shared_ptr<MethodDecl> method_decl) -> void {
+auto Verifier::visit_method_decl(MethodDecl* method_decl) -> void {
     global_statement_counter_ = 0;
     has_return_ = false;
     auto const m_type = method_decl->get_type();
@@ -397,7 +415,7 @@ auto Verifier::visit_method_decl(std::shared_ptr<MethodDecl> method_decl) -> voi
     auto const m_pos = method_decl->pos();
 
     if (m_type->is_array()) {
-        auto a_t = std::dynamic_pointer_cast<ArrayType>(m_type);
+        auto a_t = cast<ArrayType>(m_type);
         if (a_t->get_sub_type()->is_void()) {
             handler_->report_error(current_filename_, all_errors_[47], "return type from method " + m_name, m_pos);
         }
@@ -408,9 +426,9 @@ auto Verifier::visit_method_decl(std::shared_ptr<MethodDecl> method_decl) -> voi
 
     current_function_or_method_ = method_decl;
     symbol_table_.open_scope();
-    // Add in the this keyword
+    // Add in the this keyword, visited first so it takes the slot the emitter keeps "this" in
     auto this_decl =
-        std::make_shared<ParaDecl>(method_decl->pos(), "this", std::make_shared<PointerType>(curr_class->get_type()));
+        make_node<ParaDecl>(method_decl->pos(), "this", PointerType::get(curr_class->get_type()));
     this_decl->set_mut();
     this_decl->visit(shared_from_this());
     for (auto const& para : method_decl->get_paras()) {
@@ -422,10 +440,10 @@ auto Verifier::visit_method_decl(std::shared_ptr<MethodDecl> method_decl) -> voi
     for (auto it = latest_scope.rbegin(); it != latest_scope.rend(); ++it) {
         auto member = *it;
         if (member.attr->get_type()->is_class()) {
-            auto expr = std::make_shared<VarExpr>(method_decl->get_compound_stmt()->pos(),
-                                                  member.attr->get_ident(),
-                                                  member.attr->get_type());
-            auto delete_stmt = std::make_shared<DeleteStmt>(method_decl->get_compound_stmt()->pos(), expr);
+            auto expr = make_node<VarExpr>(method_decl->get_compound_stmt()->pos(),
+                                           member.attr->get_ident(),
+                                           member.attr->get_type());
+            auto delete_stmt = make_node<DeleteStmt>(method_decl->get_compound_stmt()->pos(), expr);
             delete_stmt->visit(shared_from_this());
             method_decl->get_compound_stmt()->add_stmt(delete_stmt);
         }
@@ -456,13 +474,13 @@ auto Verifier::visit_method_decl(std::shared_ptr<MethodDecl> method_decl) -> voi
     return;
 }
 
-auto Verifier::visit_function(std::shared_ptr<Function> function) -> void {
+auto Verifier::visit_function(Function* function) -> void {
     global_statement_counter_ = 0;
     has_return_ = false;
     auto func_t = function->get_type();
 
     if (func_t->is_array()) {
-        auto a_t = std::dynamic_pointer_cast<ArrayType>(func_t);
+        auto a_t = cast<ArrayType>(func_t);
         if (a_t->get_sub_type()->is_void()) {
             handler_->report_error(current_filename_,
                                    all_errors_[47],
@@ -484,7 +502,7 @@ auto Verifier::visit_function(std::shared_ptr<Function> function) -> void {
         }
         else if (function->get_paras().size() == 0 or function->get_paras().size() == 2) {
             auto paras = function->get_paras();
-            auto const char_p_t = std::make_shared<PointerType>(std::make_shared<Type>(TypeSpec::I8));
+            auto const char_p_t = PointerType::get(Type::get(TypeSpec::I8));
             if (paras.size() == 2) {
                 if (paras[0]->get_type()->get_type_spec() != TypeSpec::I32 or *paras[1]->get_type() != *char_p_t) {
                     handler_->report_error(current_filename_,
@@ -513,10 +531,10 @@ auto Verifier::visit_function(std::shared_ptr<Function> function) -> void {
     for (auto it = latest_scope.rbegin(); it != latest_scope.rend(); ++it) {
         auto member = *it;
         if (member.attr->get_type()->is_class()) {
-            auto expr = std::make_shared<VarExpr>(function->get_compound_stmt()->pos(),
-                                                  member.attr->get_ident(),
-                                                  member.attr->get_type());
-            auto delete_stmt = std::make_shared<DeleteStmt>(function->get_compound_stmt()->pos(), expr);
+            auto expr = make_node<VarExpr>(function->get_compound_stmt()->pos(),
+                                           member.attr->get_ident(),
+                                           member.attr->get_type());
+            auto delete_stmt = make_node<DeleteStmt>(function->get_compound_stmt()->pos(), expr);
             delete_stmt->visit(shared_from_this());
             function->get_compound_stmt()->add_stmt(delete_stmt);
         }
@@ -547,12 +565,12 @@ auto Verifier::visit_function(std::shared_ptr<Function> function) -> void {
     in_main_ = false;
 }
 
-auto Verifier::visit_empty_expr(std::shared_ptr<EmptyExpr> empty_expr) -> void {
+auto Verifier::visit_empty_expr(EmptyExpr* empty_expr) -> void {
     (void)empty_expr;
     return;
 }
 
-auto Verifier::visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_expr) -> void {
+auto Verifier::visit_assignment_expr(AssignmentExpr* assignment_expr) -> void {
     auto const op = assignment_expr->get_operator();
     auto l = assignment_expr->get_left();
     auto r = assignment_expr->get_right();
@@ -566,10 +584,10 @@ auto Verifier::visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_
     }
     visiting_lhs_of_assignment_ = false;
 
-    auto res = std::dynamic_pointer_cast<VarExpr>(l);
-    auto deref_res = std::dynamic_pointer_cast<UnaryExpr>(l);
-    auto array_index_res = std::dynamic_pointer_cast<ArrayIndexExpr>(l);
-    auto class_field_res = std::dynamic_pointer_cast<FieldAccessExpr>(l);
+    auto res = dyn_cast<VarExpr>(l);
+    auto deref_res = dyn_cast<UnaryExpr>(l);
+    auto array_index_res = dyn_cast<ArrayIndexExpr>(l);
+    auto class_field_res = dyn_cast<FieldAccessExpr>(l);
     if ((!res and !deref_res and !array_index_res and !class_field_res)
         or (deref_res and deref_res->get_operator() != Op::DEREF))
     {
@@ -580,7 +598,7 @@ auto Verifier::visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_
 
     if (res) {
         if (auto ref = res->get_ref()) {
-            auto valid_constructor_mut = (in_constructor_ and std::dynamic_pointer_cast<ClassFieldDecl>(ref));
+            auto valid_constructor_mut = (in_constructor_ and dyn_cast<ClassFieldDecl>(ref));
             if (!valid_constructor_mut) {
                 ref->set_reassigned();
                 if (!ref->is_mut()) {
@@ -595,9 +613,9 @@ auto Verifier::visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_
         }
     }
     else if (deref_res) {
-        if (auto l = std::dynamic_pointer_cast<VarExpr>(deref_res->get_expr())) {
+        if (auto l = dyn_cast<VarExpr>(deref_res->get_expr())) {
             auto ref = l->get_ref();
-            auto valid_constructor_mut = (in_constructor_ and std::dynamic_pointer_cast<ClassFieldDecl>(ref));
+            auto valid_constructor_mut = (in_constructor_ and dyn_cast<ClassFieldDecl>(ref));
             if (!valid_constructor_mut) {
                 ref->set_reassigned();
                 if (!ref->is_mut()) {
@@ -612,8 +630,8 @@ auto Verifier::visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_
         }
     }
     else if (array_index_res) {
-        if (auto ref = std::dynamic_pointer_cast<VarExpr>(array_index_res->get_array_expr())->get_ref()) {
-            auto valid_constructor_mut = (in_constructor_ and std::dynamic_pointer_cast<ClassFieldDecl>(ref));
+        if (auto ref = dyn_cast<VarExpr>(array_index_res->get_array_expr())->get_ref()) {
+            auto valid_constructor_mut = (in_constructor_ and dyn_cast<ClassFieldDecl>(ref));
             if (!valid_constructor_mut) {
                 ref->set_reassigned();
                 if (!ref->is_mut()) {
@@ -654,7 +672,7 @@ auto Verifier::visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_
             return;
         }
 
-        if (auto l = std::dynamic_pointer_cast<VarExpr>(class_field_res->get_class_instance())) {
+        if (auto l = dyn_cast<VarExpr>(class_field_res->get_class_instance())) {
             l->get_ref()->set_reassigned();
             if (!l->get_ref()->is_mut()) {
                 handler_->report_error(current_filename_, all_errors_[63], l->get_name(), assignment_expr->pos());
@@ -664,8 +682,8 @@ auto Verifier::visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_
 
     // Implicit casting from array to pointer in assignment expressions
     if (l->get_type()->is_pointer() and r->get_type()->is_array()) {
-        auto p_l = std::dynamic_pointer_cast<PointerType>(l->get_type());
-        auto a_r = std::dynamic_pointer_cast<ArrayType>(r->get_type());
+        auto p_l = cast<PointerType>(l->get_type());
+        auto a_r = cast<ArrayType>(r->get_type());
         if (*p_l->get_sub_type() != *a_r->get_sub_type()) {
             auto stream = std::stringstream{};
             stream << "expected " << *p_l->get_sub_type() << " as an inner type, got " << *a_r->get_sub_type();
@@ -706,7 +724,7 @@ auto Verifier::visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_
     return;
 }
 
-auto Verifier::visit_binary_expr(std::shared_ptr<BinaryExpr> binary_expr) -> void {
+auto Verifier::visit_binary_expr(BinaryExpr* binary_expr) -> void {
     auto l = binary_expr->get_left();
     auto r = binary_expr->get_right();
     l->visit(shared_from_this());
@@ -800,7 +818,7 @@ auto Verifier::visit_binary_expr(std::shared_ptr<BinaryExpr> binary_expr) -> voi
     }
 }
 
-auto Verifier::visit_unary_expr(std::shared_ptr<UnaryExpr> unary_expr) -> void {
+auto Verifier::visit_unary_expr(UnaryExpr* unary_expr) -> void {
     auto e = unary_expr->get_expr();
     auto op = unary_expr->get_operator();
 
@@ -839,16 +857,16 @@ auto Verifier::visit_unary_expr(std::shared_ptr<UnaryExpr> unary_expr) -> void {
         auto is_lvalue = false;
         auto var_name = std::string{};
         auto valid_constructor_case = false;
-        if (auto l = std::dynamic_pointer_cast<VarExpr>(e)) {
-            valid_constructor_case = in_constructor_ and std::dynamic_pointer_cast<ClassFieldDecl>(l->get_ref());
+        if (auto l = dyn_cast<VarExpr>(e)) {
+            valid_constructor_case = in_constructor_ and dyn_cast<ClassFieldDecl>(l->get_ref());
             is_mut |= l->get_ref()->is_mut();
             is_lvalue = true;
             var_name = l->get_name();
         }
-        if (auto l = std::dynamic_pointer_cast<UnaryExpr>(e)) {
+        if (auto l = dyn_cast<UnaryExpr>(e)) {
             if (l->get_operator() == Op::DEREF) {
-                auto v = std::dynamic_pointer_cast<VarExpr>(l->get_expr());
-                valid_constructor_case = in_constructor_ and std::dynamic_pointer_cast<ClassFieldDecl>(v->get_ref());
+                auto v = dyn_cast<VarExpr>(l->get_expr());
+                valid_constructor_case = in_constructor_ and dyn_cast<ClassFieldDecl>(v->get_ref());
                 is_mut |= v->get_ref()->is_mut();
                 is_lvalue = true;
                 var_name = v->get_name();
@@ -889,13 +907,13 @@ auto Verifier::visit_unary_expr(std::shared_ptr<UnaryExpr> unary_expr) -> void {
             unary_expr->set_type(handler_->ERROR_TYPE);
         }
         else {
-            auto const p_t = std::dynamic_pointer_cast<PointerType>(e->get_type());
+            auto const p_t = cast<PointerType>(e->get_type());
             unary_expr->set_type(p_t->get_sub_type());
         }
     }
     else if (op == Op::ADDRESS_OF) {
-        auto const var = std::dynamic_pointer_cast<VarExpr>(e);
-        auto const index = std::dynamic_pointer_cast<ArrayIndexExpr>(e);
+        auto const var = dyn_cast<VarExpr>(e);
+        auto const index = dyn_cast<ArrayIndexExpr>(e);
         if (!var and !index) {
             handler_->report_error(current_filename_, all_errors_[25], "", unary_expr->pos());
             unary_expr->set_type(handler_->ERROR_TYPE);
@@ -904,22 +922,23 @@ auto Verifier::visit_unary_expr(std::shared_ptr<UnaryExpr> unary_expr) -> void {
             auto const decl = var->get_ref();
             if (!decl or !decl->is_mut()) {
                 auto stream = std::stringstream{};
-                stream << "variable '" << decl->get_ident() << "' defined at " << decl->pos();
+                stream << "variable '" << decl->get_ident() << "' defined at " << handler_->locate(decl->pos());
                 handler_->report_error(current_filename_, all_errors_[26], stream.str(), unary_expr->pos());
                 unary_expr->set_type(handler_->ERROR_TYPE);
             }
-            unary_expr->set_type(std::make_shared<PointerType>(e->get_type()));
+            unary_expr->set_type(PointerType::get(e->get_type()));
         }
         else if (index) {
-            auto const var_expr = std::dynamic_pointer_cast<VarExpr>(index->get_array_expr());
+            auto const var_expr = dyn_cast<VarExpr>(index->get_array_expr());
             if (var_expr and !var_expr->get_ref()->is_mut()) {
                 auto stream = std::stringstream{};
-                stream << "array '" << var_expr->get_name() << "' defined at " << var_expr->get_ref()->pos();
+                stream << "array '" << var_expr->get_name() << "' defined at "
+                       << handler_->locate(var_expr->get_ref()->pos());
                 handler_->report_error(current_filename_, all_errors_[26], stream.str(), unary_expr->pos());
                 unary_expr->set_type(handler_->ERROR_TYPE);
             }
             unary_expr->get_expr()->set_parent(unary_expr);
-            unary_expr->set_type(std::make_shared<PointerType>(e->get_type()));
+            unary_expr->set_type(PointerType::get(e->get_type()));
         }
         else {
             std::cout << "UNREACHABLE Verifier::visit_unary_expr\n";
@@ -929,12 +948,12 @@ auto Verifier::visit_unary_expr(std::shared_ptr<UnaryExpr> unary_expr) -> void {
     return;
 }
 
-auto Verifier::visit_null_expr(std::shared_ptr<NullExpr> null_expr) -> void {
+auto Verifier::visit_null_expr(NullExpr* null_expr) -> void {
     (void)null_expr;
     return;
 }
 
-auto Verifier::visit_int_expr(std::shared_ptr<IntExpr> int_expr) -> void {
+auto Verifier::visit_int_expr(IntExpr* int_expr) -> void {
     if (current_numerical_type.has_value() and !(*current_numerical_type)->is_signed_int()) {
         int_expr->set_type(handler_->ERROR_TYPE);
         return;
@@ -951,7 +970,7 @@ auto Verifier::visit_int_expr(std::shared_ptr<IntExpr> int_expr) -> void {
     return;
 }
 
-auto Verifier::visit_decimal_expr(std::shared_ptr<DecimalExpr> decimal_expr) -> void {
+auto Verifier::visit_decimal_expr(DecimalExpr* decimal_expr) -> void {
     if (current_numerical_type.has_value() and !(*current_numerical_type)->is_decimal()) {
         decimal_expr->set_type(handler_->ERROR_TYPE);
         return;
@@ -967,7 +986,7 @@ auto Verifier::visit_decimal_expr(std::shared_ptr<DecimalExpr> decimal_expr) ->
     return;
 }
 
-auto Verifier::visit_uint_expr(std::shared_ptr<UIntExpr> uint_expr) -> void {
+auto Verifier::visit_uint_expr(UIntExpr* uint_expr) -> void {
     if (current_numerical_type.has_value() and !(*current_numerical_type)->is_unsigned_int()) {
         return;
     }
@@ -984,31 +1003,31 @@ auto Verifier::visit_uint_expr(std::shared_ptr<UIntExpr> uint_expr) -> void {
     return;
 }
 
-auto Verifier::visit_bool_expr(std::shared_ptr<BoolExpr> bool_expr) -> void {
+auto Verifier::visit_bool_expr(BoolExpr* bool_expr) -> void {
     (void)bool_expr;
     return;
 }
 
-auto Verifier::visit_string_expr(std::shared_ptr<StringExpr> string_expr) -> void {
+auto Verifier::visit_string_expr(StringExpr* string_expr) -> void {
     (void)string_expr;
     return;
 }
 
-auto Verifier::visit_char_expr(std::shared_ptr<CharExpr> char_expr) -> void {
+auto Verifier::visit_char_expr(CharExpr* char_expr) -> void {
     (void)char_expr;
     return;
 }
 
-auto Verifier::visit_var_expr(std::shared_ptr<VarExpr> var_expr) -> void {
+auto Verifier::visit_var_expr(VarExpr* var_expr) -> void {
     auto n = var_expr->get_name();
-    std::shared_ptr<Decl> d;
-    auto entry = symbol_table_.retrieve(n);
+    Decl* d;
+    auto entry = symbol_table_.retrieve(var_expr->get_symbol());
 
     if (!entry.has_value() and curr_module_access_) {
         // Checking for global var
         auto found = false;
         for (auto& global_var : curr_module_access_->get_global_vars()) {
-            if (global_var->get_ident() == n) {
+            if (global_var->get_symbol() == var_expr->get_symbol()) {
                 d = global_var;
                 if (!d->is_pub()) {
                     handler_->report_error(current_filename_,
@@ -1051,16 +1070,16 @@ auto Verifier::visit_var_expr(std::shared_ptr<VarExpr> var_expr) -> void {
             }
         }
         if (!found) {
-            auto const method_d = std::dynamic_pointer_cast<MethodDecl>(current_function_or_method_);
-            auto const constructor_d = std::dynamic_pointer_cast<ConstructorDecl>(current_function_or_method_);
-            auto const destructor_d = std::dynamic_pointer_cast<DestructorDecl>(current_function_or_method_);
+            auto const method_d = dyn_cast<MethodDecl>(current_function_or_method_);
+            auto const constructor_d = dyn_cast<ConstructorDecl>(current_function_or_method_);
+            auto const destructor_d = dyn_cast<DestructorDecl>(current_function_or_method_);
             if (!method_d and !constructor_d and !destructor_d) {
                 handler_->report_error(current_filename_, all_errors_[8], n, var_expr->pos());
                 var_expr->set_type(handler_->ERROR_TYPE);
                 return;
             }
             for (auto& para : curr_class->get_fields()) {
-                if (para->get_ident() == n) {
+                if (para->get_symbol() == var_expr->get_symbol()) {
                     if (visiting_lhs_of_assignment_ and method_d and !method_d->is_mut()) {
                         auto error =
                             "field '" + n + "' can't be mutated in constant method '" + method_d->get_ident() + "'";
@@ -1088,13 +1107,13 @@ auto Verifier::visit_var_expr(std::shared_ptr<VarExpr> var_expr) -> void {
     return;
 }
 
-auto Verifier::visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void {
+auto Verifier::visit_call_expr(CallExpr* call_expr) -> void {
     auto const function_name = call_expr->get_name();
 
     // Checking for constructor expressions
     if (curr_module_access_ and curr_module_access_->class_with_name_exists(function_name)) {
         auto constructor_call_expr =
-            std::make_shared<ConstructorCallExpr>(call_expr->pos(), function_name, call_expr->get_args());
+            make_node<ConstructorCallExpr>(call_expr->pos(), function_name, call_expr->get_args());
         constructor_call_expr->visit(shared_from_this());
         updated_expr_ = constructor_call_expr;
         return;
@@ -1102,7 +1121,7 @@ auto Verifier::visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void {
 
     if (current_module_->class_with_name_exists(function_name)) {
         auto constructor_call_expr =
-            std::make_shared<ConstructorCallExpr>(call_expr->pos(), function_name, call_expr->get_args());
+            make_node<ConstructorCallExpr>(call_expr->pos(), function_name, call_expr->get_args());
         constructor_call_expr->visit(shared_from_this());
         updated_expr_ = constructor_call_expr;
         return;
@@ -1111,7 +1130,7 @@ auto Verifier::visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void {
         for (auto& module : current_module_->get_using_modules()) {
             if (module->class_with_name_exists(function_name)) {
                 auto constructor_call_expr =
-                    std::make_shared<ConstructorCallExpr>(call_expr->pos(), function_name, call_expr->get_args());
+                    make_node<ConstructorCallExpr>(call_expr->pos(), function_name, call_expr->get_args());
                 constructor_call_expr->visit(shared_from_this());
                 updated_expr_ = constructor_call_expr;
                 return;
@@ -1121,10 +1140,10 @@ auto Verifier::visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void {
 
     if (curr_class) {
         // Could be calling a method on the current class
-        auto this_expr = std::make_shared<VarExpr>(call_expr->pos(), "this");
+        auto this_expr = make_node<VarExpr>(call_expr->pos(), "this");
         auto method_access_expr =
-            std::make_shared<MethodAccessExpr>(call_expr->pos(), this_expr, function_name, call_expr->get_args(), true);
-        auto new_args = std::vector<std::shared_ptr<Expr>>{};
+            make_node<MethodAccessExpr>(call_expr->pos(), this_expr, function_name, call_expr->get_args(), true);
+        auto new_args = std::vector<Expr*>{};
         for (auto& arg : method_access_expr->get_args()) {
             arg->visit(shared_from_this());
             if (updated_expr_) {
@@ -1153,7 +1172,7 @@ auto Verifier::visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void {
         return;
     }
 
-    auto updated_args = std::vector<std::shared_ptr<Expr>>{};
+    auto updated_args = std::vector<Expr*>{};
     for (auto& arg : call_expr->get_args()) {
         arg->visit(shared_from_this());
         if (updated_expr_) {
@@ -1166,7 +1185,7 @@ auto Verifier::visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void {
     }
     call_expr->set_args(updated_args);
 
-    std::optional<std::shared_ptr<Decl>> equivalent_func;
+    std::optional<Decl*> equivalent_func;
     if (curr_module_access_) {
         equivalent_func = curr_module_access_->get_decl(call_expr, false);
         if (!equivalent_func) {
@@ -1176,7 +1195,7 @@ auto Verifier::visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void {
             return;
         }
 
-        auto is_extern = std::dynamic_pointer_cast<Extern>(*equivalent_func);
+        auto is_extern = dyn_cast<Extern>(*equivalent_func);
         if (!(*equivalent_func)->is_pub()) {
             auto error = std::string{};
             if (is_extern) {
@@ -1206,13 +1225,13 @@ auto Verifier::visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void {
     return;
 }
 
-auto Verifier::visit_constructor_call_expr(std::shared_ptr<ConstructorCallExpr> constructor_call_expr) -> void {
+auto Verifier::visit_constructor_call_expr(ConstructorCallExpr* constructor_call_expr) -> void {
     auto p = constructor_call_expr->pos();
     for (auto& arg : constructor_call_expr->get_args()) {
         arg->visit(shared_from_this());
     }
 
-    std::optional<std::shared_ptr<ConstructorDecl>> equivalent_constructor;
+    std::optional<ConstructorDecl*> equivalent_constructor;
     if (curr_module_access_) {
         equivalent_constructor = curr_module_access_->get_constructor_decl(constructor_call_expr, false);
     }
@@ -1222,10 +1241,10 @@ auto Verifier::visit_constructor_call_expr(std::shared_ptr<ConstructorCallExpr>
     if (!equivalent_constructor) {
         auto args = constructor_call_expr->get_args();
         if (args.size() == 1 and args[0]->get_type()->is_pointer()) {
-            auto p_t = std::dynamic_pointer_cast<PointerType>(args[0]->get_type());
+            auto p_t = cast<PointerType>(args[0]->get_type());
             if (p_t->get_sub_type()->is_class()) {
-                auto class_type = std::dynamic_pointer_cast<ClassType>(p_t->get_sub_type());
-                if (class_type->get_ref()->get_ident() == constructor_call_expr->get_name()) {
+                auto class_type = cast<ClassType>(p_t->get_sub_type());
+                if (class_type->get_ref()->get_symbol() == constructor_call_expr->get_symbol()) {
                     constructor_call_expr->set_type(p_t->get_sub_type());
                     return;
                 }
@@ -1244,7 +1263,7 @@ auto Verifier::visit_constructor_call_expr(std::shared_ptr<ConstructorCallExpr>
     }
 
     (*equivalent_constructor)->set_used();
-    auto class_ref = std::dynamic_pointer_cast<ClassType>((*equivalent_constructor)->get_type());
+    auto class_ref = dyn_cast<ClassType>((*equivalent_constructor)->get_type());
     if (class_ref) {
         if (curr_module_access_ and !class_ref->get_ref()->is_pub()) {
             auto error = "class '" + class_ref->get_ref()->get_ident() + "' is not accessible outside of its module";
@@ -1260,7 +1279,7 @@ auto Verifier::visit_constructor_call_expr(std::shared_ptr<ConstructorCallExpr>
     return;
 }
 
-auto Verifier::visit_cast_expr(std::shared_ptr<CastExpr> cast_expr) -> void {
+auto Verifier::visit_cast_expr(CastExpr* cast_expr) -> void {
     auto expr = cast_expr->get_expr();
     if (updated_expr_) {
         cast_expr->set_expr(updated_expr_);
@@ -1280,25 +1299,25 @@ auto Verifier::visit_cast_expr(std::shared_ptr<CastExpr> cast_expr) -> void {
     return;
 }
 
-auto Verifier::visit_array_init_expr(std::shared_ptr<ArrayInitExpr> array_init_expr) -> void {
+auto Verifier::visit_array_init_expr(ArrayInitExpr* array_init_expr) -> void {
     auto const arg_count = array_init_expr->get_exprs().size();
     auto p = array_init_expr->get_parent();
     auto has_size_specified = false;
     auto size_specified = size_t{0};
     auto has_sub_type_specified = false;
-    std::shared_ptr<Type> parent_t;
-    std::shared_ptr<Type> individual_type;
+    Type* parent_t = nullptr;
+    Type* individual_type = nullptr;
     auto error_occured = false;
 
-    if (auto l = std::dynamic_pointer_cast<LocalVarDecl>(p)) {
+    if (auto l = dyn_cast<LocalVarDecl>(p)) {
         parent_t = l->get_type();
     }
-    else if (auto g = std::dynamic_pointer_cast<GlobalVarDecl>(p)) {
+    else if (auto g = dyn_cast<GlobalVarDecl>(p)) {
         parent_t = g->get_type();
     }
 
     if (parent_t and parent_t->is_array()) {
-        if (auto l = std::dynamic_pointer_cast<ArrayType>(parent_t)) {
+        if (auto l = dyn_cast<ArrayType>(parent_t)) {
             has_sub_type_specified = true;
             individual_type = l->get_sub_type();
             if (individual_type->is_numeric()) {
@@ -1314,7 +1333,7 @@ auto Verifier::visit_array_init_expr(std::shared_ptr<ArrayInitExpr> array_init_e
 
     auto element_types = individual_type;
     auto elem_num = 0u;
-    auto updated_exprs = std::vector<std::shared_ptr<Expr>>{};
+    auto updated_exprs = std::vector<Expr*>{};
     for (auto& expr : array_init_expr->get_exprs()) {
         expr->visit(shared_from_this());
         if (updated_expr_) {
@@ -1369,13 +1388,13 @@ auto Verifier::visit_array_init_expr(std::shared_ptr<ArrayInitExpr> array_init_e
     }
     else {
         array_init_expr->set_type(
-            std::make_shared<ArrayType>(element_types, (has_size_specified) ? size_specified : arg_count));
+            ArrayType::get(element_types, (has_size_specified) ? size_specified : arg_count));
     }
 
     return;
 }
 
-auto Verifier::visit_array_index_expr(std::shared_ptr<ArrayIndexExpr> array_index_expr) -> void {
+auto Verifier::visit_array_index_expr(ArrayIndexExpr* array_index_expr) -> void {
     auto has_error = false;
     array_index_expr->get_array_expr()->visit(shared_from_this());
     array_index_expr->get_array_expr()->set_parent(array_index_expr);
@@ -1398,15 +1417,15 @@ auto Verifier::visit_array_index_expr(std::shared_ptr<ArrayIndexExpr> array_inde
     }
     else if (!array_index_t->is_i64()) {
         auto const old_expr = array_index_expr->get_index_expr();
-        auto new_expr = std::make_shared<CastExpr>(old_expr->pos(), old_expr, std::make_shared<Type>(TypeSpec::I64));
+        auto new_expr = make_node<CastExpr>(old_expr->pos(), old_expr, Type::get(TypeSpec::I64));
         array_index_expr->set_index_expr(new_expr);
     }
 
     if (!has_error) {
-        if (auto l = std::dynamic_pointer_cast<ArrayType>(array_expr_t)) {
+        if (auto l = dyn_cast<ArrayType>(array_expr_t)) {
             array_index_expr->set_type(l->get_sub_type());
         }
-        else if (auto l2 = std::dynamic_pointer_cast<PointerType>(array_expr_t)) {
+        else if (auto l2 = dyn_cast<PointerType>(array_expr_t)) {
             array_index_expr->set_type(l2->get_sub_type());
         }
     }
@@ -1417,10 +1436,10 @@ auto Verifier::visit_array_index_expr(std::shared_ptr<ArrayIndexExpr> array_inde
     return;
 }
 
-auto Verifier::visit_enum_access_expr(std::shared_ptr<EnumAccessExpr> enum_access_expr) -> void {
+auto Verifier::visit_enum_access_expr(EnumAccessExpr* enum_access_expr) -> void {
     auto enum_name = enum_access_expr->get_enum_name();
     auto field_name = enum_access_expr->get_field();
-    std::optional<std::shared_ptr<EnumDecl>> ref;
+    std::optional<EnumDecl*> ref;
     if (curr_module_access_) {
         ref = curr_module_access_->get_enum(enum_name);
     }
@@ -1443,11 +1462,11 @@ auto Verifier::visit_enum_access_expr(std::shared_ptr<EnumAccessExpr> enum_acces
     }
 
     (*ref)->set_used();
-    enum_access_expr->set_type(std::make_shared<EnumType>(*ref));
+    enum_access_expr->set_type(EnumType::get(*ref));
     enum_access_expr->set_field_num(*num);
 }
 
-auto Verifier::visit_field_access_expr(std::shared_ptr<FieldAccessExpr> field_access_expr) -> void {
+auto Verifier::visit_field_access_expr(FieldAccessExpr* field_access_expr) -> void {
     field_access_expr->get_class_instance()->visit(shared_from_this());
     if (updated_expr_) {
         field_access_expr->set_class_instance(updated_expr_);
@@ -1455,11 +1474,11 @@ auto Verifier::visit_field_access_expr(std::shared_ptr<FieldAccessExpr> field_ac
     }
 
     auto is_this = false;
-    if (auto l = std::dynamic_pointer_cast<VarExpr>(field_access_expr->get_class_instance())) {
+    if (auto l = dyn_cast<VarExpr>(field_access_expr->get_class_instance())) {
         is_this = l->get_name() == "this";
     }
 
-    std::shared_ptr<ClassType> class_type;
+    ClassType* class_type;
     if (field_access_expr->is_arrow()) {
         if (!field_access_expr->get_class_instance()->get_type()->is_pointer()) {
             auto error = std::stringstream{};
@@ -1469,11 +1488,11 @@ auto Verifier::visit_field_access_expr(std::shared_ptr<FieldAccessExpr> field_ac
             field_access_expr->set_type(handler_->ERROR_TYPE);
             return;
         }
-        auto pointer_type = std::dynamic_pointer_cast<PointerType>(field_access_expr->get_class_instance()->get_type());
-        class_type = std::dynamic_pointer_cast<ClassType>(pointer_type->get_sub_type());
+        auto pointer_type = dyn_cast<PointerType>(field_access_expr->get_class_instance()->get_type());
+        class_type = dyn_cast<ClassType>(pointer_type->get_sub_type());
     }
     else {
-        class_type = std::dynamic_pointer_cast<ClassType>(field_access_expr->get_class_instance()->get_type());
+        class_type = dyn_cast<ClassType>(field_access_expr->get_class_instance()->get_type());
     }
 
     if (!class_type) {
@@ -1511,7 +1530,7 @@ auto Verifier::visit_field_access_expr(std::shared_ptr<FieldAccessExpr> field_ac
     return;
 }
 
-auto Verifier::visit_method_access_expr(std::shared_ptr<MethodAccessExpr> method_access_expr) -> void {
+auto Verifier::visit_method_access_expr(MethodAccessExpr* method_access_expr) -> void {
     auto const n = method_access_expr->get_method_name();
     method_access_expr->get_class_instance()->visit(shared_from_this());
     if (updated_expr_) {
@@ -1519,7 +1538,7 @@ auto Verifier::visit_method_access_expr(std::shared_ptr<MethodAccessExpr> method
         updated_expr_ = nullptr;
     }
 
-    std::shared_ptr<ClassType> class_type;
+    ClassType* class_type;
     if (method_access_expr->is_arrow()) {
         if (!method_access_expr->get_class_instance()->get_type()->is_pointer()) {
             auto error = std::stringstream{};
@@ -1529,11 +1548,11 @@ auto Verifier::visit_method_access_expr(std::shared_ptr<MethodAccessExpr> method
             method_access_expr->set_type(handler_->ERROR_TYPE);
             return;
         }
-        auto pointer_type = std::dynamic_pointer_cast<PointerType>(method_access_expr->get_class_instance()->get_type());
-        class_type = std::dynamic_pointer_cast<ClassType>(pointer_type->get_sub_type());
+        auto pointer_type = dyn_cast<PointerType>(method_access_expr->get_class_instance()->get_type());
+        class_type = dyn_cast<ClassType>(pointer_type->get_sub_type());
     }
     else {
-        class_type = std::dynamic_pointer_cast<ClassType>(method_access_expr->get_class_instance()->get_type());
+        class_type = dyn_cast<ClassType>(method_access_expr->get_class_instance()->get_type());
     }
 
     if (!class_type) {
@@ -1574,7 +1593,7 @@ auto Verifier::visit_method_access_expr(std::shared_ptr<MethodAccessExpr> method
 
     auto paras = (*method_ref)->get_paras();
     auto c = 0u;
-    auto new_args = std::vector<std::shared_ptr<Expr>>{};
+    auto new_args = std::vector<Expr*>{};
     for (auto& arg : method_access_expr->get_args()) {
         if (paras[c]->get_type()->is_numeric()) {
             current_numerical_type = paras[c]->get_type();
@@ -1596,7 +1615,7 @@ auto Verifier::visit_method_access_expr(std::shared_ptr<MethodAccessExpr> method
     method_access_expr->set_type((*method_ref)->get_type());
 
     if ((*method_ref)->is_mut()) {
-        if (auto v = std::dynamic_pointer_cast<VarExpr>(method_access_expr->get_class_instance())) {
+        if (auto v = dyn_cast<VarExpr>(method_access_expr->get_class_instance())) {
             if (!v->get_ref()->is_mut()) {
                 auto error = "mutable method '" + (*method_ref)->get_ident() + "' called on a non-mutable variable '"
                              + v->get_name() + "'";
@@ -1609,10 +1628,10 @@ auto Verifier::visit_method_access_expr(std::shared_ptr<MethodAccessExpr> method
     return;
 }
 
-auto Verifier::visit_size_of_expr(std::shared_ptr<SizeOfExpr> size_of_expr) -> void {
+auto Verifier::visit_size_of_expr(SizeOfExpr* size_of_expr) -> void {
     if (size_of_expr->is_type()) {
         if (size_of_expr->get_type_to_size()->is_murky()) {
-            auto m_t = std::dynamic_pointer_cast<MurkyType>(size_of_expr->get_type_to_size());
+            auto m_t = cast<MurkyType>(size_of_expr->get_type_to_size());
             size_of_expr->set_type_to_size(unmurk_direct(m_t));
         }
     }
@@ -1626,14 +1645,14 @@ auto Verifier::visit_size_of_expr(std::shared_ptr<SizeOfExpr> size_of_expr) -> v
     return;
 }
 
-auto Verifier::visit_import_expr(std::shared_ptr<ImportExpr> import_expr) -> void {
+auto Verifier::visit_import_expr(ImportExpr* import_expr) -> void {
     auto alias_s = import_expr->get_alias_name();
     // Check if alias exists
     auto module = current_module_->get_module_from_alias(alias_s);
 
     if (!module) {
         // Check if an enum exists with that name
-        std::optional<std::shared_ptr<EnumDecl>> potential_enum;
+        std::optional<EnumDecl*> potential_enum;
         if (curr_module_access_) {
             potential_enum = curr_module_access_->get_enum(alias_s);
         }
@@ -1641,11 +1660,11 @@ auto Verifier::visit_import_expr(std::shared_ptr<ImportExpr> import_expr) -> voi
             potential_enum = current_module_->get_enum(alias_s);
         }
 
-        auto is_var_expr = std::dynamic_pointer_cast<VarExpr>(import_expr->get_expr());
+        auto is_var_expr = dyn_cast<VarExpr>(import_expr->get_expr());
         if (potential_enum.has_value() and is_var_expr) {
-            auto enum_access_expr = std::make_shared<EnumAccessExpr>(import_expr->pos(),
-                                                                     potential_enum.value()->get_ident(),
-                                                                     is_var_expr->get_name());
+            auto enum_access_expr = make_node<EnumAccessExpr>(import_expr->pos(),
+                                                              potential_enum.value()->get_ident(),
+                                                              is_var_expr->get_name());
             enum_access_expr->visit(shared_from_this());
             if (updated_expr_) {
                 import_expr->set_expr(updated_expr_);
@@ -1676,9 +1695,9 @@ auto Verifier::visit_import_expr(std::shared_ptr<ImportExpr> import_expr) -> voi
     return;
 }
 
-auto Verifier::visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void {
+auto Verifier::visit_new_expr(NewExpr* new_expr) -> void {
     if (new_expr->get_new_type()->is_murky()) {
-        new_expr->set_new_type(unmurk_direct(std::dynamic_pointer_cast<MurkyType>(new_expr->get_new_type())));
+        new_expr->set_new_type(unmurk_direct(cast<MurkyType>(new_expr->get_new_type())));
     }
     auto t = new_expr->get_new_type();
 
@@ -1715,18 +1734,18 @@ auto Verifier::visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void {
     else if (constructor_arg.has_value()) {
         // We have a call to a class constructor
         // Check for import type
-        std::shared_ptr<ClassType> class_type = nullptr;
+        ClassType* class_type = nullptr;
         std::shared_ptr<Module> curr_module_access = nullptr;
         std::string name = {};
         if (t->is_class()) {
-            class_type = std::dynamic_pointer_cast<ClassType>(t);
+            class_type = cast<ClassType>(t);
             name = class_type->get_ref()->get_ident();
         }
         else if (t->is_import()) {
-            auto mod = current_module_->get_module_from_alias(std::dynamic_pointer_cast<ImportType>(t)->get_name());
+            auto mod = current_module_->get_module_from_alias(cast<ImportType>(t)->get_name());
             t = unmurk(t);
             if (t->is_class()) {
-                class_type = std::dynamic_pointer_cast<ClassType>(t);
+                class_type = cast<ClassType>(t);
                 name = class_type->get_ref()->get_ident();
             }
             curr_module_access = *mod;
@@ -1740,7 +1759,7 @@ auto Verifier::visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void {
             return;
         }
 
-        auto new_constructor_args = std::vector<std::shared_ptr<Expr>>{};
+        auto new_constructor_args = std::vector<Expr*>{};
         for (auto& arg : *constructor_arg) {
             arg->visit(shared_from_this());
             if (updated_expr_) {
@@ -1753,9 +1772,9 @@ auto Verifier::visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void {
         }
         *constructor_arg = new_constructor_args;
 
-        auto constructor_call_expr = std::make_shared<ConstructorCallExpr>(new_expr->pos(), name, *constructor_arg);
+        auto constructor_call_expr = make_node<ConstructorCallExpr>(new_expr->pos(), name, *constructor_arg);
 
-        std::optional<std::shared_ptr<ConstructorDecl>> equivalent_constructor;
+        std::optional<ConstructorDecl*> equivalent_constructor;
         if (curr_module_access) {
             equivalent_constructor = curr_module_access->get_constructor_decl(constructor_call_expr, false);
         }
@@ -1766,10 +1785,10 @@ auto Verifier::visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void {
         if (!equivalent_constructor) {
             auto args = constructor_call_expr->get_args();
             if (args.size() == 1 and args[0]->get_type()->is_pointer()) {
-                auto p_t = std::dynamic_pointer_cast<PointerType>(args[0]->get_type());
+                auto p_t = cast<PointerType>(args[0]->get_type());
                 if (p_t->get_sub_type()->is_class()) {
-                    auto class_type = std::dynamic_pointer_cast<ClassType>(p_t->get_sub_type());
-                    if (class_type->get_ref()->get_ident() == constructor_call_expr->get_name()) {
+                    auto class_type = cast<ClassType>(p_t->get_sub_type());
+                    if (class_type->get_ref()->get_symbol() == constructor_call_expr->get_symbol()) {
                         constructor_call_expr->set_type(p_t->get_sub_type());
                         return;
                     }
@@ -1788,7 +1807,7 @@ auto Verifier::visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void {
         }
 
         (*equivalent_constructor)->set_used();
-        auto class_ref = std::dynamic_pointer_cast<ClassType>((*equivalent_constructor)->get_type());
+        auto class_ref = dyn_cast<ClassType>((*equivalent_constructor)->get_type());
         if (class_ref) {
             if (curr_module_access_ and !class_ref->get_ref()->is_pub()) {
                 auto error = "class '" + class_ref->get_ref()->get_ident() + "' is not accessible outside of its module";
@@ -1808,18 +1827,16 @@ auto Verifier::visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void {
         new_expr->set_call_expr(constructor_call_expr);
     }
 
-    new_expr->set_type(std::make_shared<PointerType>(t));
+    new_expr->set_type(PointerType::get(t));
     return;
 }
 
-auto Verifier::visit_empty_stmt(std::shared_ptr<EmptyStmt> empty_stmt) -> void {
+auto Verifier::visit_empty_stmt(EmptyStmt* empty_stmt) -> void {
     (void)empty_stmt;
     return;
 }
 
-auto Verifier::visit_compound_stmt(std::shared_ptr<CompoundStmt> compound_stmt) -> void {
-    auto p = compound_stmt->get_parent();
-
+auto Verifier::visit_compound_stmt(CompoundStmt* compound_stmt) -> void {
     symbol_table_.open_scope();
     auto i = 0u;
     auto const s = compound_stmt->get_stmts().size();
@@ -1827,7 +1844,7 @@ auto Verifier::visit_compound_stmt(std::shared_ptr<CompoundStmt> compound_stmt)
         ++global_statement_counter_;
         stmt->visit(shared_from_this());
         if (i != s - 1 and !handler_->quiet_mode()) {
-            auto const is_return_stmt = std::dynamic_pointer_cast<ReturnStmt>(stmt);
+            auto const is_return_stmt = dyn_cast<ReturnStmt>(stmt);
             if (is_return_stmt) {
                 handler_->report_error(current_filename_, all_errors_[43], "", stmt->pos());
             }
@@ -1855,8 +1872,8 @@ auto Verifier::visit_compound_stmt(std::shared_ptr<CompoundStmt> compound_stmt)
         auto member = *it;
         if (member.attr->get_type()->is_class()) {
             auto expr =
-                std::make_shared<VarExpr>(compound_stmt->pos(), member.attr->get_ident(), member.attr->get_type());
-            auto delete_stmt = std::make_shared<DeleteStmt>(compound_stmt->pos(), expr);
+                make_node<VarExpr>(compound_stmt->pos(), member.attr->get_ident(), member.attr->get_type());
+            auto delete_stmt = make_node<DeleteStmt>(compound_stmt->pos(), expr);
             delete_stmt->visit(shared_from_this());
             compound_stmt->add_stmt(delete_stmt);
         }
@@ -1866,11 +1883,11 @@ auto Verifier::visit_compound_stmt(std::shared_ptr<CompoundStmt> compound_stmt)
     return;
 }
 
-auto Verifier::visit_local_var_stmt(std::shared_ptr<LocalVarStmt> local_var_stmt) -> void {
+auto Verifier::visit_local_var_stmt(LocalVarStmt* local_var_stmt) -> void {
     local_var_stmt->get_decl()->visit(shared_from_this());
 }
 
-auto Verifier::visit_return_stmt(std::shared_ptr<ReturnStmt> return_stmt) -> void {
+auto Verifier::visit_return_stmt(ReturnStmt* return_stmt) -> void {
     has_return_ = true;
     auto expr = return_stmt->get_expr();
     if (updated_expr_) {
@@ -1878,10 +1895,10 @@ auto Verifier::visit_return_stmt(std::shared_ptr<ReturnStmt> return_stmt) -> voi
         expr = updated_expr_;
         updated_expr_ = nullptr;
     }
-    auto is_constructor = std::dynamic_pointer_cast<ConstructorDecl>(current_function_or_method_);
+    auto is_constructor = dyn_cast<ConstructorDecl>(current_function_or_method_);
 
     if (is_constructor) {
-        auto is_empty_expr = std::dynamic_pointer_cast<EmptyExpr>(expr);
+        auto is_empty_expr = dyn_cast<EmptyExpr>(expr);
         if (!is_empty_expr) {
             auto error = "in class '" + curr_class->get_ident() + "'";
             handler_->report_error(current_filename_, all_errors_[57], error, expr->pos());
@@ -1906,7 +1923,7 @@ auto Verifier::visit_return_stmt(std::shared_ptr<ReturnStmt> return_stmt) -> voi
     return;
 }
 
-auto Verifier::visit_expr_stmt(std::shared_ptr<ExprStmt> expr_stmt) -> void {
+auto Verifier::visit_expr_stmt(ExprStmt* expr_stmt) -> void {
     expr_stmt->get_expr()->visit(shared_from_this());
     if (updated_expr_) {
         expr_stmt->set_expr(updated_expr_);
@@ -1914,7 +1931,7 @@ auto Verifier::visit_expr_stmt(std::shared_ptr<ExprStmt> expr_stmt) -> void {
     }
 }
 
-auto Verifier::visit_while_stmt(std::shared_ptr<WhileStmt> while_stmt) -> void {
+auto Verifier::visit_while_stmt(WhileStmt* while_stmt) -> void {
     auto cond = while_stmt->get_cond();
     cond->visit(shared_from_this());
 
@@ -1930,7 +1947,7 @@ auto Verifier::visit_while_stmt(std::shared_ptr<WhileStmt> while_stmt) -> void {
     return;
 }
 
-auto Verifier::visit_if_stmt(std::shared_ptr<IfStmt> if_stmt) -> void {
+auto Verifier::visit_if_stmt(IfStmt* if_stmt) -> void {
     auto cond = if_stmt->get_cond();
     cond->visit(shared_from_this());
     if (!cond->get_type()->is_bool()) {
@@ -1948,7 +1965,7 @@ auto Verifier::visit_if_stmt(std::shared_ptr<IfStmt> if_stmt) -> void {
     return;
 }
 
-auto Verifier::visit_else_if_stmt(std::shared_ptr<ElseIfStmt> else_if_stmt) -> void {
+auto Verifier::visit_else_if_stmt(ElseIfStmt* else_if_stmt) -> void {
     auto cond = else_if_stmt->get_cond();
     cond->visit(shared_from_this());
     if (!cond->get_type()->is_bool()) {
@@ -1964,17 +1981,18 @@ auto Verifier::visit_else_if_stmt(std::shared_ptr<ElseIfStmt> else_if_stmt) -> v
     return;
 }
 
-auto Verifier::visit_loop_stmt(std::shared_ptr<LoopStmt> loop_stmt) -> void {
+auto Verifier::visit_loop_stmt(LoopStmt* loop_stmt) -> void {
     symbol_table_.open_scope();
 
-    auto var = std::make_shared<LocalVarDecl>(loop_stmt->pos(),
-                                              loop_stmt->get_var_name(),
-                                              std::make_shared<Type>(TypeSpec::I64),
-                                              std::make_shared<EmptyExpr>(loop_stmt->pos()));
+    auto var = make_node<LocalVarDecl>(loop_stmt->pos(),
+                                       loop_stmt->get_var_name(),
+                                       Type::get(TypeSpec::I64),
+                                       make_node<EmptyExpr>(loop_stmt->pos()));
     var->set_statement_num(global_statement_counter_);
     var->set_depth_num(loop_depth_);
+    assign_slot(var);
     loop_stmt->set_var_decl(var);
-    declare_variable(loop_stmt->get_var_name(), var);
+    declare_variable(var);
 
     if (loop_stmt->has_lower_bound()) {
         auto lower_bound = *loop_stmt->get_lower_bound();
@@ -2021,21 +2039,21 @@ auto Verifier::visit_loop_stmt(std::shared_ptr<LoopStmt> loop_stmt) -> void {
     return;
 }
 
-auto Verifier::visit_break_stmt(std::shared_ptr<BreakStmt> break_stmt) -> void {
+auto Verifier::visit_break_stmt(BreakStmt* break_stmt) -> void {
     if (loop_depth_ <= 0) {
         handler_->report_error(current_filename_, all_errors_[72], "", break_stmt->pos());
     }
     return;
 }
 
-auto Verifier::visit_continue_stmt(std::shared_ptr<ContinueStmt> continue_stmt) -> void {
+auto Verifier::visit_continue_stmt(ContinueStmt* continue_stmt) -> void {
     if (loop_depth_ <= 0) {
         handler_->report_error(current_filename_, all_errors_[73], "", continue_stmt->pos());
     }
     return;
 }
 
-auto Verifier::visit_delete_stmt(std::shared_ptr<DeleteStmt> delete_stmt) -> void {
+auto Verifier::visit_delete_stmt(DeleteStmt* delete_stmt) -> void {
     delete_stmt->get_expr()->visit(shared_from_this());
     if (updated_expr_) {
         delete_stmt->set_expr(updated_expr_);
@@ -2049,59 +2067,16 @@ auto Verifier::visit_delete_stmt(std::shared_ptr<DeleteStmt> delete_stmt) -> voi
     return;
 }
 
-auto Verifier::check(std::string const& filename, bool is_main, bool is_libc) -> void {
+auto Verifier::check(std::shared_ptr<Module> module, bool is_main) -> void {
+    auto const& filename = module->get_filepath();
     current_filename_ = filename;
-
-    // Already processed
-    if (modules_->module_exists_from_filename(filename) and !is_main) {
-        return;
-    }
-
-    std::shared_ptr<Module> module = nullptr;
-    if (!is_main) {
-        // Need to lex and parse the module first
-        auto lexer = Lexer(filename, handler_);
-        auto tokens = lexer.tokenize();
-        auto parser = Parser(tokens, filename, handler_);
-        module = parser.parse();
-        module->set_is_lib(is_libc);
-        modules_->add_module(module);
-    }
-    else {
-        module = modules_->get_main_module();
-    }
+    auto const phase = handler_->stats.phase("verify", filename);
 
     current_module_ = module;
+    auto const arena_scope = Arena::Scope{module->get_arena()};
 
-    // Load in all imported modules
-    for (auto const& import : current_module_->get_imported_filepaths()) {
-        auto name = import.first;
-        auto is_libc = import.second;
-        auto imported_module = modules_->get_module_from_filepath(name);
-        if (imported_module) {
-            current_module_->add_imported_module(name, imported_module);
-        }
-        else {
-            // Time to do all the work with it
-            auto new_verifier = std::make_shared<Verifier>(handler_, modules_);
-            new_verifier->check(name, false, is_libc);
-            current_module_->add_imported_module(name, modules_->get_module_from_filepath(name));
-        }
-    }
-    // Load in all using modules
-    for (auto const& using_ : current_module_->get_using_filepaths()) {
-        auto name = using_.first;
-        auto is_libc = using_.second;
-        auto using_module = modules_->get_module_from_filepath(name);
-        if (using_module) {
-            current_module_->add_using_module(name, using_module);
-        }
-        else {
-            auto new_verifier = std::make_shared<Verifier>(handler_, modules_);
-            new_verifier->check(name, false, is_libc);
-            current_module_->add_using_module(name, modules_->get_module_from_filepath(name));
-        }
-    }
+    // Everything this module depends on has already been loaded and verified
+    current_module_->attach_dependencies(*modules_);
 
     check_duplicate_custom_type();
     for (auto& enum_ : current_module_->get_enums()) {
@@ -2116,29 +2091,29 @@ auto Verifier::check(std::string const& filename, bool is_main, bool is_libc) ->
             for (auto& para : method->get_paras()) {
                 unmurk_decl(para);
                 if (para->get_type()->is_array()) {
-                    auto a_t = std::dynamic_pointer_cast<ArrayType>(para->get_type());
+                    auto a_t = cast<ArrayType>(para->get_type());
                     if (a_t->get_sub_type()->is_void()) {
                         handler_->report_error(current_filename_, all_errors_[47], para->get_ident(), para->pos());
                         para->set_type(handler_->ERROR_TYPE);
                     }
                     else {
-                        para->set_type(std::make_shared<PointerType>(a_t->get_sub_type()));
+                        para->set_type(PointerType::get(a_t->get_sub_type()));
                     }
                 }
             }
         }
         for (auto& constructor : class_->get_constructors()) {
-            constructor->set_type(std::make_shared<ClassType>(class_));
+            constructor->set_type(ClassType::get(class_));
             for (auto& para : constructor->get_paras()) {
                 unmurk_decl(para);
                 if (para->get_type()->is_array()) {
-                    auto a_t = std::dynamic_pointer_cast<ArrayType>(para->get_type());
+                    auto a_t = cast<ArrayType>(para->get_type());
                     if (a_t->get_sub_type()->is_void()) {
                         handler_->report_error(current_filename_, all_errors_[47], para->get_ident(), para->pos());
                         para->set_type(handler_->ERROR_TYPE);
                     }
                     else {
-                        para->set_type(std::make_shared<PointerType>(a_t->get_sub_type()));
+                        para->set_type(PointerType::get(a_t->get_sub_type()));
                     }
                 }
             }
@@ -2163,13 +2138,13 @@ auto Verifier::check(std::string const& filename, bool is_main, bool is_libc) ->
         for (auto& para : func->get_paras()) {
             unmurk_decl(para);
             if (para->get_type()->is_array()) {
-                auto a_t = std::dynamic_pointer_cast<ArrayType>(para->get_type());
+                auto a_t = cast<ArrayType>(para->get_type());
                 if (a_t->get_sub_type()->is_void()) {
                     handler_->report_error(current_filename_, all_errors_[47], para->get_ident(), para->pos());
                     para->set_type(handler_->ERROR_TYPE);
                 }
                 else {
-                    para->set_type(std::make_shared<PointerType>(a_t->get_sub_type()));
+                    para->set_type(PointerType::get(a_t->get_sub_type()));
                 }
             }
         }
@@ -2189,33 +2164,37 @@ auto Verifier::check(std::string const& filename, bool is_main, bool is_libc) ->
     }
 }
 
+auto Verifier::report_import_cycle(std::string const& filename, std::string const& cycle) -> void {
+    handler_->report_error(filename, all_errors_[85], cycle, Position{});
+}
+
 auto Verifier::check_unused_declarations() -> void {
-    for (auto const& module : modules_->get_modules()) {
-        if (module->is_lib()) {
+    for (auto const& module : *modules_) {
+        if (module.is_lib()) {
             continue;
         }
-        auto name = module->get_filepath();
-        for (auto const& func : module->get_functions()) {
+        auto name = module.get_filepath();
+        for (auto const& func : module.get_functions()) {
             if (func->get_ident() != "main" and !func->is_used()) {
                 auto stream = std::stringstream{};
                 stream << "'" << func->get_ident() << "'";
                 handler_->report_minor_error(name, all_errors_[22], stream.str(), func->pos());
             }
         }
-        for (auto const& extern_ : module->get_externs()) {
+        for (auto const& extern_ : module.get_externs()) {
             if (!extern_->is_used()) {
                 auto stream = std::stringstream{};
                 stream << "'" << extern_->get_ident() << "'";
                 handler_->report_minor_error(name, all_errors_[23], stream.str(), extern_->pos());
             }
         }
-        for (auto const& enum_ : module->get_enums()) {
+        for (auto const& enum_ : module.get_enums()) {
             if (!enum_->is_used()) {
                 auto stream = "'" + enum_->get_ident() + "'";
                 handler_->report_minor_error(name, all_errors_[41], stream, enum_->pos());
             }
         }
-        for (auto const& class_ : module->get_classes()) {
+        for (auto const& class_ : module.get_classes()) {
             if (!class_->is_used()) {
                 auto stream = "'" + class_->get_ident() + "'";
                 handler_->report_minor_error(name, all_errors_[52], stream, class_->pos());
@@ -2223,7 +2202,7 @@ auto Verifier::check_unused_declarations() -> void {
             for (auto const& constructor : class_->get_constructors()) {
                 if (!constructor->is_used()) {
                     auto stream = "in class '" + class_->get_ident() + "' at line "
-                                  + std::to_string(constructor->pos().line_start_);
+                                  + std::to_string(handler_->locate(constructor->pos()).line_start_);
                     handler_->report_minor_error(name, all_errors_[55], stream, constructor->pos());
                 }
             }
@@ -2248,7 +2227,7 @@ auto Verifier::load_all_global_variables() -> void {
     for (auto const& global_var : current_module_->get_global_vars()) {
         global_var->set_statement_num(global_statement_counter_);
         global_var->set_depth_num(loop_depth_);
-        declare_variable(global_var->get_ident() + global_var->get_append(), global_var);
+        declare_variable(global_var);
     }
 }
 
@@ -2264,7 +2243,8 @@ auto Verifier::check_duplicate_custom_type() -> void {
             handler_->report_error(
                 current_filename_,
                 all_errors_[36],
-                "enum '" + name + "' previously defined as an enum at line " + std::to_string(it->second.line_start_),
+                "enum '" + name + "' previously defined as an enum at line "
+                    + std::to_string(handler_->locate(it->second).line_start_),
                 pos);
         }
         else {
@@ -2280,14 +2260,14 @@ auto Verifier::check_duplicate_custom_type() -> void {
             handler_->report_error(current_filename_,
                                    all_errors_[36],
                                    "class '" + name + "' previously defined as an enum at line "
-                                       + std::to_string(it_enum->second.line_start_),
+                                       + std::to_string(handler_->locate(it_enum->second).line_start_),
                                    pos);
         }
         else if (auto it_class = classes_seen.find(name); it_class != classes_seen.end()) {
             handler_->report_error(current_filename_,
                                    all_errors_[36],
                                    "class '" + name + "' previously defined as a class at line "
-                                       + std::to_string(it_class->second.line_start_),
+                                       + std::to_string(handler_->locate(it_class->second).line_start_),
                                    pos);
         }
         else {
@@ -2297,20 +2277,22 @@ auto Verifier::check_duplicate_custom_type() -> void {
 }
 
 auto Verifier::check_duplicate_globals() -> void {
-    std::vector<GlobalVarDecl> seen_globals;
+    std::vector<GlobalVarDecl*> seen_globals;
     for (const auto& global_var : current_module_->get_global_vars()) {
-        auto it = std::find(seen_globals.begin(), seen_globals.end(), *global_var);
+        auto it = std::find_if(seen_globals.begin(), seen_globals.end(), [&global_var](auto* seen) {
+            return *seen == *global_var;
+        });
         if (it != seen_globals.end()) {
             handler_->report_error(current_filename_, all_errors_[30], global_var->get_ident(), global_var->pos());
         }
         else {
-            seen_globals.push_back(*global_var);
+            seen_globals.push_back(global_var);
         }
     }
 }
 
 auto Verifier::check_duplicate_function_declaration() -> void {
-    std::vector<Function> seen_functions;
+    std::vector<Function*> seen_functions;
     for (const auto& func : current_module_->get_functions()) {
         if (current_module_->class_with_name_exists(func->get_ident())) {
             handler_->report_error(current_filename_,
@@ -2319,66 +2301,80 @@ auto Verifier::check_duplicate_function_declaration() -> void {
                                    func->pos());
         }
 
-        auto it = std::find(seen_functions.begin(), seen_functions.end(), *func);
+        auto it = std::find_if(seen_functions.begin(), seen_functions.end(), [&func](auto* seen) {
+            return *seen == *func;
+        });
         if (it != seen_functions.end()) {
             handler_->report_error(current_filename_, all_errors_[1], func->get_ident(), func->pos());
         }
         else {
-            seen_functions.push_back(*func);
+            seen_functions.push_back(func);
         }
     }
 }
 
-auto Verifier::check_duplicate_method_declaration(std::shared_ptr<ClassDecl>& class_decl) -> void {
-    std::vector<MethodDecl> seen_methods;
+auto Verifier::check_duplicate_method_declaration(ClassDecl*& class_decl) -> void {
+    std::vector<MethodDecl*> seen_methods;
     for (auto const& method : class_decl->get_methods()) {
-        auto it = std::find(seen_methods.begin(), seen_methods.end(), *method);
+        auto it = std::find_if(seen_methods.begin(), seen_methods.end(), [&method](auto* seen) {
+            return *seen == *method;
+        });
         if (it != seen_methods.end()) {
             auto error = "method '" + method->get_ident() + "' on class '" + curr_class->get_ident() + "'";
             handler_->report_error(current_filename_, all_errors_[54], error, method->pos());
         }
         else {
-            seen_methods.push_back(*method);
+            seen_methods.push_back(method);
         }
     }
 }
 
-auto Verifier::check_duplicate_constructor_declaration(std::shared_ptr<ClassDecl>& class_decl) -> void {
-    std::vector<ConstructorDecl> seen_constructors;
+auto Verifier::check_duplicate_constructor_declaration(ClassDecl*& class_decl) -> void {
+    std::vector<ConstructorDecl*> seen_constructors;
     for (auto const& constructor : class_decl->get_constructors()) {
-        auto it = std::find(seen_constructors.begin(), seen_constructors.end(), *constructor);
+        auto it = std::find_if(seen_constructors.begin(), seen_constructors.end(), [&constructor](auto* seen) {
+            return *seen == *constructor;
+        });
         if (it != seen_constructors.end()) {
             auto const error = "on class '" + curr_class->get_ident() + "' previously declared at line "
-                               + std::to_string(it->pos().line_start_);
+                               + std::to_string(handler_->locate((*it)->pos()).line_start_);
             handler_->report_error(current_filename_, all_errors_[56], error, constructor->pos());
         }
         else {
-            seen_constructors.push_back(*constructor);
+            seen_constructors.push_back(constructor);
         }
     }
 }
 
 auto Verifier::check_duplicate_extern_declaration() -> void {
-    std::vector<Extern> seen_externs;
+    std::vector<Extern*> seen_externs;
     for (const auto& extern_ : current_module_->get_externs()) {
-        auto it = std::find(seen_externs.begin(), seen_externs.end(), *extern_);
+        auto it = std::find_if(seen_externs.begin(), seen_externs.end(), [&extern_](auto* seen) {
+            return *seen == *extern_;
+        });
         if (it != seen_externs.end()) {
             handler_->report_error(current_filename_, all_errors_[15], extern_->get_ident(), extern_->pos());
         }
         else {
-            seen_externs.push_back(*extern_);
+            seen_externs.push_back(extern_);
         }
     }
 }
 
-auto Verifier::declare_variable(std::string ident, std::shared_ptr<Decl> decl) -> void {
-    auto pos = ident.find('.');
-    auto entry = symbol_table_.retrieve_one_level(ident.substr(0, pos));
+auto Verifier::assign_slot(Decl* decl) -> void {
+    auto const slot = current_function_or_method_->get_num_slots();
+    decl->set_slot(slot);
+    current_function_or_method_->set_num_slots(slot + 1);
+}
+
+auto Verifier::declare_variable(Decl* decl) -> void {
+    auto entry = symbol_table_.retrieve_one_level(decl->get_symbol());
     if (entry.has_value()) {
-        const std::string error_message = "'" + ident.substr(0, pos) + "'. Previously declared at line "
-                                          + std::to_string(entry->attr->pos().line_start_) + ", column "
-                                          + std::to_string(entry->attr->pos().col_start_);
-        if (auto derived_para_decl = std::dynamic_pointer_cast<ParaDecl>(decl)) {
+        auto const previous = handler_->locate(entry->attr->pos());
+        const std::string error_message = "'" + decl->get_ident() + "'. Previously declared at line "
+                                          + std::to_string(previous.line_start_) + ", column "
+                                          + std::to_string(previous.col_start_);
+        if (isa<ParaDecl>(decl)) {
             handler_->report_minor_error(current_filename_, all_errors_[3], error_message, decl->pos());
             return;
         }
@@ -2389,88 +2385,81 @@ auto Verifier::declare_variable(std::string ident, std::shared_ptr<Decl> decl) -
         }
     }
 
-    symbol_table_.insert(ident, decl);
+    symbol_table_.insert(decl->get_symbol(), decl);
 }
 
-auto Verifier::unmurk_decl(std::shared_ptr<Decl> decl) -> void {
+auto Verifier::unmurk_decl(Decl* decl) -> void {
     unmurk_pos = decl->pos();
     auto new_t = unmurk(decl->get_type());
     decl->set_type(new_t);
 }
 
-auto Verifier::unmurk(std::shared_ptr<Type> murky_t) -> std::shared_ptr<Type> {
+auto Verifier::unmurk(Type* murky_t) -> Type* {
     if (murky_t->is_murky()) {
-        return unmurk_direct(std::dynamic_pointer_cast<MurkyType>(murky_t));
+        return unmurk_direct(cast<MurkyType>(murky_t));
     }
     else if (murky_t->is_array()) {
-        auto l = std::dynamic_pointer_cast<ArrayType>(murky_t);
+        auto l = cast<ArrayType>(murky_t);
         if (l->get_length().has_value()) {
-            return std::make_shared<ArrayType>(unmurk(l->get_sub_type()), *l->get_length());
+            return ArrayType::get(unmurk(l->get_sub_type()), *l->get_length());
         }
         else {
-            return std::make_shared<ArrayType>(unmurk(l->get_sub_type()));
+            return ArrayType::get(unmurk(l->get_sub_type()));
         }
     }
     else if (murky_t->is_pointer()) {
-        auto l = std::dynamic_pointer_cast<PointerType>(murky_t);
-        return std::make_shared<PointerType>(unmurk(l->get_sub_type()));
+        auto l = cast<PointerType>(murky_t);
+        return PointerType::get(unmurk(l->get_sub_type()));
     }
     else if (murky_t->is_import()) {
-        auto l = std::dynamic_pointer_cast<ImportType>(murky_t);
+        auto l = cast<ImportType>(murky_t);
         assert(l->get_sub_type()->is_murky());
         auto module = current_module_->get_module_from_alias(l->get_name());
         if (!module.has_value()) {
             auto err = "alias '" + l->get_name() + "' not recognised for type declaration";
             handler_->report_error(current_filename_, all_errors_[38], err, unmurk_pos);
-            return std::make_shared<Type>(TypeSpec::ERROR);
+            return Type::get(TypeSpec::ERROR);
         }
 
         curr_module_access_ = *module;
         curr_module_alias_ = l->get_name();
-        return unmurk_direct(std::dynamic_pointer_cast<MurkyType>(l->get_sub_type()));
+        return unmurk_direct(cast<MurkyType>(l->get_sub_type()));
         curr_module_access_ = nullptr;
     }
     return murky_t;
 }
 
-auto Verifier::unmurk_direct(std::shared_ptr<MurkyType> murky_t) -> std::shared_ptr<Type> {
-    auto lex = std::string{};
-    lex += murky_t->get_name();
+auto Verifier::unmurk_direct(MurkyType* murky_t) -> Type* {
+    auto const lex = Symbol{murky_t->get_name()};
 
-    std::shared_ptr<Module> mod;
-    if (curr_module_access_) {
-        mod = curr_module_access_;
-    }
-    else {
-        mod = current_module_;
-    }
+    auto const& mod = curr_module_access_ ? curr_module_access_ : current_module_;
 
     for (auto& enum_ : mod->get_enums()) {
-        if (enum_->get_ident() == lex) {
+        if (enum_->get_symbol() == lex) {
             enum_->set_used();
-            return std::make_shared<EnumType>(enum_);
+            return EnumType::get(enum_);
         }
     }
 
     for (auto& class_ : mod->get_classes()) {
-        if (class_->get_ident() == lex) {
+        if (class_->get_symbol() == lex) {
             class_->set_used();
-            return std::make_shared<ClassType>(class_);
+            return ClassType::get(class_);
         }
     }
 
     if (!curr_module_access_) {
         for (auto& module : mod->get_using_modules()) {
             for (auto& enum_ : module->get_enums()) {
-                if (enum_->get_ident() == lex) {
+                if (enum_->get_symbol() == lex) {
                     enum_->set_used();
-                    return std::make_shared<EnumType>(enum_);
+                    return EnumType::get(enum_);
                 }
             }
             for (auto& class_ : module->get_classes()) {
-                if (class_->get_ident() == lex) {
+                if (class_->get_symbol() == lex) {
                     class_->set_used();
-                    return std::make_shared<ClassType>(class_);
+                    return ClassType::get(class_);
                 }
             }
         }
@@ -2483,5 +2472,5 @@ auto Verifier::unmurk_direct(std::shared_ptr<MurkyType> murky_t) -> std::shared_
     err += murky_t->get_name();
 
     handler_->report_error(current_filename_, all_errors_[42], err, unmurk_pos);
-    return std::make_shared<Type>(TypeSpec::ERROR);
+    return Type::get(TypeSpec::ERROR);
 }
\ No newline at end of file
@@ -1,19 +1,22 @@
 #ifndef VERIFIER_HPP
 #define VERIFIER_HPP
 
-#include <list>
 #include <memory>
+#include <unordered_map>
 
 #include "./handler.hpp"
 #include "./module.hpp"
 #include "./visitor.hpp"
 
 struct TableEntry {
-    std::string id;
+    Symbol id;
     int level;
-    std::shared_ptr<Decl> attr;
+    Decl* attr;
 };
 
+// Scoped symbol table. Entries live on a stack in declaration order, which doubles as the undo log that
+// close_scope() unwinds, and each name indexes the stack slots that currently bind it, innermost last, so
+// lookups don't scan.
 class SymbolTable {
  public:
     SymbolTable() = default;
@@ -21,26 +24,23 @@ class SymbolTable {
     auto open_scope() -> void {
         ++level_;
     }
-    auto close_scope() -> void {
-        while (!entries_.empty() and entries_.back().level == level_) {
-            entries_.pop_back();
-        }
-        --level_;
-    }
-    auto insert(std::string id, std::shared_ptr<Decl> attr) -> void {
-        entries_.push_back(TableEntry{id, level_, attr});
-    }
-    auto retrieve_one_level(std::string const& id) -> std::optional<TableEntry>;
-    auto remove(TableEntry const& entry) -> void {
-        entries_.remove_if([&](const TableEntry& e) { return e.id == entry.id and e.level == entry.level; });
-    }
+    auto close_scope() -> void;
+    auto insert(Symbol id, Decl* attr) -> void;
+    auto retrieve_one_level(Symbol id) -> std::optional<TableEntry>;
+    auto remove(TableEntry const& entry) -> void;
 
     auto retrieve_latest_scope() -> std::vector<TableEntry>;
 
-    auto retrieve(std::string const& id) -> std::optional<TableEntry>;
+    auto retrieve(Symbol id) -> std::optional<TableEntry>;
 
  private:
-    std::list<TableEntry> entries_;
+    struct Slot {
+        TableEntry entry;
+        bool removed;
+    };
+
+    std::vector<Slot> slots_;
+    std::unordered_map<Symbol, std::vector<size_t>> bindings_;
     int level_ = 1;
 };
 
@@ -52,63 +52,65 @@ class Verifier
     : handler_(handler)
     , modules_(modules) {}
 
-    auto visit_para_decl(std::shared_ptr<ParaDecl> para_decl) -> void override;
-    auto visit_local_var_decl(std::shared_ptr<LocalVarDecl> local_var_decl) -> void override;
-    auto visit_global_var_decl(std::shared_ptr<GlobalVarDecl> global_var_decl) -> void override;
-    auto visit_enum_decl(std::shared_ptr<EnumDecl> enum_decl) -> void override;
-    auto visit_class_decl(std::shared_ptr<ClassDecl> class_decl) -> void override;
-    auto visit_class_field_decl(std::shared_ptr<ClassFieldDecl> class_field_decl) -> void override;
-    auto visit_function(std::shared_ptr<Function> function) -> void override;
-    auto visit_method_decl(std::shared_ptr<MethodDecl> method_decl) -> void override;
-    auto visit_constructor_decl(std::shared_ptr<ConstructorDecl> constructor_decl) -> void override;
-    auto visit_destructor_decl(std::shared_ptr<DestructorDecl> destructor_decl) -> void override;
-    auto visit_extern(std::shared_ptr<Extern> extern_) -> void override;
-    auto visit_empty_expr(std::shared_ptr<EmptyExpr> empty_expr) -> void override;
-    auto visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_expr) -> void override;
-    auto visit_binary_expr(std::shared_ptr<BinaryExpr> binary_expr) -> void override;
-    auto visit_unary_expr(std::shared_ptr<UnaryExpr> unary_expr) -> void override;
-    auto visit_decimal_expr(std::shared_ptr<DecimalExpr> decimal_expr) -> void override;
-    auto visit_null_expr(std::shared_ptr<NullExpr> null_expr) -> void override;
-    auto visit_int_expr(std::shared_ptr<IntExpr> int_expr) -> void override;
-    auto visit_uint_expr(std::shared_ptr<UIntExpr> uint_expr) -> void override;
-    auto visit_bool_expr(std::shared_ptr<BoolExpr> bool_expr) -> void override;
-    auto visit_string_expr(std::shared_ptr<StringExpr> string_expr) -> void override;
-    auto visit_char_expr(std::shared_ptr<CharExpr> char_expr) -> void override;
-    auto visit_var_expr(std::shared_ptr<VarExpr> var_expr) -> void override;
-    auto visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void override;
-    auto visit_constructor_call_expr(std::shared_ptr<ConstructorCallExpr> constructor_call_expr) -> void override;
-    auto visit_cast_expr(std::shared_ptr<CastExpr> cast_expr) -> void override;
-    auto visit_array_init_expr(std::shared_ptr<ArrayInitExpr> array_init_expr) -> void override;
-    auto visit_array_index_expr(std::shared_ptr<ArrayIndexExpr> array_index_expr) -> void override;
-    auto visit_enum_access_expr(std::shared_ptr<EnumAccessExpr> enum_access_expr) -> void override;
-    auto visit_field_access_expr(std::shared_ptr<FieldAccessExpr> field_access_expr) -> void override;
-    auto visit_method_access_expr(std::shared_ptr<MethodAccessExpr> method_access_expr) -> void override;
-    auto visit_size_of_expr(std::shared_ptr<SizeOfExpr> size_of_expr) -> void override;
-    auto visit_import_expr(std::shared_ptr<ImportExpr> import_expr) -> void override;
-    auto visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void override;
-
-    auto visit_empty_stmt(std::shared_ptr<EmptyStmt> empty_stmt) -> void override;
-    auto visit_compound_stmt(std::shared_ptr<CompoundStmt> compound_stmt) -> void override;
-    auto visit_local_var_stmt(std::shared_ptr<LocalVarStmt> local_var_stmt) -> void override;
-    auto visit_return_stmt(std::shared_ptr<ReturnStmt> return_stmt) -> void override;
-    auto visit_expr_stmt(std::shared_ptr<ExprStmt> expr_stmt) -> void override;
-    auto visit_while_stmt(std::shared_ptr<WhileStmt> while_stmt) -> void override;
-    auto visit_if_stmt(std::shared_ptr<IfStmt> if_stmt) -> void override;
-    auto visit_else_if_stmt(std::shared_ptr<ElseIfStmt> else_if_stmt) -> void override;
-    auto visit_loop_stmt(std::shared_ptr<LoopStmt> loop_stmt) -> void override;
-    auto visit_break_stmt(std::shared_ptr<BreakStmt> break_stmt) -> void override;
-    auto visit_continue_stmt(std::shared_ptr<ContinueStmt> continue_stmt) -> void override;
-    auto visit_delete_stmt(std::shared_ptr<DeleteStmt> delete_stmt) -> void override;
-
-    auto check(std::string const& filename, bool is_main, bool is_libc = false) -> void;
-
-    std::optional<std::shared_ptr<Type>> current_numerical_type = std::nullopt;
+    auto visit_para_decl(ParaDecl* para_decl) -> void override;
+    auto visit_local_var_decl(LocalVarDecl* local_var_decl) -> void override;
+    auto visit_global_var_decl(GlobalVarDecl* global_var_decl) -> void override;
+    auto visit_enum_decl(EnumDecl* enum_decl) -> void override;
+    auto visit_class_decl(ClassDecl* class_decl) -> void override;
+    auto visit_class_field_decl(ClassFieldDecl* class_field_decl) -> void override;
+    auto visit_function(Function* function) -> void override;
+    auto visit_method_decl(MethodDecl* method_decl) -> void override;
+    auto visit_constructor_decl(ConstructorDecl* constructor_decl) -> void override;
+    auto visit_destructor_decl(DestructorDecl* destructor_decl) -> void override;
+    auto visit_extern(Extern* extern_) -> void override;
+    auto visit_empty_expr(EmptyExpr* empty_expr) -> void override;
+    auto visit_assignment_expr(AssignmentExpr* assignment_expr) -> void override;
+    auto visit_binary_expr(BinaryExpr* binary_expr) -> void override;
+    auto visit_unary_expr(UnaryExpr* unary_expr) -> void override;
+    auto visit_decimal_expr(DecimalExpr* decimal_expr) -> void override;
+    auto visit_null_expr(NullExpr* null_expr) -> void override;
+    auto visit_int_expr(IntExpr* int_expr) -> void override;
+    auto visit_uint_expr(UIntExpr* uint_expr) -> void override;
+    auto visit_bool_expr(BoolExpr* bool_expr) -> void override;
+    auto visit_string_expr(StringExpr* string_expr) -> void override;
+    auto visit_char_expr(CharExpr* char_expr) -> void override;
+    auto visit_var_expr(VarExpr* var_expr) -> void override;
+    auto visit_call_expr(CallExpr* call_expr) -> void override;
+    auto visit_constructor_call_expr(ConstructorCallExpr* constructor_call_expr) -> void override;
+    auto visit_cast_expr(CastExpr* cast_expr) -> void override;
+    auto visit_array_init_expr(ArrayInitExpr* array_init_expr) -> void override;
+    auto visit_array_index_expr(ArrayIndexExpr* array_index_expr) -> void override;
+    auto visit_enum_access_expr(EnumAccessExpr* enum_access_expr) -> void override;
+    auto visit_field_access_expr(FieldAccessExpr* field_access_expr) -> void override;
+    auto visit_method_access_expr(MethodAccessExpr* method_access_expr) -> void override;
+    auto visit_size_of_expr(SizeOfExpr* size_of_expr) -> void override;
+    auto visit_import_expr(ImportExpr* import_expr) -> void override;
+    auto visit_new_expr(NewExpr* new_expr) -> void override;
+
+    auto visit_empty_stmt(EmptyStmt* empty_stmt) -> void override;
+    auto visit_compound_stmt(CompoundStmt* compound_stmt) -> void override;
+    auto visit_local_var_stmt(LocalVarStmt* local_var_stmt) -> void override;
+    auto visit_return_stmt(ReturnStmt* return_stmt) -> void override;
+    auto visit_expr_stmt(ExprStmt* expr_stmt) -> void override;
+    auto visit_while_stmt(WhileStmt* while_stmt) -> void override;
+    auto visit_if_stmt(IfStmt* if_stmt) -> void override;
+    auto visit_else_if_stmt(ElseIfStmt* else_if_stmt) -> void override;
+    auto visit_loop_stmt(LoopStmt* loop_stmt) -> void override;
+    auto visit_break_stmt(BreakStmt* break_stmt) -> void override;
+    auto visit_continue_stmt(ContinueStmt* continue_stmt) -> void override;
+    auto visit_delete_stmt(DeleteStmt* delete_stmt) -> void override;
+
+    // Verifies a module whose dependencies have all been verified already
+    auto check(std::shared_ptr<Module> module, bool is_main) -> void;
+    auto report_import_cycle(std::string const& filename, std::string const& cycle) -> void;
+
+    std::optional<Type*> current_numerical_type = std::nullopt;
     Position unmurk_pos;
-    std::shared_ptr<ClassDecl> curr_class = nullptr;
+    ClassDecl* curr_class = nullptr;
     std::shared_ptr<Module> curr_module_access_ = nullptr;
     std::string curr_module_alias_ = {};
 
-    std::shared_ptr<Expr> updated_expr_ = nullptr;
+    Expr* updated_expr_ = nullptr;
     bool in_constructor_ = false;
     bool in_destructor_ = false;
     bool visiting_lhs_of_assignment_ = false;
@@ -126,7 +128,7 @@ class Verifier
 
     std::string current_filename_;
     std::shared_ptr<Module> current_module_ = nullptr;
-    std::shared_ptr<Decl> current_function_or_method_ = nullptr;
+    Decl* current_function_or_method_ = nullptr;
 
     std::vector<std::string> const all_errors_ = {"0: main function is missing",
                                                   "1: duplicate function declaration: %",
@@ -217,22 +219,25 @@ class Verifier
                                                   "81: can only delete an expression of pointer or class type: %",
                                                   "82: allocation of type void or void[]",
                                                   "83: array size in allocation not of type i64: %",
-                                                  "84: cannot perform a new constructor call on a non class type: %"};
+                                                  "84: cannot perform a new constructor call on a non class type: %",
+                                                  "85: circular dependency between modules: %"};
 
     auto check_duplicate_function_declaration() -> void;
-    auto check_duplicate_method_declaration(std::shared_ptr<ClassDecl>& class_decl) -> void;
-    auto check_duplicate_constructor_declaration(std::shared_ptr<ClassDecl>& class_decl) -> void;
+    auto check_duplicate_method_declaration(ClassDecl*& class_decl) -> void;
+    auto check_duplicate_constructor_declaration(ClassDecl*& class_decl) -> void;
     auto check_duplicate_extern_declaration() -> void;
     auto check_duplicate_custom_type() -> void;
     auto check_duplicate_globals() -> void;
     auto check_unused_declarations() -> void;
     auto load_all_global_variables() -> void;
 
-    auto declare_variable(std::string ident, std::shared_ptr<Decl> decl) -> void;
+    auto declare_variable(Decl* decl) -> void;
+    // Gives a parameter or local variable the next slot of the function, method, constructor or destructor it's in
+    auto assign_slot(Decl* decl) -> void;
 
-    auto unmurk_decl(std::shared_ptr<Decl> decl) -> void;
-    auto unmurk(std::shared_ptr<Type> murky_t) -> std::shared_ptr<Type>;
-    auto unmurk_direct(std::shared_ptr<MurkyType> murky_t) -> std::shared_ptr<Type>;
+    auto unmurk_decl(Decl* decl) -> void;
+    auto unmurk(Type* murky_t) -> Type*;
+    auto unmurk_direct(MurkyType* murky_t) -> Type*;
 };
 
 #endif // VERIFIER_HPP
\ No newline at end of file
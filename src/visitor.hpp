@@ -52,53 +52,53 @@ class Extern;
 
 class Visitor {
  public:
-    virtual auto visit_para_decl(std::shared_ptr<ParaDecl> para_decl) -> void = 0;
-    virtual auto visit_local_var_decl(std::shared_ptr<LocalVarDecl> local_var_decl) -> void = 0;
-    virtual auto visit_global_var_decl(std::shared_ptr<GlobalVarDecl> global_var_decl) -> void = 0;
-    virtual auto visit_enum_decl(std::shared_ptr<EnumDecl> enum_decl) -> void = 0;
-    virtual auto visit_class_decl(std::shared_ptr<ClassDecl> class_decl) -> void = 0;
-    virtual auto visit_class_field_decl(std::shared_ptr<ClassFieldDecl> class_field_decl) -> void = 0;
-    virtual auto visit_function(std::shared_ptr<Function> function) -> void = 0;
-    virtual auto visit_method_decl(std::shared_ptr<MethodDecl> method_decl) -> void = 0;
-    virtual auto visit_constructor_decl(std::shared_ptr<ConstructorDecl> constructor_decl) -> void = 0;
-    virtual auto visit_destructor_decl(std::shared_ptr<DestructorDecl> destructor_decl) -> void = 0;
-    virtual auto visit_extern(std::shared_ptr<Extern> extern_) -> void = 0;
-    virtual auto visit_empty_expr(std::shared_ptr<EmptyExpr> empty_expr) -> void = 0;
-    virtual auto visit_assignment_expr(std::shared_ptr<AssignmentExpr> assignment_expr) -> void = 0;
-    virtual auto visit_binary_expr(std::shared_ptr<BinaryExpr> binary_expr) -> void = 0;
-    virtual auto visit_unary_expr(std::shared_ptr<UnaryExpr> unary_expr) -> void = 0;
-    virtual auto visit_decimal_expr(std::shared_ptr<DecimalExpr> decimal_expr) -> void = 0;
-    virtual auto visit_null_expr(std::shared_ptr<NullExpr> null_expr) -> void = 0;
-    virtual auto visit_int_expr(std::shared_ptr<IntExpr> int_expr) -> void = 0;
-    virtual auto visit_uint_expr(std::shared_ptr<UIntExpr> uint_expr) -> void = 0;
-    virtual auto visit_bool_expr(std::shared_ptr<BoolExpr> bool_expr) -> void = 0;
-    virtual auto visit_string_expr(std::shared_ptr<StringExpr> string_expr) -> void = 0;
-    virtual auto visit_char_expr(std::shared_ptr<CharExpr> char_expr) -> void = 0;
-    virtual auto visit_var_expr(std::shared_ptr<VarExpr> var_expr) -> void = 0;
-    virtual auto visit_call_expr(std::shared_ptr<CallExpr> call_expr) -> void = 0;
-    virtual auto visit_constructor_call_expr(std::shared_ptr<ConstructorCallExpr> constructor_call_expr) -> void = 0;
-    virtual auto visit_cast_expr(std::shared_ptr<CastExpr> cast_expr) -> void = 0;
-    virtual auto visit_array_init_expr(std::shared_ptr<ArrayInitExpr> array_init_expr) -> void = 0;
-    virtual auto visit_array_index_expr(std::shared_ptr<ArrayIndexExpr> array_index_expr) -> void = 0;
-    virtual auto visit_enum_access_expr(std::shared_ptr<EnumAccessExpr> enum_access_expr) -> void = 0;
-    virtual auto visit_field_access_expr(std::shared_ptr<FieldAccessExpr> field_access_expr) -> void = 0;
-    virtual auto visit_method_access_expr(std::shared_ptr<MethodAccessExpr> method_access_expr) -> void = 0;
-    virtual auto visit_size_of_expr(std::shared_ptr<SizeOfExpr> size_of_expr) -> void = 0;
-    virtual auto visit_import_expr(std::shared_ptr<ImportExpr> import_expr) -> void = 0;
-    virtual auto visit_new_expr(std::shared_ptr<NewExpr> new_expr) -> void = 0;
+    virtual auto visit_para_decl(ParaDecl* para_decl) -> void = 0;
+    virtual auto visit_local_var_decl(LocalVarDecl* local_var_decl) -> void = 0;
+    virtual auto visit_global_var_decl(GlobalVarDecl* global_var_decl) -> void = 0;
+    virtual auto visit_enum_decl(EnumDecl* enum_decl) -> void = 0;
+    virtual auto visit_class_decl(ClassDecl* class_decl) -> void = 0;
+    virtual auto visit_class_field_decl(ClassFieldDecl* class_field_decl) -> void = 0;
+    virtual auto visit_function(Function* function) -> void = 0;
+    virtual auto visit_method_decl(MethodDecl* method_decl) -> void = 0;
+    virtual auto visit_constructor_decl(ConstructorDecl* constructor_decl) -> void = 0;
+    virtual auto visit_destructor_decl(DestructorDecl* destructor_decl) -> void = 0;
+    virtual auto visit_extern(Extern* extern_) -> void = 0;
+    virtual auto visit_empty_expr(EmptyExpr* empty_expr) -> void = 0;
+    virtual auto visit_assignment_expr(AssignmentExpr* assignment_expr) -> void = 0;
+    virtual auto visit_binary_expr(BinaryExpr* binary_expr) -> void = 0;
+    virtual auto visit_unary_expr(UnaryExpr* unary_expr) -> void = 0;
+    virtual auto visit_decimal_expr(DecimalExpr* decimal_expr) -> void = 0;
+    virtual auto visit_null_expr(NullExpr* null_expr) -> void = 0;
+    virtual auto visit_int_expr(IntExpr* int_expr) -> void = 0;
+    virtual auto visit_uint_expr(UIntExpr* uint_expr) -> void = 0;
+    virtual auto visit_bool_expr(BoolExpr* bool_expr) -> void = 0;
+    virtual auto visit_string_expr(StringExpr* string_expr) -> void = 0;
+    virtual auto visit_char_expr(CharExpr* char_expr) -> void = 0;
+    virtual auto visit_var_expr(VarExpr* var_expr) -> void = 0;
+    virtual auto visit_call_expr(CallExpr* call_expr) -> void = 0;
+    virtual auto visit_constructor_call_expr(ConstructorCallExpr* constructor_call_expr) -> void = 0;
+    virtual auto visit_cast_expr(CastExpr* cast_expr) -> void = 0;
+    virtual auto visit_array_init_expr(ArrayInitExpr* array_init_expr) -> void = 0;
+    virtual auto visit_array_index_expr(ArrayIndexExpr* array_index_expr) -> void = 0;
+    virtual auto visit_enum_access_expr(EnumAccessExpr* enum_access_expr) -> void = 0;
+    virtual auto visit_field_access_expr(FieldAccessExpr* field_access_expr) -> void = 0;
+    virtual auto visit_method_access_expr(MethodAccessExpr* method_access_expr) -> void = 0;
+    virtual auto visit_size_of_expr(SizeOfExpr* size_of_expr) -> void = 0;
+    virtual auto visit_import_expr(ImportExpr* import_expr) -> void = 0;
+    virtual auto visit_new_expr(NewExpr* new_expr) -> void = 0;
 
-    virtual auto visit_empty_stmt(std::shared_ptr<EmptyStmt> empty_stmt) -> void = 0;
-    virtual auto visit_compound_stmt(std::shared_ptr<CompoundStmt> compound_stmt) -> void = 0;
-    virtual auto visit_local_var_stmt(std::shared_ptr<LocalVarStmt> local_var_stmt) -> void = 0;
-    virtual auto visit_return_stmt(std::shared_ptr<ReturnStmt> return_stmt) -> void = 0;
-    virtual auto visit_expr_stmt(std::shared_ptr<ExprStmt> expr_stmt) -> void = 0;
-    virtual auto visit_while_stmt(std::shared_ptr<WhileStmt> while_stmt) -> void = 0;
-    virtual auto visit_if_stmt(std::shared_ptr<IfStmt> if_stmt) -> void = 0;
-    virtual auto visit_else_if_stmt(std::shared_ptr<ElseIfStmt> else_if_stmt) -> void = 0;
-    virtual auto visit_loop_stmt(std::shared_ptr<LoopStmt> loop_stmt) -> void = 0;
-    virtual auto visit_break_stmt(std::shared_ptr<BreakStmt> break_stmt) -> void = 0;
-    virtual auto visit_continue_stmt(std::shared_ptr<ContinueStmt> continue_stmt) -> void = 0;
-    virtual auto visit_delete_stmt(std::shared_ptr<DeleteStmt> delete_stmt) -> void = 0;
+    virtual auto visit_empty_stmt(EmptyStmt* empty_stmt) -> void = 0;
+    virtual auto visit_compound_stmt(CompoundStmt* compound_stmt) -> void = 0;
+    virtual auto visit_local_var_stmt(LocalVarStmt* local_var_stmt) -> void = 0;
+    virtual auto visit_return_stmt(ReturnStmt* return_stmt) -> void = 0;
+    virtual auto visit_expr_stmt(ExprStmt* expr_stmt) -> void = 0;
+    virtual auto visit_while_stmt(WhileStmt* while_stmt) -> void = 0;
+    virtual auto visit_if_stmt(IfStmt* if_stmt) -> void = 0;
+    virtual auto visit_else_if_stmt(ElseIfStmt* else_if_stmt) -> void = 0;
+    virtual auto visit_loop_stmt(LoopStmt* loop_stmt) -> void = 0;
+    virtual auto visit_break_stmt(BreakStmt* break_stmt) -> void = 0;
+    virtual auto visit_continue_stmt(ContinueStmt* continue_stmt) -> void = 0;
+    virtual auto visit_delete_stmt(DeleteStmt* delete_stmt) -> void = 0;
 };
 
 #endif // VISITOR_HPP
\ No newline at end of file
@@ -36,6 +36,53 @@ then
     fi
 fi
 
+# Compares the output just written to $TEMP against the test's .txt file
+check_output() {
+  local file="$1"
+  local message
+  message=$(head -n1 "$file")
+  real_file=$(echo "$file" | sed -E 's/xpp$/txt/g')
+
+  output=$(diff -q "$TEMP" "$real_file")
+  if [ -n "$output" ]
+  then
+    echo -e "    '$(basename "$file")' ${RED}FAILED${RESET} ${message}"
+    FAIL=$((FAIL+1))
+  else
+    echo -e "    '$(basename "$file")' ${GREEN}PASSED${RESET} ${message}"
+    PASS=$((PASS+1))
+  fi
+}
+
+# Builds every running test with the given flags and checks its output, running it in-process when they include -r
+run_running_tests() {
+  while IFS= read -r file
+  do
+
+    if echo "$file" | grep -vE "_[0-9]+\.xpp" >> /dev/null 2>&1
+    then
+      continue
+    fi
+
+    input="/dev/null"
+    if [ -f "${file%.xpp}.inp" ]
+    then
+      input="${file%.xpp}.inp"
+    fi
+
+    : > "$TEMP"
+    if [[ " $* " == *" -r "* ]]
+    then
+      "$EXE" -q "$@" "$file" < "$input" > "$TEMP"
+    else
+      rm -f a.out
+      "$EXE" -q "$@" "$file" && ./a.out < "$input" > "$TEMP"
+    fi
+    check_output "$file"
+
+  done < <(find "tests/running" -type f)
+}
+
 # Building
 cd build; make -j8; cd ..
 
@@ -109,6 +156,53 @@ do
 
 done < <(find "tests/running" -type f)
 
+# Every test in-process, including those reading input, and whether or not the IR it gets verifies
+echo -e "${YELLOW}JIT TESTS (-r): ${RESET}"
+run_running_tests -r
+
+echo -e "${YELLOW}TARGET TESTS (--target-cpu, --target-features): ${RESET}"
+run_running_tests --target-cpu=native
+
+# A CPU or feature the target doesn't have is an error rather than quietly ignored
+for flag in "--target-features=+not-a-feature" "--target-features=avx2" "--target-cpu=not-a-cpu"
+do
+  rm -f a.out
+  if "$EXE" -q "$flag" tests/running/test_01.xpp 2> /dev/null || [ -f a.out ]
+  then
+    echo -e "    '${flag}' ${RED}FAILED${RESET} // should be rejected"
+    FAIL=$((FAIL+1))
+  else
+    echo -e "    '${flag}' ${GREEN}PASSED${RESET} // should be rejected"
+    PASS=$((PASS+1))
+  fi
+done
+
+echo -e "${YELLOW}OPTIMISED TESTS (-O2): ${RESET}"
+run_running_tests -O2
+
+# Split into partitions that are compiled concurrently, or whole when the IR doesn't verify
+echo -e "${YELLOW}PARTITIONED CODEGEN TESTS (--codegen-threads=4): ${RESET}"
+run_running_tests --codegen-threads=4
+
+echo -e "${YELLOW}PARALLEL MODULE TESTS (-j 4): ${RESET}"
+run_running_tests -j 4 -r
+
+echo -e "${YELLOW}LINKER TESTS (--linker=cc): ${RESET}"
+run_running_tests --linker=cc
+
+# Both reports are written alongside the program's own output
+echo -e "${YELLOW}PROFILE TESTS (--stat-json, --time-trace): ${RESET}"
+file="tests/running/test_38.xpp"
+stats_json="${TEMP}.stats.json"
+time_trace="${TEMP}.trace.json"
+"$EXE" -q -r --stat-json="$stats_json" --time-trace="$time_trace" "$file" > "$TEMP"
+if ! grep -q '"phases"' "$stats_json" 2>/dev/null || ! grep -q '"traceEvents"' "$time_trace" 2>/dev/null
+then
+  echo "no profile written" >> "$TEMP"
+fi
+rm -f "$stats_json" "$time_trace"
+check_output "$file"
+
 echo -e "${YELLOW}RUNNING LIB TESTS: ${RESET}"
 while IFS= read -r file
 do
@@ -148,6 +242,70 @@ do
 
 done < <(find "tests/libs" -type f)
 
+# Every library is precompiled into the build tree, then each lib test has to read them from their interfaces
+echo -e "${YELLOW}PRECOMPILED LIBRARY TESTS: ${RESET}"
+precompiled=1
+for library in lib/*.xpp
+do
+  name=$(basename "$library" .xpp)
+  if ! "$EXE" -q --precompile "$library" || [ ! -f "build/lib/$name.bc" ] || [ ! -f "build/lib/$name.xppi" ]
+  then
+    precompiled=0
+  fi
+done
+
+while IFS= read -r file
+do
+  : > "$TEMP"
+  if [ "$precompiled" = 1 ]
+  then
+    interfaces=$("$EXE" -q -s -r "$file" 2>&1 < /dev/null > "$TEMP" | grep -E "^ +module interfaces +[1-9]")
+    if [ -z "$interfaces" ]
+    then
+      echo "not read from its interface" >> "$TEMP"
+    fi
+  fi
+  check_output "$file"
+done < <(find "tests/libs" -name "test_*.xpp" | sort)
+
+# Built twice into a cache of their own, the second build has to take every module's object from the cache and leave
+# the executable alone, and run twice in-process, the second run has to compile nothing new. Programs whose names clash
+# or whose IR doesn't verify are generated whole instead, so only their output is checked
+CACHE_HOME=$(mktemp -d)
+echo -e "${YELLOW}CACHE TESTS (--build-cache, --jit-cache): ${RESET}"
+while IFS= read -r file
+do
+  input="/dev/null"
+  if [ -f "${file%.xpp}.inp" ]
+  then
+    input="${file%.xpp}.inp"
+  fi
+
+  rm -f a.out
+  first=$(XDG_CACHE_HOME="$CACHE_HOME" "$EXE" -q -s --build-cache "$file" 2>&1 > /dev/null)
+  linked=$(stat -c %y a.out 2>&1)
+  stats=$(XDG_CACHE_HOME="$CACHE_HOME" "$EXE" -q -s --build-cache "$file" 2>&1 > /dev/null)
+  ./a.out < "$input" > "$TEMP"
+  cached=$(echo "$stats" | grep -E "^ +cached objects " | grep -Eo "[0-9]+$")
+  modules=$(echo "$stats" | grep -E "^ +modules " | grep -Eo "[0-9]+$")
+  if echo "$first" | grep -qE "^ +cached objects " \
+    && { [ "$cached" != "$modules" ] || [ "$linked" != "$(stat -c %y a.out 2>&1)" ]; }
+  then
+    echo "rebuilt" >> "$TEMP"
+  fi
+  check_output "$file"
+
+  XDG_CACHE_HOME="$CACHE_HOME" "$EXE" -q -r --jit-cache "$file" < "$input" > /dev/null
+  objects=$(find "$CACHE_HOME/xpp/jit" -type f | wc -l)
+  XDG_CACHE_HOME="$CACHE_HOME" "$EXE" -q -r --jit-cache "$file" < "$input" > "$TEMP"
+  if [ "$objects" = 0 ] || [ "$objects" != "$(find "$CACHE_HOME/xpp/jit" -type f | wc -l)" ]
+  then
+    echo "recompiled" >> "$TEMP"
+  fi
+  check_output "$file"
+done < <(find "tests/running" "tests/libs" -name "test_*.xpp" | sort)
+rm -rf "$CACHE_HOME"
+
 echo -e "${YELLOW}FAILING TESTS: ${RESET}"
 while IFS= read -r file
 do